@@ -0,0 +1,387 @@
+/**
+  ******************************************************************************
+    * @file    host/bench/can_dispatch_bench
+    * @date    16-October-2026
+    * @brief   Host benchmark of the CAN receive dispatch. Feeds a synthetic frame
+    *          stream through CAN1/CAN2_RX0_IRQHandler (registration table lookup)
+    *          and through a copy of the old switch based CAN_hook, and reports
+    *          the cost per frame of each. Unregistered IDs in the stream are
+    *          dropped by the modelled filter banks before either path sees them.
+    *          Also counts the interrupt entries needed to empty a FIFO that filled
+    *          while the receive interrupt was held off.
+    * @attention Both paths take the same interrupt body (drain loop, bus stats),
+    *          fill motors the same way and serve the same non motor IDs, so the
+    *          difference between them is the dispatch itself: the switch against
+    *          the table lookup and the call through its handler pointer. The run
+    *          fails if the two paths did not see the same frames.
+    *          Usage: can_dispatch_bench [frames]
+  ******************************************************************************
+**/
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hal_host.h"
+#include "CAN_receive.h"
+
+#define BENCH_STREAM_LEN 4096
+#define BENCH_DEFAULT_FRAMES 10000000u
+//Timed runs per path, alternating, the fastest of each is reported
+#define BENCH_ROUNDS 5
+
+//Firmware interrupt handlers, normally reached through the vector table
+extern void CAN1_RX0_IRQHandler(void);
+extern void CAN1_RX1_IRQHandler(void);
+extern void CAN2_RX0_IRQHandler(void);
+extern void CAN2_RX1_IRQHandler(void);
+
+typedef struct
+{
+    hal_can_e can;
+    hal_can_frame_t frame;
+} bench_frame_t;
+
+static bench_frame_t stream[BENCH_STREAM_LEN];
+static void (*const rx_irq[HAL_CAN_NUM][HAL_CAN_FIFO_NUM])(void) = {
+    {CAN1_RX0_IRQHandler, CAN1_RX1_IRQHandler},
+    {CAN2_RX0_IRQHandler, CAN2_RX1_IRQHandler},
+};
+static uint32_t extra_rx_count;
+
+
+//Stand-in for a non motor device such as a supercap controller
+static void extra_handler(const hal_can_frame_t *rx_message, void *dest)
+{
+    (void)rx_message;
+    (*(uint32_t *)dest)++;
+}
+
+/******************** Old dispatch, kept for comparison ********************/
+
+//Same per frame work as CAN_receive.c (seqlock, timestamp, turn unwrapping, speed filter,
+//receive statistics), so the two paths only differ in how the frame finds its motor
+#define legacy_fill_motor_readings(ptr, rx_message)                                              \
+    {                                                                                          \
+        legacy_rx_stats((rx_message)->std_id);                                                 \
+        uint16_t ecd = (uint16_t)((rx_message)->data[0] << 8 | (rx_message)->data[1]);         \
+        int16_t speed_rpm = (int16_t)((rx_message)->data[2] << 8 | (rx_message)->data[3]);     \
+        uint32_t now = hal_cycle_count();                                                      \
+        (ptr)->seq++;                                                                          \
+        hal_memory_barrier();                                                                  \
+        if ((ptr)->seq == 1)                                                                   \
+        {                                                                                      \
+            (ptr)->total_ecd = ecd;                                                            \
+            (ptr)->speed_filter_state = speed_rpm * MOTOR_SPEED_FILTER_SCALE;                  \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+            uint32_t gap_us = (now - (ptr)->rx_time) / HAL_CYCLES_PER_US;                      \
+            gap_us = gap_us > MOTOR_UNWRAP_MAX_GAP_US ? MOTOR_UNWRAP_MAX_GAP_US : gap_us;      \
+            int32_t predicted = (((ptr)->speed_rpm + speed_rpm) / 2) * (int32_t)gap_us         \
+                                / MOTOR_RPM_US_PER_ECD;                                        \
+            int32_t error = (int32_t)((uint16_t)(ecd - (ptr)->ecd - predicted + MOTOR_ECD_RANGE / 2) \
+                                      & (MOTOR_ECD_RANGE - 1)) - MOTOR_ECD_RANGE / 2;           \
+            (ptr)->total_ecd = (int32_t)((uint32_t)(ptr)->total_ecd + (uint32_t)(predicted + error)); \
+            (ptr)->speed_filter_state += (speed_rpm * MOTOR_SPEED_FILTER_SCALE                 \
+                                          - (ptr)->speed_filter_state) / MOTOR_SPEED_FILTER_GAIN; \
+        }                                                                                      \
+        (ptr)->speed_filtered_rpm = (int16_t)((ptr)->speed_filter_state / MOTOR_SPEED_FILTER_SCALE); \
+        (ptr)->last_ecd = (ptr)->ecd;                                                          \
+        (ptr)->ecd = ecd;                                                                      \
+        (ptr)->speed_rpm = speed_rpm;                                                          \
+        (ptr)->current_read = (int16_t)((rx_message)->data[4] << 8 | (rx_message)->data[5]);  \
+        (ptr)->temperate = (rx_message)->data[6];                                              \
+        (ptr)->rx_time = now;                                                                  \
+        hal_memory_barrier();                                                                  \
+        (ptr)->seq++;                                                                          \
+    }
+
+static motor_feedback_t legacy_yaw, legacy_pit, legacy_trigger, legacy_hopper, legacy_chassis[4];
+static motor_rx_stats_t legacy_stats[CAN_MOTOR_NUM];
+static uint32_t legacy_last_rx_time[CAN_MOTOR_NUM];
+static can_rx_bus_stats_t legacy_bus_stats[HAL_CAN_NUM];
+static uint32_t legacy_unknown_id_count[HAL_CAN_NUM];
+static uint32_t legacy_last_unknown_id[HAL_CAN_NUM];
+static uint32_t legacy_extra_rx_count;
+
+static void legacy_rx_stats(uint32_t std_id)
+{
+    uint32_t index = std_id - CAN_3508_M1_ID;
+    motor_rx_stats_t *stats = &legacy_stats[index];
+    uint32_t now = hal_cycle_count();
+
+    if (stats->rx_count > 0)
+    {
+        uint32_t gap = now - legacy_last_rx_time[index];
+        if (stats->rx_count == 1)
+        {
+            stats->avg_gap_cycles = gap;
+        }
+        else
+        {
+            stats->avg_gap_cycles += ((int32_t)(gap - stats->avg_gap_cycles)) / 16;
+        }
+        if (gap > stats->max_gap_cycles)
+        {
+            stats->max_gap_cycles = gap;
+        }
+    }
+    legacy_last_rx_time[index] = now;
+    stats->rx_count++;
+}
+
+//The switch with a case added by hand for every non motor ID, as new devices were added before
+static void legacy_CAN_hook(hal_can_e can, hal_can_frame_t *rx_message)
+{
+    switch (rx_message->std_id)
+    {
+    case CAN_YAW_MOTOR_ID:
+        legacy_fill_motor_readings(&legacy_yaw, rx_message);
+        break;
+    case CAN_PIT_MOTOR_ID:
+        legacy_fill_motor_readings(&legacy_pit, rx_message);
+        break;
+    case CAN_TRIGGER_MOTOR_ID:
+        legacy_fill_motor_readings(&legacy_trigger, rx_message);
+        break;
+    case CAN_HOPPER_MOTOR_ID:
+        legacy_fill_motor_readings(&legacy_hopper, rx_message);
+        break;
+    case CAN_3508_M1_ID:
+    case CAN_3508_M2_ID:
+    case CAN_3508_M3_ID:
+    case CAN_3508_M4_ID:
+    {
+        static uint8_t i = 0;
+        i = rx_message->std_id - CAN_3508_M1_ID;
+        legacy_fill_motor_readings(&legacy_chassis[i], rx_message);
+        break;
+    }
+    case 0x211:
+    case 0x301:
+    case 0x302:
+        extra_handler(rx_message, &legacy_extra_rx_count);
+        break;
+    default:
+        legacy_unknown_id_count[can]++;
+        legacy_last_unknown_id[can] = rx_message->std_id;
+        break;
+    }
+}
+
+//Copy of CAN_rx_irq around the switch: same drain loop, overrun check and self timing
+static void legacy_rx_irq(hal_can_e can, hal_can_fifo_e fifo)
+{
+    hal_can_frame_t rx_message;
+    can_rx_bus_stats_t *stats = &legacy_bus_stats[can];
+    uint32_t start = hal_cycle_count();
+
+    stats->irq_count++;
+    if (hal_can_fifo_overrun(can, fifo))
+    {
+        stats->overrun_count[fifo]++;
+    }
+    while (hal_can_receive(can, fifo, &rx_message))
+    {
+        stats->frame_count++;
+        legacy_CAN_hook(can, &rx_message);
+    }
+
+    uint32_t elapsed = hal_cycle_count() - start;
+    if (elapsed > stats->max_irq_cycles)
+    {
+        stats->max_irq_cycles = elapsed;
+    }
+}
+
+
+/******************** Stream ********************/
+
+/**
+ * @brief  Builds a repeatable mix of frames: mostly motor feedback in bus order, with a
+ *         few registered non motor IDs (hash path) and unregistered IDs (dropped by the
+ *         filter banks, so they only cost the HAL push)
+ * @param  None
+ * @retval None
+ */
+static void build_stream(void)
+{
+    static const uint32_t extra_ids[] = {0x211, 0x301, 0x302};
+    static const uint32_t unknown_ids[] = {0x100, 0x209, 0x3FF};
+    uint32_t lcg = 12345;
+
+    for (uint32_t i = 0; i < BENCH_STREAM_LEN; i++)
+    {
+        bench_frame_t *f = &stream[i];
+        lcg = lcg * 1664525u + 1013904223u;
+        uint32_t pick = lcg >> 24;
+
+        if (pick < 224)
+        {
+            f->frame.std_id = CAN_3508_M1_ID + (i & 0x07);
+        }
+        else if (pick < 248)
+        {
+            f->frame.std_id = extra_ids[pick % 3];
+        }
+        else
+        {
+            f->frame.std_id = unknown_ids[pick % 3];
+        }
+        f->can = f->frame.std_id <= CAN_3508_M4_ID && f->frame.std_id >= CAN_3508_M1_ID ? CHASSIS_CAN : GIMBAL_CAN;
+        f->frame.dlc = 8;
+        for (uint8_t b = 0; b < 8; b++)
+        {
+            f->frame.data[b] = (uint8_t)(lcg >> (b * 3));
+        }
+    }
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static fp64 run_table(uint32_t frames)
+{
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        const bench_frame_t *f = &stream[i & (BENCH_STREAM_LEN - 1)];
+        int8_t fifo = hal_host_can_push_rx(f->can, &f->frame);
+        if (fifo >= 0)
+        {
+            rx_irq[f->can][fifo]();
+        }
+    }
+    return (fp64)(now_ns() - start) / frames;
+}
+
+static fp64 run_legacy(uint32_t frames)
+{
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        const bench_frame_t *f = &stream[i & (BENCH_STREAM_LEN - 1)];
+        int8_t fifo = hal_host_can_push_rx(f->can, &f->frame);
+        if (fifo >= 0)
+        {
+            legacy_rx_irq(f->can, (hal_can_fifo_e)fifo);
+        }
+    }
+    return (fp64)(now_ns() - start) / frames;
+}
+
+/**
+ * @brief  Interrupt held off while burst chassis frames arrive, then serviced. Counts the
+ *         interrupt entries needed to empty FIFO0 by reading one frame per entry (old
+ *         handler) and by draining (new handler)
+ * @param  burst: frames that arrive while the interrupt is held off
+ * @param  single_entries: entries taken by the one frame per entry handler
+ * @param  drain_entries: entries taken by the draining handler
+ * @retval None
+ */
+static void run_burst(uint8_t burst, uint32_t *single_entries, uint32_t *drain_entries)
+{
+    hal_can_frame_t rx_message;
+    can_rx_bus_stats_t before, after;
+
+    *single_entries = 0;
+    for (uint8_t i = 0; i < burst; i++)
+    {
+        hal_host_can_push_rx(CHASSIS_CAN, &stream[i & 0x03].frame);
+    }
+    //The FMP interrupt stays pending while frames are left, so it is re-entered per frame
+    while (hal_host_can_rx_pending(CHASSIS_CAN, HAL_CAN_FIFO0))
+    {
+        hal_can_receive(CHASSIS_CAN, HAL_CAN_FIFO0, &rx_message);
+        legacy_CAN_hook(CHASSIS_CAN, &rx_message);
+        (*single_entries)++;
+    }
+
+    get_CAN_rx_bus_stats(CHASSIS_CAN, &before);
+    for (uint8_t i = 0; i < burst; i++)
+    {
+        hal_host_can_push_rx(CHASSIS_CAN, &stream[i & 0x03].frame);
+    }
+    while (hal_host_can_rx_pending(CHASSIS_CAN, HAL_CAN_FIFO0))
+    {
+        CAN2_RX0_IRQHandler();
+    }
+    get_CAN_rx_bus_stats(CHASSIS_CAN, &after);
+    *drain_entries = after.irq_count - before.irq_count;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_FRAMES;
+
+    hal_host_reset();
+    CAN_receive_init();
+    CAN_register_rx_handler(GIMBAL_CAN, 0x211, CAN_RX_PRIORITY_LOW, extra_handler, &extra_rx_count);
+    CAN_register_rx_handler(GIMBAL_CAN, 0x301, CAN_RX_PRIORITY_LOW, extra_handler, &extra_rx_count);
+    CAN_register_rx_handler(GIMBAL_CAN, 0x302, CAN_RX_PRIORITY_LOW, extra_handler, &extra_rx_count);
+    CAN_update_filters();
+    build_stream();
+
+    //Warm up both paths once before timing
+    run_legacy(BENCH_STREAM_LEN);
+    run_table(BENCH_STREAM_LEN);
+
+    fp64 legacy_ns = 0.0, table_ns = 0.0;
+    for (uint8_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        fp64 ns = run_legacy(frames / BENCH_ROUNDS);
+        legacy_ns = round == 0 || ns < legacy_ns ? ns : legacy_ns;
+        ns = run_table(frames / BENCH_ROUNDS);
+        table_ns = round == 0 || ns < table_ns ? ns : table_ns;
+    }
+
+    //Both paths ran the warm up and the timed run over the same stream
+    int failed = extra_rx_count != legacy_extra_rx_count;
+    for (can_msg_id_e id = CAN_3508_M1_ID; id <= CAN_HOPPER_MOTOR_ID; id++)
+    {
+        motor_rx_stats_t stats;
+        get_motor_rx_stats(id, &stats);
+        failed |= stats.rx_count != legacy_stats[id - CAN_3508_M1_ID].rx_count;
+    }
+    for (hal_can_e can = HAL_CAN1; can < HAL_CAN_NUM; can++)
+    {
+        can_rx_bus_stats_t stats;
+        get_CAN_rx_bus_stats(can, &stats);
+        failed |= stats.frame_count != legacy_bus_stats[can].frame_count;
+        failed |= get_CAN_unknown_id_count(can) != legacy_unknown_id_count[can];
+    }
+
+    printf("frames            %u per path, fastest of %u rounds\n", frames / BENCH_ROUNDS * BENCH_ROUNDS, BENCH_ROUNDS);
+    printf("switch dispatch   %.2f ns/frame\n", legacy_ns);
+    printf("table dispatch    %.2f ns/frame, %+.1f%% against the switch\n", table_ns,
+           (table_ns / legacy_ns - 1.0) * 100.0);
+    printf("extra IDs handled %u, unknown IDs reaching the handler %u, dropped by filters %u\n",
+           extra_rx_count, get_CAN_unknown_id_count(GIMBAL_CAN) + get_CAN_unknown_id_count(CHASSIS_CAN),
+           hal_host_can_filtered_count(GIMBAL_CAN) + hal_host_can_filtered_count(CHASSIS_CAN));
+    if (failed)
+    {
+        printf("FAIL: the two paths handled different frames\n");
+        return EXIT_FAILURE;
+    }
+
+    //build_stream puts chassis frames at indices 0 ~ 3 only by chance, use fixed ones
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        stream[i].can = CHASSIS_CAN;
+        stream[i].frame.std_id = CAN_3508_M1_ID + i;
+    }
+    printf("\nheld off frames   single read entries   drain entries\n");
+    for (uint8_t burst = 1; burst <= HAL_HOST_CAN_RX_FIFO_LEN; burst++)
+    {
+        uint32_t single_entries, drain_entries;
+        run_burst(burst, &single_entries, &drain_entries);
+        printf("%15u %21u %15u\n", burst, single_entries, drain_entries);
+    }
+    return 0;
+}
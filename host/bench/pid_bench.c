@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+    * @file    host/bench/pid_bench
+    * @date    16-October-2026
+    * @brief   Host benchmark of one update of N controllers with the same gains:
+    *          N PID_Calc calls on separate PidTypeDef structs, the way the chassis
+    *          used to run its wheels, against one PID_bank_calc over a bank.
+    *          Runs for 4 (the chassis) and 8 controllers, and checks that both
+    *          give the same outputs.
+    * @attention Host numbers only rank the two. On the robot, time the chassis
+    *          loop with the profiler (PROFILER_LOOP_CHASSIS) or read the DWT
+    *          cycle counter around the call.
+    *          Usage: pid_bench [iterations]
+  ******************************************************************************
+**/
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pid.h"
+
+#define BENCH_DEFAULT_ITERATIONS 10000000u
+//Inputs cycle through this many samples so neither path sees constants
+#define BENCH_INPUT_LEN 64
+
+static const fp32 bench_gains[3] = {0.5f, 0.01f, 0.1f};
+static fp32 bench_ref[BENCH_INPUT_LEN][PID_BANK_MAX];
+static fp32 bench_set[BENCH_INPUT_LEN][PID_BANK_MAX];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief  Times both paths for one bank size
+ * @param  num: controllers per update
+ * @param  iterations: updates timed per path
+ * @retval 1 if the outputs matched
+ */
+static int bench_run(uint8_t num, uint32_t iterations)
+{
+    PidTypeDef pid[PID_BANK_MAX];
+    PidBankTypeDef bank;
+    //volatile so neither loop is folded away
+    volatile fp32 sink = 0.0f;
+
+    for (uint8_t i = 0; i < num; i++)
+    {
+        PID_Init(&pid[i], PID_POSITION, bench_gains, 10000.0f, 500.0f);
+    }
+    PID_bank_init(&bank, num, bench_gains, 10000.0f, 500.0f);
+
+    uint64_t start = now_ns();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        const fp32 *ref = bench_ref[n % BENCH_INPUT_LEN];
+        const fp32 *set = bench_set[n % BENCH_INPUT_LEN];
+        for (uint8_t i = 0; i < num; i++)
+        {
+            sink = PID_Calc(&pid[i], ref[i], set[i]);
+        }
+    }
+    fp64 calc_ns = (fp64)(now_ns() - start) / iterations;
+
+    start = now_ns();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        PID_bank_calc(&bank, bench_ref[n % BENCH_INPUT_LEN], bench_set[n % BENCH_INPUT_LEN]);
+        sink = bank.out[0];
+    }
+    fp64 bank_ns = (fp64)(now_ns() - start) / iterations;
+    (void)sink;
+
+    int match = 1;
+    for (uint8_t i = 0; i < num; i++)
+    {
+        match &= pid[i].out == bank.out[i] && pid[i].Iout == bank.Iout[i];
+    }
+    printf("%-4u %14.1f %14.1f %10.2f %s\n", num, calc_ns, bank_ns, calc_ns / bank_ns,
+           match ? "" : "OUTPUTS DIFFER");
+    return match;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_ITERATIONS;
+
+    srand(1);
+    for (int n = 0; n < BENCH_INPUT_LEN; n++)
+    {
+        for (int i = 0; i < PID_BANK_MAX; i++)
+        {
+            bench_ref[n][i] = (fp32)(rand() % 2000 - 1000);
+            bench_set[n][i] = (fp32)(rand() % 2000 - 1000);
+        }
+    }
+
+    printf("%-4s %14s %14s %10s\n", "num", "PID_Calc ns", "bank ns", "speedup");
+    int match = bench_run(4, iterations);
+    match &= bench_run(8, iterations);
+    return match ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,145 @@
+/**
+  ******************************************************************************
+    * @file    host/bench/pid_q_bench
+    * @date    16-October-2026
+    * @brief   Host comparison of the fixed point PID bank (PID_bank_q_calc) with
+    *          the float one (PID_bank_calc) on the same integer inputs: time per
+    *          update and the largest difference of the whole unit output
+    *          (setpoint + correction, as the chassis sends it), for the chassis
+    *          wheel gains, the trigger gains and a full PID set.
+    * @attention The difference comes from Q15.16 gain rounding and truncating the
+    *          result; the run fails if it is over BENCH_TOLERANCE_LSB. The saving
+    *          the fixed path is for does not show on the host: on the robot a task
+    *          that never touches the FPU has no s16-s31 to stack on a context
+    *          switch. Usage: pid_q_bench [iterations]
+  ******************************************************************************
+**/
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pid.h"
+
+#define BENCH_DEFAULT_ITERATIONS 10000000u
+//Inputs cycle through this many samples so neither path sees constants
+#define BENCH_INPUT_LEN 64
+//Largest allowed difference of the outputs, in motor units
+#define BENCH_TOLERANCE_LSB 1
+
+typedef struct
+{
+    const char *name;
+    fp32 gains[3];
+    fp32 max_out;
+    fp32 max_iout;
+    int32_t input_range;    //inputs are uniform in +-input_range
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    {"chassis", {0.002f, 0.0f, 0.0f}, 10000.0f, 50.0f, 9000},
+    {"trigger", {800.0f, 0.5f, 0.0f}, 8000.0f, 2500.0f, 400},
+    {"full", {0.5f, 0.01f, 0.1f}, 10000.0f, 500.0f, 1000},
+};
+
+static int32_t bench_ref[BENCH_INPUT_LEN][PID_BANK_MAX];
+static int32_t bench_set[BENCH_INPUT_LEN][PID_BANK_MAX];
+static fp32 bench_ref_f[BENCH_INPUT_LEN][PID_BANK_MAX];
+static fp32 bench_set_f[BENCH_INPUT_LEN][PID_BANK_MAX];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void bench_fill_inputs(int32_t range)
+{
+    srand(1);
+    for (int n = 0; n < BENCH_INPUT_LEN; n++)
+    {
+        for (int i = 0; i < PID_BANK_MAX; i++)
+        {
+            bench_ref[n][i] = rand() % (2 * range + 1) - range;
+            bench_set[n][i] = rand() % (2 * range + 1) - range;
+            bench_ref_f[n][i] = (fp32)bench_ref[n][i];
+            bench_set_f[n][i] = (fp32)bench_set[n][i];
+        }
+    }
+}
+
+/**
+ * @brief  Times both paths on a bank of 4, then steps both side by side and
+ *         compares their outputs
+ * @param  c: gains, limits and input range
+ * @param  iterations: updates timed per path
+ * @retval largest output difference, in motor units
+ */
+static int32_t bench_run(const bench_case_t *c, uint32_t iterations)
+{
+    const int32_t gains_q[3] = {PID_Q_CONST(c->gains[0]), PID_Q_CONST(c->gains[1]), PID_Q_CONST(c->gains[2])};
+    PidBankTypeDef bank;
+    PidBankQTypeDef bank_q;
+    //volatile so neither loop is folded away
+    volatile fp32 sink = 0.0f;
+    volatile int32_t sink_q = 0;
+
+    bench_fill_inputs(c->input_range);
+    PID_bank_init(&bank, 4, c->gains, c->max_out, c->max_iout);
+    PID_bank_q_init(&bank_q, 4, gains_q, PID_Q_CONST(c->max_out), PID_Q_CONST(c->max_iout));
+
+    uint64_t start = now_ns();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        PID_bank_calc(&bank, bench_ref_f[n % BENCH_INPUT_LEN], bench_set_f[n % BENCH_INPUT_LEN]);
+        sink = bank.out[0];
+    }
+    fp64 float_ns = (fp64)(now_ns() - start) / iterations;
+
+    start = now_ns();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        PID_bank_q_calc(&bank_q, bench_ref[n % BENCH_INPUT_LEN], bench_set[n % BENCH_INPUT_LEN]);
+        sink_q = bank_q.out[0];
+    }
+    fp64 q_ns = (fp64)(now_ns() - start) / iterations;
+    (void)sink;
+    (void)sink_q;
+
+    //Fresh state for the comparison, the timing runs stepped different counts of samples
+    int32_t max_diff = 0;
+    PID_bank_clear(&bank);
+    PID_bank_q_clear(&bank_q);
+    for (uint32_t n = 0; n < 100000; n++)
+    {
+        const int32_t *set = bench_set[n % BENCH_INPUT_LEN];
+        PID_bank_calc(&bank, bench_ref_f[n % BENCH_INPUT_LEN], bench_set_f[n % BENCH_INPUT_LEN]);
+        PID_bank_q_calc(&bank_q, bench_ref[n % BENCH_INPUT_LEN], set);
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            int32_t out = (int32_t)(set[i] + bank.out[i]);
+            int32_t out_q = PID_Q_TO_INT(PID_Q_FROM_INT(set[i]) + bank_q.out[i]);
+            int32_t diff = abs(out - out_q);
+            max_diff = diff > max_diff ? diff : max_diff;
+        }
+    }
+
+    printf("%-8s %10.1f %10.1f %10.2f %10d %s\n", c->name, float_ns, q_ns, float_ns / q_ns, max_diff,
+           max_diff <= BENCH_TOLERANCE_LSB ? "" : "OVER TOLERANCE");
+    return max_diff;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_ITERATIONS;
+    int pass = 1;
+
+    printf("%-8s %10s %10s %10s %10s\n", "gains", "float ns", "q ns", "speedup", "max diff");
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++)
+    {
+        pass &= bench_run(&bench_cases[i], iterations) <= BENCH_TOLERANCE_LSB;
+    }
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+    * @file    host/bench/trig_bench
+    * @date    16-October-2026
+    * @brief   Host benchmark of one sine + cosine pair, the gimbal's per tick
+    *          work: double sin/cos (the old fill_complex_equivalent), sinf/cosf,
+    *          arm_sin_f32/arm_cos_f32 (the old update_setpoints), and user_lib's
+    *          trig_lut by encoder count and interpolated. Each row also gives the
+    *          largest error against double precision over one turn.
+    * @attention The host arm_math.h maps arm_sin_f32 onto sinf, so its row is libm
+    *          here. On the robot time the gimbal loop before and after with the
+    *          profiler (PROFILER_LOOP_GIMBAL), where CMSIS is a 512 entry table
+    *          and double sin/cos run in software.
+    *          Usage: trig_bench [iterations]
+  ******************************************************************************
+**/
+
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "arm_math.h"
+#include "trig_lut.h"
+
+#define BENCH_DEFAULT_ITERATIONS 10000000u
+#define BENCH_TWO_PI 6.28318530717958647692
+
+typedef enum
+{
+    BENCH_LIBM_DOUBLE = 0,
+    BENCH_LIBM_FLOAT,
+    BENCH_CMSIS,
+    BENCH_LUT_ECD,
+    BENCH_LUT_INTERP,
+    BENCH_NUM,
+} bench_path_e;
+
+static const char *const bench_name[BENCH_NUM] = {
+    "sin/cos", "sinf/cosf", "arm_sin_f32", "trig_lut ecd", "trig_lut_sin_cos",
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief  One sine + cosine pair of an encoder angle through a path
+ * @param  path: implementation
+ * @param  ecd: angle in encoder counts
+ * @param  s, c: filled with the results
+ * @retval None
+ */
+static void bench_sin_cos(bench_path_e path, uint16_t ecd, fp32 *s, fp32 *c)
+{
+    fp32 rad = ecd * (fp32)(BENCH_TWO_PI / TRIG_LUT_ECD_RANGE);
+
+    switch (path)
+    {
+    case BENCH_LIBM_DOUBLE:
+        *s = sin(rad);
+        *c = cos(rad);
+        break;
+    case BENCH_LIBM_FLOAT:
+        *s = sinf(rad);
+        *c = cosf(rad);
+        break;
+    case BENCH_CMSIS:
+        *s = arm_sin_f32(rad);
+        *c = arm_cos_f32(rad);
+        break;
+    case BENCH_LUT_ECD:
+        *s = trig_lut_sin_ecd(ecd) * TRIG_LUT_Q15_TO_F32;
+        *c = trig_lut_cos_ecd(ecd) * TRIG_LUT_Q15_TO_F32;
+        break;
+    default:
+        trig_lut_sin_cos(rad, s, c);
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_ITERATIONS;
+    //volatile so the loops are not folded away
+    volatile fp32 sink;
+
+    trig_lut_init();
+    printf("%-18s %10s %12s\n", "path", "ns/pair", "max error");
+    for (bench_path_e path = BENCH_LIBM_DOUBLE; path < BENCH_NUM; path++)
+    {
+        fp32 s, c;
+        fp64 max_error = 0.0;
+
+        //Every encoder state, plus the midpoints for the interpolated path
+        for (uint32_t half_ecd = 0; half_ecd < 2 * TRIG_LUT_ECD_RANGE; half_ecd++)
+        {
+            fp64 rad = half_ecd * (BENCH_TWO_PI / (2 * TRIG_LUT_ECD_RANGE));
+            if (path == BENCH_LUT_INTERP)
+            {
+                trig_lut_sin_cos((fp32)rad, &s, &c);
+            }
+            else if (half_ecd % 2 == 0)
+            {
+                bench_sin_cos(path, half_ecd / 2, &s, &c);
+            }
+            else
+            {
+                continue;
+            }
+            fp64 error = fmax(fabs(s - sin(rad)), fabs(c - cos(rad)));
+            max_error = error > max_error ? error : max_error;
+        }
+
+        uint64_t start = now_ns();
+        for (uint32_t n = 0; n < iterations; n++)
+        {
+            bench_sin_cos(path, (uint16_t)(n * 2654435761u >> 19), &s, &c);
+            sink = s + c;
+        }
+        fp64 ns = (fp64)(now_ns() - start) / iterations;
+        printf("%-18s %10.2f %12.2e\n", bench_name[path], ns, max_error);
+    }
+    (void)sink;
+    return EXIT_SUCCESS;
+}
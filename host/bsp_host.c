@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+    * @file    host/bsp_host
+    * @date    16-October-2026
+    * @brief   Host (Linux) stand-ins for the board support functions, see bsp_host.h
+  ******************************************************************************
+**/
+
+#include "bsp_host.h"
+#include "hal_host.h"
+#include "INS_task.h"
+#include "fric.h"
+#include "rc.h"
+#include "usart.h"
+
+static fp32 INS_Angle[3] = {0.0f, 0.0f, 0.0f};
+static fp32 INS_gyro[3] = {0.0f, 0.0f, 0.0f};
+static fp32 INS_accel[3] = {0.0f, 0.0f, 0.0f};
+static fp32 INS_quat[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+
+
+/******************** INS_task ********************/
+
+const fp32 *get_INS_angle_point(void)
+{
+    return INS_Angle;
+}
+
+const fp32 *get_INS_quat_point(void)
+{
+    return INS_quat;
+}
+
+const fp32 *get_MPU6500_Gyro_Data_Point(void)
+{
+    return INS_gyro;
+}
+
+const fp32 *get_MPU6500_Accel_Data_Point(void)
+{
+    return INS_accel;
+}
+
+fp32 *bsp_host_INS_angle(void)
+{
+    return INS_Angle;
+}
+
+fp32 *bsp_host_INS_gyro(void)
+{
+    return INS_gyro;
+}
+
+fp32 *bsp_host_INS_accel(void)
+{
+    return INS_accel;
+}
+
+fp32 *bsp_host_INS_quat(void)
+{
+    return INS_quat;
+}
+
+
+/******************** hardware/fric ********************/
+
+void fric_PWM_configuration(void)
+{
+    fric_off();
+}
+
+void fric_off(void)
+{
+    hal_pwm_set(HAL_PWM_FRIC1, Fric_OFF);
+    hal_pwm_set(HAL_PWM_FRIC2, Fric_OFF);
+}
+
+void fric1_on(uint16_t cmd)
+{
+    hal_pwm_set(HAL_PWM_FRIC1, cmd);
+}
+
+void fric2_on(uint16_t cmd)
+{
+    hal_pwm_set(HAL_PWM_FRIC2, cmd);
+}
+
+
+/******************** hardware/rc ********************/
+
+void RC_Init(uint8_t *rx1_buf, uint8_t *rx2_buf, uint16_t dma_buf_num)
+{
+    hal_host_uart_attach_dma(HAL_USART1, rx1_buf, rx2_buf, dma_buf_num);
+}
+
+void RC_unable(void)
+{
+}
+
+void RC_restart(uint16_t dma_buf_num)
+{
+}
+
+
+/******************** hardware/usart ********************/
+
+void USART_6_RX_DMA_INIT(uint8_t *rx1_buf, uint8_t *rx2_buf, uint16_t dma_buf_num)
+{
+    hal_host_uart_attach_dma(HAL_USART6, rx1_buf, rx2_buf, dma_buf_num);
+}
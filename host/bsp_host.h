@@ -0,0 +1,21 @@
+/**
+  ******************************************************************************
+    * @file    host/bsp_host
+    * @date    16-October-2026
+    * @brief   Host (Linux) stand-ins for the board support functions that the
+    *          control tasks call outside of the HAL: the INS_task data pointers,
+    *          the friction wheel PWM helpers and the DBUS receiver setup.
+  ******************************************************************************
+**/
+
+#ifndef BSP_HOST_H
+#define BSP_HOST_H
+#include "main.h"
+
+//Writable views of the data normally produced by INS_task (rad, rad/s, m/s^2, quaternion w x y z)
+extern fp32 *bsp_host_INS_angle(void);
+extern fp32 *bsp_host_INS_gyro(void);
+extern fp32 *bsp_host_INS_accel(void);
+extern fp32 *bsp_host_INS_quat(void);
+
+#endif
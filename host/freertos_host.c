@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+    * @file    host/freertos_host
+    * @date    16-October-2026
+    * @brief   Host (Linux) stand-in for the FreeRTOS task API used by the tasks.
+    *          Time is simulated: the tick counter only moves when a delay is
+    *          requested, so a host run is deterministic and as fast as the CPU.
+  ******************************************************************************
+**/
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+static volatile TickType_t host_tick_count = 0;
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    host_tick_count += xTicksToDelay;
+}
+
+void vTaskDelayUntil(TickType_t *const pxPreviousWakeTime, const TickType_t xTimeIncrement)
+{
+    *pxPreviousWakeTime += xTimeIncrement;
+    if ((int32_t)(*pxPreviousWakeTime - host_tick_count) > 0)
+    {
+        host_tick_count = *pxPreviousWakeTime;
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return host_tick_count;
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return host_tick_count;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return NULL;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    (*(uint32_t *)xTaskToNotify)++;
+    *pxHigherPriorityTaskWoken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    (void)xClearCountOnExit;
+    (void)xTicksToWait;
+    return 1;
+}
@@ -0,0 +1,479 @@
+/**
+  ******************************************************************************
+    * @file    host/hal_host
+    * @date    16-October-2026
+    * @brief   Host (Linux) backend of user/hal/hal.h, see hal_host.h
+  ******************************************************************************
+**/
+
+#include "hal_host.h"
+#include "CAN_filter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+typedef struct
+{
+    hal_can_frame_t frames[HAL_HOST_CAN_RX_FIFO_LEN];
+    uint8_t head;
+    uint8_t count;
+    uint8_t overrun;
+} host_can_fifo_t;
+
+typedef struct
+{
+    host_can_fifo_t rx_fifo[HAL_CAN_FIFO_NUM];
+    hal_can_frame_t tx_log[HAL_HOST_CAN_TX_LOG_LEN];
+    uint16_t tx_head;
+    uint16_t tx_tail;
+    uint32_t tx_count;
+    uint8_t tx_irq_enabled;
+
+    hal_can_filter_bank_t filters[HAL_CAN_FILTER_BANKS];
+    uint8_t filter_num;
+    uint8_t filters_set;
+    uint32_t filtered_count;
+} host_can_t;
+
+typedef struct
+{
+    uint8_t tx_log[HAL_HOST_UART_TX_LOG_LEN];
+    uint16_t tx_head;
+    uint16_t tx_tail;
+    uint32_t tx_count;
+
+    uint8_t tx_dma_busy;
+    uint8_t tx_dma_done;
+    uint8_t tx_dma_error;
+
+    uint8_t *rx_buf[2];
+    uint16_t rx_buf_num;
+    uint8_t rx_target;
+    uint16_t rx_len;
+    uint8_t rx_idle;
+} host_uart_t;
+
+typedef struct
+{
+    uint8_t running;
+    uint8_t update;
+    uint8_t compare_match;
+    uint32_t period;
+    uint32_t compare;
+} host_timer_t;
+
+static host_can_t host_can[HAL_CAN_NUM];
+static host_uart_t host_uart[HAL_UART_NUM];
+static uint16_t host_pwm[HAL_PWM_NUM];
+static uint8_t host_spi_response[HAL_SPI_NUM];
+static uint8_t host_spi_last_tx[HAL_SPI_NUM];
+static host_timer_t host_timer[HAL_TIMER_NUM];
+//Cycles elapsed within the current simulated tick, dropped once the tick moves on
+static uint32_t host_cycle_offset;
+static TickType_t host_cycle_offset_tick;
+
+
+void hal_host_reset(void)
+{
+    memset(host_can, 0, sizeof(host_can));
+    memset(host_uart, 0, sizeof(host_uart));
+    memset(host_pwm, 0, sizeof(host_pwm));
+    memset(host_spi_response, 0xFF, sizeof(host_spi_response));
+    memset(host_spi_last_tx, 0, sizeof(host_spi_last_tx));
+    memset(host_timer, 0, sizeof(host_timer));
+    host_cycle_offset = 0;
+    host_cycle_offset_tick = xTaskGetTickCount();
+}
+
+
+/******************** Interrupt masking ********************/
+
+//Everything runs on one thread, there is nothing to mask
+uint32_t hal_irq_disable(void)
+{
+    return 0;
+}
+
+void hal_irq_restore(uint32_t state)
+{
+    (void)state;
+}
+
+
+/******************** CAN ********************/
+
+uint8_t hal_can_transmit(hal_can_e can, const hal_can_frame_t *frame)
+{
+    host_can_t *bus = &host_can[can];
+    uint16_t next = (bus->tx_head + 1) % HAL_HOST_CAN_TX_LOG_LEN;
+    if (next == bus->tx_tail)
+    {
+        return HAL_CAN_NO_MAILBOX;
+    }
+    bus->tx_log[bus->tx_head] = *frame;
+    bus->tx_head = next;
+    bus->tx_count++;
+    return 0;
+}
+
+void hal_can_tx_irq_enable(hal_can_e can, uint8_t enable)
+{
+    host_can[can].tx_irq_enabled = enable;
+}
+
+void hal_can_tx_irq_ack(hal_can_e can)
+{
+    (void)can;
+}
+
+uint8_t hal_host_can_tx_irq_enabled(hal_can_e can)
+{
+    return host_can[can].tx_irq_enabled;
+}
+
+uint8_t hal_can_receive(hal_can_e can, hal_can_fifo_e fifo, hal_can_frame_t *frame)
+{
+    host_can_fifo_t *rx = &host_can[can].rx_fifo[fifo];
+    if (rx->count == 0)
+    {
+        return 0;
+    }
+    *frame = rx->frames[rx->head];
+    rx->head = (rx->head + 1) % HAL_HOST_CAN_RX_FIFO_LEN;
+    rx->count--;
+    return 1;
+}
+
+uint8_t hal_can_fifo_overrun(hal_can_e can, hal_can_fifo_e fifo)
+{
+    host_can_fifo_t *rx = &host_can[can].rx_fifo[fifo];
+    if (!rx->overrun)
+    {
+        return 0;
+    }
+    rx->overrun = 0;
+    return 1;
+}
+
+void hal_can_set_filters(hal_can_e can, const hal_can_filter_bank_t *banks, uint8_t bank_num)
+{
+    host_can_t *bus = &host_can[can];
+    if (bank_num > HAL_CAN_FILTER_BANKS)
+    {
+        bank_num = HAL_CAN_FILTER_BANKS;
+    }
+    memcpy(bus->filters, banks, bank_num * sizeof(hal_can_filter_bank_t));
+    bus->filter_num = bank_num;
+    bus->filters_set = 1;
+}
+
+uint32_t hal_host_can_filtered_count(hal_can_e can)
+{
+    return host_can[can].filtered_count;
+}
+
+int8_t hal_host_can_push_rx(hal_can_e can, const hal_can_frame_t *frame)
+{
+    host_can_t *bus = &host_can[can];
+    //Matched by the firmware's own model of the bxCAN acceptance test
+    int8_t fifo = bus->filters_set ? CAN_filter_match(bus->filters, bus->filter_num, (uint16_t)frame->std_id)
+                                   : HAL_CAN_FIFO0;
+    if (fifo < 0)
+    {
+        bus->filtered_count++;
+        return -1;
+    }
+
+    host_can_fifo_t *rx = &bus->rx_fifo[fifo];
+    if (rx->count == HAL_HOST_CAN_RX_FIFO_LEN)
+    {
+        //Not locked (RFLM = 0): the newest frame in the FIFO is overwritten
+        rx->frames[(rx->head + rx->count - 1) % HAL_HOST_CAN_RX_FIFO_LEN] = *frame;
+        rx->overrun = 1;
+        return fifo;
+    }
+    rx->frames[(rx->head + rx->count) % HAL_HOST_CAN_RX_FIFO_LEN] = *frame;
+    rx->count++;
+    return fifo;
+}
+
+uint8_t hal_host_can_rx_pending(hal_can_e can, hal_can_fifo_e fifo)
+{
+    return host_can[can].rx_fifo[fifo].count;
+}
+
+uint8_t hal_host_can_pop_tx(hal_can_e can, hal_can_frame_t *frame)
+{
+    host_can_t *bus = &host_can[can];
+    if (bus->tx_tail == bus->tx_head)
+    {
+        return 0;
+    }
+    *frame = bus->tx_log[bus->tx_tail];
+    bus->tx_tail = (bus->tx_tail + 1) % HAL_HOST_CAN_TX_LOG_LEN;
+    return 1;
+}
+
+uint32_t hal_host_can_tx_count(hal_can_e can)
+{
+    return host_can[can].tx_count;
+}
+
+
+/******************** UART ********************/
+
+void hal_uart_send_byte(hal_uart_e uart, uint8_t byte)
+{
+    host_uart_t *port = &host_uart[uart];
+    uint16_t next = (port->tx_head + 1) % HAL_HOST_UART_TX_LOG_LEN;
+    //Overwrite the oldest byte rather than block, nobody may be reading the log
+    if (next == port->tx_tail)
+    {
+        port->tx_tail = (port->tx_tail + 1) % HAL_HOST_UART_TX_LOG_LEN;
+    }
+    port->tx_log[port->tx_head] = byte;
+    port->tx_head = next;
+    port->tx_count++;
+}
+
+uint8_t hal_uart_dma_tx(hal_uart_e uart, const uint8_t *buf, uint16_t len)
+{
+    host_uart_t *port = &host_uart[uart];
+    if (port->tx_dma_busy)
+    {
+        return 0;
+    }
+    //The bytes land in the TX log right away, the transfer ends with hal_host_uart_dma_tx_finish
+    for (uint16_t i = 0; i < len; i++)
+    {
+        hal_uart_send_byte(uart, buf[i]);
+    }
+    port->tx_dma_busy = 1;
+    return 1;
+}
+
+uint8_t hal_uart_dma_tx_done(hal_uart_e uart)
+{
+    host_uart_t *port = &host_uart[uart];
+    if (!port->tx_dma_done)
+    {
+        return 0;
+    }
+    port->tx_dma_done = 0;
+    return 1;
+}
+
+uint8_t hal_uart_dma_tx_error(hal_uart_e uart)
+{
+    host_uart_t *port = &host_uart[uart];
+    if (!port->tx_dma_error)
+    {
+        return 0;
+    }
+    port->tx_dma_error = 0;
+    return 1;
+}
+
+uint8_t hal_host_uart_dma_tx_finish(hal_uart_e uart)
+{
+    host_uart_t *port = &host_uart[uart];
+    if (!port->tx_dma_busy)
+    {
+        return 0;
+    }
+    port->tx_dma_busy = 0;
+    port->tx_dma_done = 1;
+    return 1;
+}
+
+uint8_t hal_host_uart_dma_tx_fail(hal_uart_e uart)
+{
+    host_uart_t *port = &host_uart[uart];
+    if (!port->tx_dma_busy)
+    {
+        return 0;
+    }
+    port->tx_dma_busy = 0;
+    port->tx_dma_error = 1;
+    return 1;
+}
+
+uint8_t hal_uart_dma_rx_idle(hal_uart_e uart, uint16_t dma_buf_num, uint8_t *buf_index, uint16_t *rx_len)
+{
+    host_uart_t *port = &host_uart[uart];
+    if (!port->rx_idle)
+    {
+        return 0;
+    }
+    port->rx_idle = 0;
+    *buf_index = port->rx_target;
+    *rx_len = port->rx_len;
+    port->rx_target ^= 1;
+    port->rx_len = 0;
+    return 1;
+}
+
+uint16_t hal_host_uart_read_tx(hal_uart_e uart, uint8_t *buf, uint16_t len)
+{
+    host_uart_t *port = &host_uart[uart];
+    uint16_t n = 0;
+    while (n < len && port->tx_tail != port->tx_head)
+    {
+        buf[n++] = port->tx_log[port->tx_tail];
+        port->tx_tail = (port->tx_tail + 1) % HAL_HOST_UART_TX_LOG_LEN;
+    }
+    return n;
+}
+
+uint32_t hal_host_uart_tx_count(hal_uart_e uart)
+{
+    return host_uart[uart].tx_count;
+}
+
+void hal_host_uart_attach_dma(hal_uart_e uart, uint8_t *rx1_buf, uint8_t *rx2_buf, uint16_t dma_buf_num)
+{
+    host_uart_t *port = &host_uart[uart];
+    port->rx_buf[0] = rx1_buf;
+    port->rx_buf[1] = rx2_buf;
+    port->rx_buf_num = dma_buf_num;
+    port->rx_target = 0;
+    port->rx_len = 0;
+    port->rx_idle = 0;
+}
+
+void hal_host_uart_dma_write(hal_uart_e uart, const uint8_t *data, uint16_t len)
+{
+    host_uart_t *port = &host_uart[uart];
+    if (port->rx_buf[0] == NULL)
+    {
+        return;
+    }
+    if (len > port->rx_buf_num)
+    {
+        len = port->rx_buf_num;
+    }
+    memcpy(port->rx_buf[port->rx_target], data, len);
+    port->rx_len = len;
+    port->rx_idle = 1;
+}
+
+
+/******************** PWM ********************/
+
+void hal_pwm_set(hal_pwm_e channel, uint16_t compare)
+{
+    host_pwm[channel] = compare;
+}
+
+uint16_t hal_host_pwm_get(hal_pwm_e channel)
+{
+    return host_pwm[channel];
+}
+
+
+/******************** SPI ********************/
+
+uint8_t hal_spi_read_write_byte(hal_spi_e spi, uint8_t tx_data)
+{
+    host_spi_last_tx[spi] = tx_data;
+    return host_spi_response[spi];
+}
+
+void hal_host_spi_set_response(hal_spi_e spi, uint8_t rx_data)
+{
+    host_spi_response[spi] = rx_data;
+}
+
+uint8_t hal_host_spi_last_tx(hal_spi_e spi)
+{
+    return host_spi_last_tx[spi];
+}
+
+
+/******************** Timers ********************/
+
+void hal_timer_start(hal_timer_e timer, uint32_t period)
+{
+    host_timer[timer].period = period;
+    host_timer[timer].running = 1;
+}
+
+void hal_timer_stop(hal_timer_e timer)
+{
+    host_timer[timer].running = 0;
+}
+
+uint8_t hal_timer_update_flag(hal_timer_e timer)
+{
+    if (!host_timer[timer].update)
+    {
+        return 0;
+    }
+    host_timer[timer].update = 0;
+    return 1;
+}
+
+void hal_timer_set_compare(hal_timer_e timer, uint32_t compare)
+{
+    host_timer[timer].compare = compare;
+}
+
+uint8_t hal_timer_compare_flag(hal_timer_e timer)
+{
+    if (!host_timer[timer].compare_match)
+    {
+        return 0;
+    }
+    host_timer[timer].compare_match = 0;
+    return 1;
+}
+
+void hal_host_timer_fire(hal_timer_e timer)
+{
+    host_timer[timer].update = 1;
+}
+
+void hal_host_timer_fire_compare(hal_timer_e timer)
+{
+    host_timer[timer].compare_match = 1;
+}
+
+uint32_t hal_host_timer_compare(hal_timer_e timer)
+{
+    return host_timer[timer].compare;
+}
+
+uint8_t hal_host_timer_running(hal_timer_e timer)
+{
+    return host_timer[timer].running;
+}
+
+uint32_t hal_host_timer_period(hal_timer_e timer)
+{
+    return host_timer[timer].period;
+}
+
+
+/******************** Cycle counter ********************/
+
+void hal_cycle_counter_init(void)
+{
+    host_cycle_offset = 0;
+}
+
+uint32_t hal_cycle_count(void)
+{
+    TickType_t tick = xTaskGetTickCount();
+    if (tick != host_cycle_offset_tick)
+    {
+        host_cycle_offset = 0;
+        host_cycle_offset_tick = tick;
+    }
+    return tick * (HAL_CYCLE_HZ / configTICK_RATE_HZ) + host_cycle_offset;
+}
+
+void hal_host_cycle_advance(uint32_t cycles)
+{
+    hal_cycle_count();
+    host_cycle_offset += cycles;
+}
@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+    * @file    host/hal_host
+    * @date    16-October-2026
+    * @brief   Host (Linux) backend of user/hal/hal.h. The peripherals are modelled
+    *          as plain memory so a simulation or benchmark can inject received
+    *          data and inspect what the firmware sent:
+    *          CAN:   per-bus 3 deep RX FIFOs fed by hal_host_can_push_rx, TX log drained by
+    *                 hal_host_can_pop_tx (three frames fill it, like the mailboxes),
+    *                 filter banks are applied to pushed frames
+    *          UART:  TX bytes are captured (DMA transfers when started, completed by
+    *                 hal_host_uart_dma_tx_finish or failed by hal_host_uart_dma_tx_fail),
+    *                 DMA receivers are fed in whole frames
+    *          PWM:   last compare value per channel
+    *          SPI:   fixed response byte, last byte written is recorded
+    *          Timer: update and compare flags are raised by hand with hal_host_timer_fire(_compare)
+    *          Cycles: follow the simulated FreeRTOS tick, plus hal_host_cycle_advance
+    *                  within the current tick
+  ******************************************************************************
+**/
+
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+#include "hal.h"
+
+//Same depth as the bxCAN receive FIFOs
+#define HAL_HOST_CAN_RX_FIFO_LEN 3
+//Frames stay in the TX log until popped, like frames waiting in the three bxCAN mailboxes
+//(the ring keeps one slot empty)
+#define HAL_HOST_CAN_TX_LOG_LEN 4
+#define HAL_HOST_UART_TX_LOG_LEN 4096
+
+//Resets every peripheral model to power-on state
+extern void hal_host_reset(void);
+
+//Queues a frame as if it had arrived on the bus and returns the receive FIFO it landed in, or -1
+//if the filter banks set by hal_can_set_filters reject it (everything goes to FIFO0 until they are
+//set). A full FIFO overwrites its newest frame and flags an overrun, like the bxCAN does
+extern int8_t hal_host_can_push_rx(hal_can_e can, const hal_can_frame_t *frame);
+//Frames waiting in a receive FIFO, the pending interrupt condition
+extern uint8_t hal_host_can_rx_pending(hal_can_e can, hal_can_fifo_e fifo);
+//Frames rejected by the filter banks
+extern uint32_t hal_host_can_filtered_count(hal_can_e can);
+//Returns 1 and the oldest frame transmitted by the firmware, 0 if none is left
+extern uint8_t hal_host_can_pop_tx(hal_can_e can, hal_can_frame_t *frame);
+extern uint32_t hal_host_can_tx_count(hal_can_e can);
+//Whether the firmware wants the TX interrupt, call CANx_TX_IRQHandler after popping frames if so
+extern uint8_t hal_host_can_tx_irq_enabled(hal_can_e can);
+
+//Copies out up to len captured TX bytes and removes them from the log, returns the count
+extern uint16_t hal_host_uart_read_tx(hal_uart_e uart, uint8_t *buf, uint16_t len);
+extern uint32_t hal_host_uart_tx_count(hal_uart_e uart);
+//Ends a running TX DMA transfer and raises its complete flag, returns 0 if none was running.
+//Call the stream's interrupt handler afterwards, as the DMA controller would
+extern uint8_t hal_host_uart_dma_tx_finish(hal_uart_e uart);
+//Ends a running TX DMA transfer with a transfer error instead, returns 0 if none was running
+extern uint8_t hal_host_uart_dma_tx_fail(hal_uart_e uart);
+//Registers the double buffer given to the DMA receiver (done by the RC_Init and USART_6_RX_DMA_INIT stand-ins)
+extern void hal_host_uart_attach_dma(hal_uart_e uart, uint8_t *rx1_buf, uint8_t *rx2_buf, uint16_t dma_buf_num);
+//Writes a frame into the active DMA buffer and flags an IDLE line event
+extern void hal_host_uart_dma_write(hal_uart_e uart, const uint8_t *data, uint16_t len);
+
+extern uint16_t hal_host_pwm_get(hal_pwm_e channel);
+
+extern void hal_host_spi_set_response(hal_spi_e spi, uint8_t rx_data);
+extern uint8_t hal_host_spi_last_tx(hal_spi_e spi);
+
+extern void hal_host_timer_fire(hal_timer_e timer);
+//Raises the channel 1 compare flag, as if the counter reached hal_host_timer_compare
+extern void hal_host_timer_fire_compare(hal_timer_e timer);
+extern uint32_t hal_host_timer_compare(hal_timer_e timer);
+extern uint8_t hal_host_timer_running(hal_timer_e timer);
+extern uint32_t hal_host_timer_period(hal_timer_e timer);
+//Moves the cycle counter forward within the current simulated tick
+extern void hal_host_cycle_advance(uint32_t cycles);
+
+#endif
@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+    * @file    host/include/FreeRTOS.h
+    * @date    16-October-2026
+    * @brief   Host (Linux) stand-in for the FreeRTOS kernel header. Only the types
+    *          and macros used by the control tasks are provided.
+  ******************************************************************************
+**/
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+#include "main.h"
+#include "FreeRTOSConfig.h"
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS (pdTRUE)
+#define pdFAIL (pdFALSE)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+
+#endif
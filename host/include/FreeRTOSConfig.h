@@ -0,0 +1,17 @@
+/**
+  ******************************************************************************
+    * @file    host/include/FreeRTOSConfig.h
+    * @date    16-October-2026
+    * @brief   Host (Linux) stand-in for user/FreeRTOS/include/FreeRTOSConfig.h
+  ******************************************************************************
+**/
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+#include "main.h"
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_TASK_NAME_LEN 16
+#define INCLUDE_uxTaskGetStackHighWaterMark 0
+
+#endif
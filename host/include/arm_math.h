@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+    * @file    host/include/arm_math.h
+    * @date    16-October-2026
+    * @brief   Host (Linux) stand-in for the CMSIS-DSP header. The functions used by
+    *          the control code are mapped onto libm so results match the target to
+    *          within float rounding.
+  ******************************************************************************
+**/
+
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+#include <math.h>
+#include <stdint.h>
+
+#define PI 3.14159265358979f
+
+typedef float float32_t;
+typedef double float64_t;
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+typedef enum
+{
+    ARM_MATH_SUCCESS = 0,
+    ARM_MATH_ARGUMENT_ERROR = -1,
+    ARM_MATH_LENGTH_ERROR = -2,
+    ARM_MATH_SIZE_MISMATCH = -3,
+    ARM_MATH_NANINF = -4,
+    ARM_MATH_SINGULAR = -5,
+    ARM_MATH_TEST_FAILURE = -6
+} arm_status;
+
+//Same saturation as the CMSIS-DSP inline
+static inline q31_t clip_q63_to_q31(q63_t x)
+{
+    return ((q31_t)(x >> 32) != ((q31_t)x >> 31)) ? ((0x7FFFFFFF ^ ((q31_t)(x >> 63)))) : (q31_t)x;
+}
+
+static inline float32_t arm_sin_f32(float32_t x)
+{
+    return sinf(x);
+}
+
+static inline float32_t arm_cos_f32(float32_t x)
+{
+    return cosf(x);
+}
+
+static inline arm_status arm_sqrt_f32(float32_t in, float32_t *pOut)
+{
+    if (in >= 0.0f)
+    {
+        *pOut = sqrtf(in);
+        return ARM_MATH_SUCCESS;
+    }
+    *pOut = 0.0f;
+    return ARM_MATH_ARGUMENT_ERROR;
+}
+
+#endif
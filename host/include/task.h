@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+    * @file    host/include/task.h
+    * @date    16-October-2026
+    * @brief   Host (Linux) stand-in for the FreeRTOS task API. There is no
+    *          scheduler: the tick count is simulated time and vTaskDelay just
+    *          advances it, see host/freertos_host.c.
+  ******************************************************************************
+**/
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+#include "FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define taskDISABLE_INTERRUPTS()
+#define taskENABLE_INTERRUPTS()
+
+//Notifications: a host task handle points at a uint32_t the caller owns, giving a
+//notification increments it. Nothing blocks, ulTaskNotifyTake returns at once
+#define portYIELD_FROM_ISR(x) ((void)(x))
+
+extern void vTaskDelay(const TickType_t xTicksToDelay);
+extern void vTaskDelayUntil(TickType_t *const pxPreviousWakeTime, const TickType_t xTimeIncrement);
+extern TickType_t xTaskGetTickCount(void);
+extern TickType_t xTaskGetTickCountFromISR(void);
+extern TaskHandle_t xTaskGetCurrentTaskHandle(void);
+extern void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken);
+extern uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+#endif
@@ -0,0 +1,486 @@
+/**
+  ******************************************************************************
+    * @file    host/sim/aim_replay
+    * @date    16-October-2026
+    * @brief   Offline replay of target tracks through the vision aim predictor
+    *          (APP/aim). A 1 kHz loop pushes the gimbal attitude and hands over
+    *          vision frames as they would arrive: sampled at 100 Hz, seen through
+    *          the attitude at capture, with angle and range noise, delivered after
+    *          the pipeline latency plus jitter and the wire time. Every tick each
+    *          method picks a point to shoot at, and its aim is compared with the
+    *          ballistic aim at where the target really is when the projectile
+    *          gets there. The miss is that angle error times the distance.
+    * @attention Methods:
+    *              raw       newest frame as if it were seen now, through today's attitude
+    *              capture   newest frame through the attitude at its capture time
+    *              kf        filter prediction for now, no lead
+    *              kf+lead   aim_solve: prediction for now plus the flight time
+    *            kf and kf+lead run with both motion models. Ticks before the
+    *            first AIM_REPLAY_WARMUP_S and without a track are not scored.
+    *            Usage: aim_replay [-l ms] [-j ms] [-n mrad] [track.csv]
+    *              -l, -j  pipeline latency and uniform jitter, default 30 and 10
+    *              -n      angle noise, default 2; range noise is 2%
+    *              track   t_s,valid,yaw_rad,pitch_rad,distance_m rows as written for
+    *                      host/tools/vision_replay, taken as the truth with the gimbal
+    *                      still. Without it the built-in scenarios run.
+    *            Fails if kf+lead with GIMBAL_AIM_MODEL misses more (RMS) than raw in
+    *            any scenario.
+  ******************************************************************************
+**/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aim.h"
+#include "gimbal_task.h"
+#include "hal.h"
+#include "usart.h"
+
+#define AIM_REPLAY_TICK_S 0.001
+#define AIM_REPLAY_FRAME_S 0.010
+#define AIM_REPLAY_DURATION_S 8.0
+#define AIM_REPLAY_WARMUP_S 0.5
+#define AIM_REPLAY_RANGE_NOISE 0.02
+//Half the height of a small armour plate
+#define AIM_REPLAY_HIT_RADIUS 0.06
+//Start just before the cycle counter wraps, so every run crosses it
+#define AIM_REPLAY_CYCLE_START (0xFFFFFFFFu - 2u * HAL_CYCLE_HZ)
+#define AIM_REPLAY_TICKS ((uint32_t)(AIM_REPLAY_DURATION_S / AIM_REPLAY_TICK_S))
+#define AIM_REPLAY_CSV_MAX 100000
+#define AIM_REPLAY_TWO_PI 6.283185307179586
+
+typedef enum
+{
+    METHOD_RAW = 0,
+    METHOD_CAPTURE,
+    METHOD_KF_CV,
+    METHOD_LEAD_CV,
+    METHOD_KF_CA,
+    METHOD_LEAD_CA,
+    METHOD_NUM,
+} replay_method_e;
+
+static const char *const method_name[METHOD_NUM] = {
+    "raw", "capture", "kf cv", "kf+lead cv", "kf ca", "kf+lead ca",
+};
+
+typedef enum
+{
+    SCENARIO_STATIC = 0,
+    SCENARIO_STRAFE,
+    SCENARIO_CIRCLE,
+    SCENARIO_STRAFE_SWEEP,
+    SCENARIO_STATIC_TURN,
+    SCENARIO_CSV,
+    SCENARIO_NUM,
+} replay_scenario_e;
+
+static const char *const scenario_name[SCENARIO_NUM] = {
+    "static target",
+    "strafing target",
+    "spinning armour",
+    "strafing, gimbal sweeping",
+    "static, gimbal turning",
+    "csv track",
+};
+
+typedef struct
+{
+    fp64 t;
+    int valid;
+    fp64 position[3];
+} csv_row_t;
+
+typedef struct
+{
+    fp64 *miss;         //m, one per scored tick
+    uint32_t scored;
+    uint32_t ticks;     //ticks after the warm-up, scored or not
+} method_result_t;
+
+static fp64 latency_s = 0.030, jitter_s = 0.010, angle_noise = 0.002;
+static csv_row_t *csv_rows;
+static uint32_t csv_count;
+static uint64_t rng_state = 0x2545F4914F6CDD1Dull;
+
+
+static fp64 uniform(void)
+{
+    rng_state = rng_state * 6364136223846793005ull + 1442695040888963407ull;
+    return (rng_state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static fp64 gaussian(void)
+{
+    fp64 u = uniform();
+    return sqrt(-2.0 * log(u > 1e-300 ? u : 1e-300)) * cos(AIM_REPLAY_TWO_PI * uniform());
+}
+
+static fp64 wrap_pi(fp64 angle)
+{
+    return atan2(sin(angle), cos(angle));
+}
+
+static uint32_t cycles_at(fp64 t)
+{
+    return AIM_REPLAY_CYCLE_START + (uint32_t)llround(t * HAL_CYCLE_HZ);
+}
+
+/**
+ * @brief  Where the target really is
+ * @retval 0 if there is no target at that time
+ */
+static int truth_position(replay_scenario_e scenario, fp64 t, fp64 position[3])
+{
+    position[0] = 3.0;
+    position[1] = 0.0;
+    position[2] = 0.2;
+    switch (scenario)
+    {
+    case SCENARIO_STRAFE:
+    case SCENARIO_STRAFE_SWEEP:
+        position[1] = sin(AIM_REPLAY_TWO_PI * 0.5 * t);
+        break;
+    case SCENARIO_CIRCLE:
+        position[0] = 4.0 - 0.3 * cos(AIM_REPLAY_TWO_PI * t);
+        position[1] = 0.3 * sin(AIM_REPLAY_TWO_PI * t);
+        break;
+    case SCENARIO_CSV:
+    {
+        uint32_t i = 1;
+        while (i < csv_count && csv_rows[i].t < t)
+        {
+            i++;
+        }
+        if (i >= csv_count || !csv_rows[i - 1].valid || !csv_rows[i].valid)
+        {
+            return 0;
+        }
+        fp64 span = csv_rows[i].t - csv_rows[i - 1].t;
+        fp64 k = span > 0.0 ? (t - csv_rows[i - 1].t) / span : 0.0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            position[axis] = csv_rows[i - 1].position[axis] * (1.0 - k) + csv_rows[i].position[axis] * k;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return 1;
+}
+
+//Gimbal attitude, yaw then pitch in INS_Angle terms
+static void attitude(replay_scenario_e scenario, fp64 t, fp32 quat[4])
+{
+    fp64 yaw = 0.0, pitch = 0.0;
+
+    if (scenario == SCENARIO_STRAFE_SWEEP)
+    {
+        yaw = 0.4 * sin(AIM_REPLAY_TWO_PI * t);
+        pitch = 0.05 * sin(AIM_REPLAY_TWO_PI * 0.7 * t);
+    }
+    else if (scenario == SCENARIO_STATIC_TURN)
+    {
+        yaw = wrap_pi(1.5 * t);
+    }
+    quat[0] = (fp32)(cos(yaw / 2) * cos(pitch / 2));
+    quat[1] = (fp32)(-sin(yaw / 2) * sin(pitch / 2));
+    quat[2] = (fp32)(cos(yaw / 2) * sin(pitch / 2));
+    quat[3] = (fp32)(sin(yaw / 2) * cos(pitch / 2));
+}
+
+//World to camera is the conjugate rotation
+static void world_to_camera(const fp32 quat[4], const fp64 world[3], fp64 camera[3])
+{
+    fp64 w = quat[0], x = -quat[1], y = -quat[2], z = -quat[3];
+    fp64 tx = 2.0 * (y * world[2] - z * world[1]);
+    fp64 ty = 2.0 * (z * world[0] - x * world[2]);
+    fp64 tz = 2.0 * (x * world[1] - y * world[0]);
+
+    camera[0] = world[0] + w * tx + (y * tz - z * ty);
+    camera[1] = world[1] + w * ty + (z * tx - x * tz);
+    camera[2] = world[2] + w * tz + (x * ty - y * tx);
+}
+
+/**
+ * @brief  The frame the vision PC would send for a capture at t, noise included
+ * @retval 0 if there is no target
+ */
+static int capture_frame(replay_scenario_e scenario, fp64 t, vision_frame_t *frame)
+{
+    fp64 world[3], camera[3];
+    fp32 quat[4];
+
+    if (!truth_position(scenario, t, world))
+    {
+        return 0;
+    }
+    attitude(scenario, t, quat);
+    world_to_camera(quat, world, camera);
+    fp64 distance = sqrt(camera[0] * camera[0] + camera[1] * camera[1] + camera[2] * camera[2]);
+    frame->flags = VISION_FLAG_TARGET;
+    frame->yaw = (fp32)(atan2(camera[1], camera[0]) + angle_noise * gaussian());
+    frame->pitch = (fp32)(asin(camera[2] / distance) + angle_noise * gaussian());
+    frame->distance = (fp32)(distance * (1.0 + AIM_REPLAY_RANGE_NOISE * gaussian()));
+    return 1;
+}
+
+//Ballistic aim at the true target position when the projectile arrives
+static int ideal_aim(replay_scenario_e scenario, fp64 t, fp32 *yaw, fp32 *pitch, fp64 *distance)
+{
+    fp32 flight_time = 0.0f;
+    fp64 world[3];
+
+    for (int i = 0; i < 5; i++)
+    {
+        if (!truth_position(scenario, t + flight_time, world))
+        {
+            return 0;
+        }
+        fp32 position[3] = {(fp32)world[0], (fp32)world[1], (fp32)world[2]};
+        aim_ballistic(position, AIM_BULLET_SPEED, yaw, pitch, &flight_time);
+    }
+    *distance = sqrt(world[0] * world[0] + world[1] * world[1] + world[2] * world[2]);
+    return 1;
+}
+
+static int compare_fp64(const void *a, const void *b)
+{
+    fp64 x = *(const fp64 *)a, y = *(const fp64 *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief  Runs one scenario and prints a row per method
+ * @retval RMS miss of kf+lead with GIMBAL_AIM_MODEL over that of raw
+ */
+static fp64 run_scenario(replay_scenario_e scenario, uint32_t ticks)
+{
+    static aim_predictor_t cv, ca;
+    method_result_t result[METHOD_NUM];
+    vision_target_t pending[16], newest = {.count = 0};
+    uint32_t pending_count = 0, frame_count = 0;
+    fp64 next_capture = 0.0;
+    aim_stats_t cv_stats;
+
+    aim_init(&cv, AIM_MODEL_CV);
+    aim_init(&ca, AIM_MODEL_CA);
+    for (int m = 0; m < METHOD_NUM; m++)
+    {
+        result[m].miss = malloc(ticks * sizeof(fp64));
+        result[m].scored = 0;
+        result[m].ticks = 0;
+    }
+
+    for (uint32_t tick = 0; tick < ticks; tick++)
+    {
+        fp64 t = tick * AIM_REPLAY_TICK_S;
+        uint32_t now = cycles_at(t);
+        fp32 quat[4];
+
+        attitude(scenario, t, quat);
+        aim_attitude_push(&cv, now, quat);
+        aim_attitude_push(&ca, now, quat);
+
+        //Capture, then hold each frame back by its latency and wire time
+        while (next_capture <= t)
+        {
+            vision_target_t *target = &pending[pending_count % 16];
+            fp64 latency = latency_s + jitter_s * uniform();
+            fp64 wire = (VISION_FRAME_LEN + 1) * 10.0 / USART6_BAUDRATE;
+
+            if (capture_frame(scenario, next_capture, &target->frame))
+            {
+                target->frame.latency_us = (uint32_t)(latency * 1e6);
+                target->capture_cycles = cycles_at(next_capture);
+                target->rx_cycles = cycles_at(next_capture + latency + wire);
+                pending_count++;
+            }
+            next_capture += AIM_REPLAY_FRAME_S;
+        }
+        //The pipeline keeps order: a frame waits for the one before it
+        while (frame_count < pending_count && (int32_t)(now - pending[frame_count % 16].rx_cycles) >= 0)
+        {
+            newest = pending[frame_count % 16];
+            newest.count = ++frame_count;
+            aim_measure(&cv, &newest);
+            aim_measure(&ca, &newest);
+        }
+
+        fp32 ideal_yaw, ideal_pitch;
+        fp64 distance;
+        if (t < AIM_REPLAY_WARMUP_S || !ideal_aim(scenario, t, &ideal_yaw, &ideal_pitch, &distance))
+        {
+            continue;
+        }
+        for (int m = 0; m < METHOD_NUM; m++)
+        {
+            const aim_predictor_t *aim = m == METHOD_KF_CA || m == METHOD_LEAD_CA ? &ca : &cv;
+            fp32 position[3], capture_quat[4], yaw, pitch, flight_time;
+            aim_solution_t solution;
+            int valid = newest.count != 0;
+
+            result[m].ticks++;
+            switch (m)
+            {
+            case METHOD_RAW:
+                aim_camera_to_world(quat, &newest.frame, position);
+                break;
+            case METHOD_CAPTURE:
+                aim_attitude_at(aim, newest.capture_cycles, capture_quat);
+                aim_camera_to_world(capture_quat, &newest.frame, position);
+                break;
+            case METHOD_KF_CV:
+            case METHOD_KF_CA:
+                valid = aim_predict(aim, now, position, NULL);
+                break;
+            default:
+                aim_solve(aim, now, &solution);
+                valid = solution.valid;
+                break;
+            }
+            if (!valid)
+            {
+                continue;
+            }
+            if (m == METHOD_LEAD_CV || m == METHOD_LEAD_CA)
+            {
+                yaw = solution.yaw;
+                pitch = solution.pitch;
+            }
+            else
+            {
+                aim_ballistic(position, AIM_BULLET_SPEED, &yaw, &pitch, &flight_time);
+            }
+            fp64 across = wrap_pi(yaw - ideal_yaw) * cos(ideal_pitch);
+            result[m].miss[result[m].scored++] = hypot(across, pitch - ideal_pitch) * distance;
+        }
+    }
+
+    fp64 rms[METHOD_NUM] = {0};
+    for (int m = 0; m < METHOD_NUM; m++)
+    {
+        method_result_t *r = &result[m];
+        fp64 sum2 = 0.0;
+        uint32_t hits = 0;
+
+        qsort(r->miss, r->scored, sizeof(fp64), compare_fp64);
+        for (uint32_t i = 0; i < r->scored; i++)
+        {
+            sum2 += r->miss[i] * r->miss[i];
+            hits += r->miss[i] < AIM_REPLAY_HIT_RADIUS;
+        }
+        if (r->scored == 0)
+        {
+            printf("%-26s %-11s %10s\n", m == 0 ? scenario_name[scenario] : "", method_name[m], "no aim");
+            free(r->miss);
+            continue;
+        }
+        rms[m] = sqrt(sum2 / r->scored);
+        printf("%-26s %-11s %10.1f %10.1f %10.1f %8.1f %8.1f\n", m == 0 ? scenario_name[scenario] : "",
+               method_name[m], rms[m] * 1e3, r->miss[(uint32_t)(0.95 * (r->scored - 1))] * 1e3,
+               r->miss[r->scored - 1] * 1e3, 100.0 * hits / r->scored, 100.0 * r->scored / r->ticks);
+        free(r->miss);
+    }
+    cv_stats = cv.stats;
+    printf("%-26s %u frames, %u gated, %u tracks, %u before the attitude history\n", "", cv_stats.measurements,
+           cv_stats.gated, cv_stats.resets, cv_stats.history_misses);
+
+    replay_method_e lead = GIMBAL_AIM_MODEL == AIM_MODEL_CV ? METHOD_LEAD_CV : METHOD_LEAD_CA;
+    return rms[lead] / rms[METHOD_RAW];
+}
+
+static int load_csv(const char *path)
+{
+    char line[256];
+    FILE *in = fopen(path, "r");
+
+    if (in == NULL)
+    {
+        perror(path);
+        return 0;
+    }
+    csv_rows = malloc(AIM_REPLAY_CSV_MAX * sizeof(csv_row_t));
+    while (csv_rows != NULL && csv_count < AIM_REPLAY_CSV_MAX && fgets(line, sizeof(line), in) != NULL)
+    {
+        csv_row_t *row = &csv_rows[csv_count];
+        fp64 yaw, pitch, distance;
+
+        //Header and comment lines do not parse
+        if (sscanf(line, "%lf,%d,%lf,%lf,%lf", &row->t, &row->valid, &yaw, &pitch, &distance) != 5)
+        {
+            continue;
+        }
+        row->position[0] = distance * cos(pitch) * cos(yaw);
+        row->position[1] = distance * cos(pitch) * sin(yaw);
+        row->position[2] = distance * sin(pitch);
+        csv_count++;
+    }
+    fclose(in);
+    if (csv_count < 2)
+    {
+        fprintf(stderr, "%s: fewer than two rows\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int arg = 1;
+
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2)
+    {
+        fp64 value = atof(argv[arg + 1]) * 1e-3;
+        if (strcmp(argv[arg], "-l") == 0)
+        {
+            latency_s = value;
+        }
+        else if (strcmp(argv[arg], "-j") == 0)
+        {
+            jitter_s = value;
+        }
+        else if (strcmp(argv[arg], "-n") == 0)
+        {
+            angle_noise = value;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (arg + 1 < argc || (arg < argc && argv[arg][0] == '-') || latency_s < 0.0 || jitter_s < 0.0)
+    {
+        fprintf(stderr, "usage: %s [-l ms] [-j ms] [-n mrad] [track.csv]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (arg < argc && !load_csv(argv[arg]))
+    {
+        return EXIT_FAILURE;
+    }
+
+    printf("latency %.0f ms + 0 ~ %.0f ms, angle noise %.1f mrad, range noise %.0f%%, %.0f m/s projectile\n\n",
+           latency_s * 1e3, jitter_s * 1e3, angle_noise * 1e3, AIM_REPLAY_RANGE_NOISE * 100, AIM_BULLET_SPEED);
+    printf("%-26s %-11s %10s %10s %10s %8s %8s\n", "scenario", "method", "rms_mm", "p95_mm", "max_mm", "hit%",
+           "aimed%");
+
+    int failed = 0;
+    for (replay_scenario_e s = 0; s < SCENARIO_NUM; s++)
+    {
+        if ((s == SCENARIO_CSV) != (csv_count > 0))
+        {
+            continue;
+        }
+        uint32_t ticks = s == SCENARIO_CSV ? (uint32_t)(csv_rows[csv_count - 1].t / AIM_REPLAY_TICK_S)
+                                           : AIM_REPLAY_TICKS;
+        if (run_scenario(s, ticks) > 1.0)
+        {
+            failed = 1;
+        }
+    }
+    free(csv_rows);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
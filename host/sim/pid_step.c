@@ -0,0 +1,228 @@
+/**
+  ******************************************************************************
+    * @file    host/sim/pid_step
+    * @date    16-October-2026
+    * @brief   Step responses of PID_Calc against PID_full_calc on the GM6020
+    *          pitch plant of plant.c, with a constant load torque so the
+    *          integrator has work to do. Feedback is quantised to the encoder
+    *          and carries +-1 count of noise. Each case prints the step metrics
+    *          and the mean command change per ms, which shows derivative noise
+    *          reaching the motor.
+    * @attention Cases:
+    *              rate     the same gains at a 1 kHz and a 500 Hz loop. PID_Calc
+    *                       gains are per sample, so its response changes with the
+    *                       rate; PID_full_calc takes dt and should not
+    *              windup   a step large enough to saturate the output, with no
+    *                       anti-windup, clamping and back calculation
+    *            The plant runs at 1 kHz, a slower loop holds its command.
+    *            PID_full_calc cases are held to settling, overshoot and steady
+    *            state bounds, its 500 Hz run to within STEP_DT_SETTLE_MS and
+    *            STEP_DT_OVERSHOOT_PCT of the 1 kHz one, back calculation to less
+    *            overshoot than no anti-windup, and its filtered derivative to less
+    *            command chatter than PID_Calc. PID_Calc is only reported.
+    *            Usage: pid_step [-v]   (-v dumps every trace as CSV)
+    *            Exits non-zero if a bound is missed, ctest runs it.
+  ******************************************************************************
+**/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pid.h"
+#include "plant.h"
+#include "sim_metrics.h"
+
+#define STEP_DURATION_MS 1500
+#define STEP_TWO_PI 6.283185307179586
+#define STEP_RAD_PER_ECD (STEP_TWO_PI / SIM_ECD_RANGE)
+//Load on the pitch axis, an unbalanced barrel
+#define STEP_LOAD_TORQUE 0.5
+//Steady state error bound of the checked cases, a few encoder counts
+#define STEP_MAX_SS_ERROR 0.005
+//dt invariance: the 500 Hz response against the 1 kHz one
+#define STEP_DT_SETTLE_MS 20.0
+#define STEP_DT_OVERSHOOT_PCT 2.0
+
+typedef enum
+{
+    STEP_LEGACY = 0,    //PID_Calc, gains per sample at 1 kHz
+    STEP_FULL,          //PID_full_calc
+} step_controller_e;
+
+typedef struct
+{
+    const char *name;
+    step_controller_e controller;
+    uint8_t period_ms;
+    fp32 step_rad;
+    uint8_t anti_windup;
+    fp64 max_settle_ms;         //bounds, 0 if the case is only reported
+    fp64 max_overshoot_pct;
+} step_case_t;
+
+typedef enum
+{
+    STEP_CALC_1K = 0,
+    STEP_CALC_500,
+    STEP_FULL_1K,
+    STEP_FULL_500,
+    STEP_WINDUP_NONE,
+    STEP_WINDUP_CLAMP,
+    STEP_WINDUP_BACK_CALC,
+    STEP_CASE_NUM,
+} step_case_e;
+
+//Gains in output LSB (GM6020 voltage command) per rad
+static const PidFullConfigTypeDef step_config = {
+    .Kp = 60000.0f,
+    .Ki = 300000.0f,
+    .Kd = 1200.0f,
+    .d_cutoff_hz = 60.0f,
+    .Kaw = 20.0f,
+    .anti_windup = PID_AW_BACK_CALC,
+    .max_out = 25000.0f,
+    .max_iout = 15000.0f,
+};
+
+static const step_case_t step_cases[STEP_CASE_NUM] = {
+    [STEP_CALC_1K] = {"PID_Calc 1 kHz", STEP_LEGACY, 1, 0.5f, 0, 0.0, 0.0},
+    [STEP_CALC_500] = {"PID_Calc 500 Hz", STEP_LEGACY, 2, 0.5f, 0, 0.0, 0.0},
+    [STEP_FULL_1K] = {"PID_full 1 kHz", STEP_FULL, 1, 0.5f, PID_AW_BACK_CALC, 600.0, 35.0},
+    [STEP_FULL_500] = {"PID_full 500 Hz", STEP_FULL, 2, 0.5f, PID_AW_BACK_CALC, 600.0, 35.0},
+    [STEP_WINDUP_NONE] = {"windup none", STEP_FULL, 1, 2.0f, PID_AW_NONE, 0.0, 0.0},
+    [STEP_WINDUP_CLAMP] = {"windup clamp", STEP_FULL, 1, 2.0f, PID_AW_CLAMP, 400.0, 15.0},
+    [STEP_WINDUP_BACK_CALC] = {"windup back calc", STEP_FULL, 1, 2.0f, PID_AW_BACK_CALC, 200.0, 5.0},
+};
+
+static sim_trace_t trace;
+static uint32_t noise_state;
+
+//Deterministic -1, 0 or +1 encoder counts
+static int32_t noise_ecd(void)
+{
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return (int32_t)(noise_state >> 30) % 3 - 1;
+}
+
+/**
+ * @brief  Runs one step case on a fresh plant
+ * @param  step: case to run
+ * @param  mean_dcmd: filled with the mean |command change| per ms
+ * @retval None
+ */
+static void step_run(const step_case_t *step, fp64 *mean_dcmd)
+{
+    static const uint16_t initial_ecd[SIM_MOTOR_NUM] = {0};
+    PidTypeDef legacy;
+    PidFullTypeDef full;
+    PidFullConfigTypeDef config = step_config;
+    fp32 dt = step->period_ms * 0.001f;
+    fp32 out = 0.0f;
+    fp64 dcmd_sum = 0.0;
+    int16_t last_cmd = 0;
+
+    //The old controller tuned at 1 kHz: Ki and Kd folded into per sample gains
+    const fp32 legacy_gains[3] = {step_config.Kp, step_config.Ki * 0.001f, step_config.Kd / 0.001f};
+    PID_Init(&legacy, PID_POSITION, legacy_gains, step_config.max_out, step_config.max_iout);
+    config.anti_windup = step->anti_windup;
+    PID_full_init(&full, &config);
+
+    sim_plant_init(initial_ecd);
+    sim_motor_t *motor = sim_plant_motor(SIM_PITCH);
+    motor->load_torque = STEP_LOAD_TORQUE;
+    noise_state = 1;
+    sim_trace_reset(&trace);
+
+    for (uint32_t ms = 0; ms < STEP_DURATION_MS; ms++)
+    {
+        if (ms % step->period_ms == 0)
+        {
+            fp32 measured = (fp32)((floor(motor->angle / STEP_RAD_PER_ECD + 0.5) + noise_ecd()) * STEP_RAD_PER_ECD);
+            if (step->controller == STEP_LEGACY)
+            {
+                out = PID_Calc(&legacy, measured, step->step_rad);
+            }
+            else
+            {
+                out = PID_full_calc(&full, measured, step->step_rad, 0.0f, 0.0f, dt);
+            }
+        }
+        motor->cmd = (int16_t)out;
+        dcmd_sum += fabs((fp64)motor->cmd - last_cmd);
+        last_cmd = motor->cmd;
+        sim_plant_step(0.001);
+        sim_trace_record(&trace, step->step_rad, motor->angle);
+    }
+    *mean_dcmd = dcmd_sum / STEP_DURATION_MS;
+}
+
+/**
+ * @brief  Prints a failed bound
+ * @retval 1 if cond failed
+ */
+static int step_check(int cond, const char *name, const char *what, fp64 value, fp64 bound)
+{
+    if (!cond)
+    {
+        printf("FAIL: %s %s %.2f, bound %.2f\n", name, what, value, bound);
+    }
+    return !cond;
+}
+
+int main(int argc, char **argv)
+{
+    int verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+    sim_step_metrics_t metrics[STEP_CASE_NUM];
+    fp64 mean_dcmd[STEP_CASE_NUM];
+    int failed = 0;
+
+    printf("%-18s %8s %10s %11s %12s %12s\n", "case", "step", "settle_ms", "overshoot%", "ss_error", "mean_dcmd");
+    for (int i = 0; i < STEP_CASE_NUM; i++)
+    {
+        const step_case_t *step = &step_cases[i];
+
+        step_run(step, &mean_dcmd[i]);
+        sim_step_metrics(&trace, &metrics[i]);
+        printf("%-18s %8.3f %10.0f %11.2f %12.5f %12.1f\n", step->name, step->step_rad, metrics[i].settling_ms,
+               metrics[i].overshoot_pct, metrics[i].steady_state_error, mean_dcmd[i]);
+        if (verbose)
+        {
+            printf("# %s\nt_ms,setpoint,output\n", step->name);
+            for (uint32_t n = 0; n < trace.len; n++)
+            {
+                printf("%u,%.6f,%.6f\n", n, trace.setpoint[n], trace.output[n]);
+            }
+        }
+    }
+
+    for (int i = 0; i < STEP_CASE_NUM; i++)
+    {
+        const step_case_t *step = &step_cases[i];
+        if (step->max_settle_ms == 0.0)
+        {
+            continue;
+        }
+        //settling_ms is negative if the response never settles
+        failed |= step_check(metrics[i].settling_ms >= 0.0 && metrics[i].settling_ms <= step->max_settle_ms,
+                             step->name, "settle ms", metrics[i].settling_ms, step->max_settle_ms);
+        failed |= step_check(metrics[i].overshoot_pct <= step->max_overshoot_pct, step->name, "overshoot %",
+                             metrics[i].overshoot_pct, step->max_overshoot_pct);
+        failed |= step_check(fabs(metrics[i].steady_state_error) <= STEP_MAX_SS_ERROR, step->name, "ss error",
+                             metrics[i].steady_state_error, STEP_MAX_SS_ERROR);
+    }
+    fp64 dt_settle = fabs(metrics[STEP_FULL_500].settling_ms - metrics[STEP_FULL_1K].settling_ms);
+    fp64 dt_overshoot = fabs(metrics[STEP_FULL_500].overshoot_pct - metrics[STEP_FULL_1K].overshoot_pct);
+    failed |= step_check(dt_settle <= STEP_DT_SETTLE_MS, "PID_full", "500 Hz vs 1 kHz settle ms", dt_settle,
+                         STEP_DT_SETTLE_MS);
+    failed |= step_check(dt_overshoot <= STEP_DT_OVERSHOOT_PCT, "PID_full", "500 Hz vs 1 kHz overshoot %",
+                         dt_overshoot, STEP_DT_OVERSHOOT_PCT);
+    failed |= step_check(metrics[STEP_WINDUP_BACK_CALC].overshoot_pct < metrics[STEP_WINDUP_NONE].overshoot_pct,
+                         "windup back calc", "overshoot % against none", metrics[STEP_WINDUP_BACK_CALC].overshoot_pct,
+                         metrics[STEP_WINDUP_NONE].overshoot_pct);
+    failed |= step_check(mean_dcmd[STEP_FULL_1K] < mean_dcmd[STEP_CALC_1K], "PID_full 1 kHz",
+                         "mean_dcmd against PID_Calc", mean_dcmd[STEP_FULL_1K], mean_dcmd[STEP_CALC_1K]);
+
+    printf("%s\n", failed ? "FAILED" : "PASS");
+    return failed;
+}
@@ -0,0 +1,355 @@
+/**
+  ******************************************************************************
+    * @file    host/sim/plant
+    * @date    16-October-2026
+    * @brief   Deterministic plant model of the eight CAN motors, see plant.h
+  ******************************************************************************
+**/
+
+#include "plant.h"
+#include "hal_host.h"
+#include "CAN_receive.h"
+#include "INS_task.h"
+#include "mecanum.h"
+#include "bsp_host.h"
+#include <math.h>
+
+#define SIM_SUBSTEPS 10
+#define SIM_TWO_PI 6.283185307179586
+#define SIM_RAD_S_TO_RPM (60.0 / SIM_TWO_PI)
+
+//Firmware interrupt handlers, normally reached through the vector table
+extern void CAN1_RX0_IRQHandler(void);
+extern void CAN2_RX0_IRQHandler(void);
+extern void CAN1_TX_IRQHandler(void);
+extern void CAN2_TX_IRQHandler(void);
+
+//M3508 + C620: 16384 = 20 A, 0.3 Nm/A and 482 rpm at the 3591/187 gearbox output.
+//Load is a quarter of a 15 kg robot on 76 mm wheels plus the wheel itself.
+const sim_motor_params_t sim_m3508_params = {
+    .drive = SIM_DRIVE_CURRENT,
+    .gear_ratio = 3591.0 / 187.0,
+    .cmd_per_unit = 16384.0 / 20.0,
+    .current_lsb = 16384.0 / 20.0,
+    .kt = 0.3,
+    .no_load_speed = 482.0 / SIM_RAD_S_TO_RPM,
+    .inertia = 0.024,
+    .viscous = 0.005,
+    .coulomb = 0.06,
+    .cmd_max = 16384,
+};
+
+//GM6020: 30000 = 24 V, 0.741 Nm/A, 1.8 ohm, 320 rpm no load at 24 V, direct drive
+const sim_motor_params_t sim_gm6020_yaw_params = {
+    .drive = SIM_DRIVE_VOLTAGE,
+    .gear_ratio = 1.0,
+    .cmd_per_unit = 30000.0 / 24.0,
+    .current_lsb = 16384.0 / 3.0,
+    .kt = 0.741,
+    .ke = 24.0 / (320.0 / SIM_RAD_S_TO_RPM),
+    .resistance = 1.8,
+    .inertia = 0.035,
+    .viscous = 0.002,
+    .coulomb = 0.03,
+    .cmd_max = 30000,
+};
+
+const sim_motor_params_t sim_gm6020_pitch_params = {
+    .drive = SIM_DRIVE_VOLTAGE,
+    .gear_ratio = 1.0,
+    .cmd_per_unit = 30000.0 / 24.0,
+    .current_lsb = 16384.0 / 3.0,
+    .kt = 0.741,
+    .ke = 24.0 / (320.0 / SIM_RAD_S_TO_RPM),
+    .resistance = 1.8,
+    .inertia = 0.015,
+    .viscous = 0.002,
+    .coulomb = 0.05,
+    .cmd_max = 30000,
+};
+
+//P36 (M2006) + C610: 10000 = 10 A, 0.18 Nm/A and 500 rpm at the 36:1 output
+const sim_motor_params_t sim_p36_params = {
+    .drive = SIM_DRIVE_CURRENT,
+    .gear_ratio = 36.0,
+    .cmd_per_unit = 10000.0 / 10.0,
+    .current_lsb = 10000.0 / 10.0,
+    .kt = 0.18,
+    .no_load_speed = 500.0 / SIM_RAD_S_TO_RPM,
+    .inertia = 0.0015,
+    .viscous = 0.002,
+    .coulomb = 0.05,
+    .cmd_max = 10000,
+};
+
+static sim_motor_t motors[SIM_MOTOR_NUM];
+static sim_body_t body;
+
+
+void sim_plant_init(const uint16_t initial_ecd[SIM_MOTOR_NUM])
+{
+    for (int i = 0; i < SIM_MOTOR_NUM; i++)
+    {
+        sim_motor_t *motor = &motors[i];
+        if (i <= SIM_CHASSIS_M4)
+        {
+            motor->params = &sim_m3508_params;
+        }
+        else if (i == SIM_YAW)
+        {
+            motor->params = &sim_gm6020_yaw_params;
+        }
+        else if (i == SIM_PITCH)
+        {
+            motor->params = &sim_gm6020_pitch_params;
+        }
+        else
+        {
+            motor->params = &sim_p36_params;
+        }
+        motor->angle = initial_ecd[i] * SIM_TWO_PI / SIM_ECD_RANGE / motor->params->gear_ratio;
+        motor->velocity = 0.0;
+        motor->current = 0.0;
+        motor->load_torque = 0.0;
+        motor->frame_accel = 0.0;
+        motor->cmd = 0;
+        motor->cmd_count = 0;
+    }
+    body.yaw = 0.0;
+    body.rate = 0.0;
+}
+
+sim_motor_t *sim_plant_motor(sim_motor_e motor)
+{
+    return &motors[motor];
+}
+
+uint16_t sim_motor_ecd(const sim_motor_t *motor)
+{
+    fp64 rotor_turns = motor->angle * motor->params->gear_ratio / SIM_TWO_PI;
+    fp64 frac = rotor_turns - floor(rotor_turns);
+    return (uint16_t)(frac * SIM_ECD_RANGE) & (SIM_ECD_RANGE - 1);
+}
+
+fp64 sim_motor_rotor_rpm(const sim_motor_t *motor)
+{
+    return motor->velocity * motor->params->gear_ratio * SIM_RAD_S_TO_RPM;
+}
+
+const sim_body_t *sim_plant_body(void)
+{
+    return &body;
+}
+
+static fp64 wrap_pi(fp64 angle)
+{
+    angle = fmod(angle, SIM_TWO_PI);
+    if (angle > SIM_TWO_PI / 2)
+    {
+        angle -= SIM_TWO_PI;
+    }
+    else if (angle <= -SIM_TWO_PI / 2)
+    {
+        angle += SIM_TWO_PI;
+    }
+    return angle;
+}
+
+fp64 sim_plant_imu_yaw(void)
+{
+    return wrap_pi(body.yaw + motors[SIM_YAW].angle + SIM_IMU_YAW_OFFSET);
+}
+
+
+/******************** IMU ********************/
+
+void sim_plant_publish_imu(void)
+{
+    fp32 *angle = bsp_host_INS_angle();
+    fp32 *gyro = bsp_host_INS_gyro();
+
+    //The board sits on the pitch stage, the body only turns about z
+    angle[INS_YAW_ADDRESS_OFFSET] = (fp32)sim_plant_imu_yaw();
+    angle[INS_PITCH_ADDRESS_OFFSET] = (fp32)wrap_pi(motors[SIM_PITCH].angle + SIM_IMU_PITCH_OFFSET);
+    angle[INS_ROLL_ADDRESS_OFFSET] = 0.0f;
+    //Yaw about z, then pitch about y, as get_angle reads them back
+    fp64 half_yaw = 0.5 * angle[INS_YAW_ADDRESS_OFFSET];
+    fp64 half_pitch = 0.5 * angle[INS_PITCH_ADDRESS_OFFSET];
+    fp32 *quat = bsp_host_INS_quat();
+    quat[0] = (fp32)(cos(half_yaw) * cos(half_pitch));
+    quat[1] = (fp32)(-sin(half_yaw) * sin(half_pitch));
+    quat[2] = (fp32)(cos(half_yaw) * sin(half_pitch));
+    quat[3] = (fp32)(sin(half_yaw) * cos(half_pitch));
+    gyro[INS_GYRO_X_ADDRESS_OFFSET] = 0.0f;
+    gyro[INS_GYRO_Y_ADDRESS_OFFSET] = (fp32)motors[SIM_PITCH].velocity;
+    gyro[INS_GYRO_Z_ADDRESS_OFFSET] = (fp32)(body.rate + motors[SIM_YAW].velocity);
+}
+
+
+/******************** CAN ********************/
+
+void sim_plant_publish_feedback(void)
+{
+    for (int i = 0; i < SIM_MOTOR_NUM; i++)
+    {
+        const sim_motor_t *motor = &motors[i];
+        hal_can_frame_t frame;
+        uint16_t ecd = sim_motor_ecd(motor);
+        int16_t rpm = (int16_t)lround(sim_motor_rotor_rpm(motor));
+        int16_t current = (int16_t)lround(motor->current * motor->params->current_lsb);
+
+        frame.std_id = CAN_3508_M1_ID + i;
+        frame.dlc = 8;
+        frame.data[0] = ecd >> 8;
+        frame.data[1] = ecd;
+        frame.data[2] = (uint16_t)rpm >> 8;
+        frame.data[3] = rpm;
+        frame.data[4] = (uint16_t)current >> 8;
+        frame.data[5] = current;
+        frame.data[6] = 30;
+        frame.data[7] = 0;
+
+        //Chassis motors are on CHASSIS_CAN, everything else on GIMBAL_CAN
+        if (i <= SIM_CHASSIS_M4)
+        {
+            hal_host_can_push_rx(CHASSIS_CAN, &frame);
+            CAN2_RX0_IRQHandler();
+        }
+        else
+        {
+            hal_host_can_push_rx(GIMBAL_CAN, &frame);
+            CAN1_RX0_IRQHandler();
+        }
+    }
+}
+
+static void decode_commands(const hal_can_frame_t *frame, sim_motor_e first)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        sim_motor_t *motor = &motors[first + i];
+        motor->cmd = (int16_t)(frame->data[2 * i] << 8 | frame->data[2 * i + 1]);
+        motor->cmd_count++;
+    }
+}
+
+void sim_plant_apply_commands(void)
+{
+    hal_can_frame_t frame;
+
+    for (hal_can_e can = HAL_CAN1; can < HAL_CAN_NUM; can++)
+    {
+        while (hal_host_can_pop_tx(can, &frame))
+        {
+            if (frame.std_id == CAN_CHASSIS_ALL_ID && can == CHASSIS_CAN)
+            {
+                decode_commands(&frame, SIM_CHASSIS_M1);
+            }
+            else if (frame.std_id == CAN_GIMBAL_ALL_ID && can == GIMBAL_CAN)
+            {
+                decode_commands(&frame, SIM_YAW);
+            }
+
+            //Mailbox freed, let the firmware refill it from its queue
+            if (hal_host_can_tx_irq_enabled(can))
+            {
+                if (can == HAL_CAN1)
+                {
+                    CAN1_TX_IRQHandler();
+                }
+                else
+                {
+                    CAN2_TX_IRQHandler();
+                }
+            }
+        }
+    }
+}
+
+
+/******************** Dynamics ********************/
+
+static fp64 clamp(fp64 value, fp64 limit)
+{
+    return value > limit ? limit : (value < -limit ? -limit : value);
+}
+
+static void motor_step(sim_motor_t *motor, fp64 dt)
+{
+    const sim_motor_params_t *p = motor->params;
+    fp64 cmd = clamp(motor->cmd, p->cmd_max);
+    fp64 drive_torque;
+
+    if (p->drive == SIM_DRIVE_VOLTAGE)
+    {
+        fp64 voltage = cmd / p->cmd_per_unit;
+        motor->current = (voltage - p->ke * motor->velocity) / p->resistance;
+        drive_torque = p->kt * motor->current;
+    }
+    else
+    {
+        //The ESC holds the current until the back EMF eats the supply headroom
+        fp64 headroom = 1.0 - fabs(motor->velocity) / p->no_load_speed;
+        motor->current = cmd / p->cmd_per_unit;
+        if (motor->current * motor->velocity > 0.0)
+        {
+            motor->current *= headroom > 0.0 ? headroom : 0.0;
+        }
+        drive_torque = p->kt * motor->current;
+    }
+
+    //Turning the body under the shaft takes the inertia along with it, or leaves it behind
+    fp64 torque = drive_torque + motor->load_torque - p->viscous * motor->velocity - p->inertia * motor->frame_accel;
+
+    //Coulomb friction with stiction, the shaft stays put until the torque breaks it loose
+    if (fabs(motor->velocity) < 1e-6 && fabs(torque) <= p->coulomb)
+    {
+        motor->velocity = 0.0;
+        return;
+    }
+    fp64 friction_dir = fabs(motor->velocity) > 1e-6 ? (motor->velocity > 0.0 ? 1.0 : -1.0) : (torque > 0.0 ? 1.0 : -1.0);
+    fp64 new_velocity = motor->velocity + (torque - p->coulomb * friction_dir) / p->inertia * dt;
+
+    //Friction can stop the shaft but never reverse it within one step
+    if (motor->velocity * new_velocity < 0.0 &&
+        fabs(drive_torque + motor->load_torque - p->inertia * motor->frame_accel) <= p->coulomb)
+    {
+        new_velocity = 0.0;
+    }
+    motor->velocity = new_velocity;
+    motor->angle += motor->velocity * dt;
+}
+
+/**
+ * @brief  Body yaw rate the wheels turn it at, through the firmware's mecanum_forward
+ *         with the rotor rpm in thousandths so wz comes out in urad/s
+ * @retval rad/s
+ */
+static fp64 body_rate_from_wheels(void)
+{
+    int32_t wheel_milli_rpm[MECANUM_WHEEL_NUM];
+    mecanum_body_t wheel_body;
+
+    for (int i = 0; i < MECANUM_WHEEL_NUM; i++)
+    {
+        wheel_milli_rpm[i] = (int32_t)lround(sim_motor_rotor_rpm(&motors[SIM_CHASSIS_M1 + i]) * 1000.0);
+    }
+    mecanum_forward(wheel_milli_rpm, &wheel_body);
+    return wheel_body.wz * 1e-6;
+}
+
+void sim_plant_step(fp64 dt)
+{
+    fp64 sub_dt = dt / SIM_SUBSTEPS;
+    for (int s = 0; s < SIM_SUBSTEPS; s++)
+    {
+        for (int i = 0; i < SIM_MOTOR_NUM; i++)
+        {
+            motor_step(&motors[i], sub_dt);
+        }
+        fp64 rate = body_rate_from_wheels();
+        motors[SIM_YAW].frame_accel = (rate - body.rate) / sub_dt;
+        body.yaw += (body.rate + rate) / 2.0 * sub_dt;
+        body.rate = rate;
+    }
+}
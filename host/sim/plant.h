@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+    * @file    host/sim/plant
+    * @date    16-October-2026
+    * @brief   Deterministic plant model of the eight CAN motors on the robot.
+    *          Each motor is a rigid output shaft with inertia, viscous and Coulomb
+    *          friction, driven through its gearbox by either a current-controlled
+    *          ESC (C620/M3508, C610/P36) or a voltage-controlled GM6020.
+    *          Feedback frames are encoded exactly like the motor ESCs do and are
+    *          pushed through the HAL into CAN1/CAN2_RX0_IRQHandler, so the firmware
+    *          sees them through CAN_hook. Commands are decoded from the 0x200 and
+    *          0x1FF frames the firmware transmits.
+    * @attention The chassis wheels are modelled independently (no body coupling),
+    *          each carrying a quarter of the robot inertia. The body only turns:
+    *          its yaw rate is read off the wheel speeds through the mecanum
+    *          forward kinematics and the yaw motor, mounted on the body, feels
+    *          its angular acceleration. The IMU sits on the pitch stage.
+  ******************************************************************************
+**/
+
+#ifndef SIM_PLANT_H
+#define SIM_PLANT_H
+#include "main.h"
+
+//Rotor encoder resolution, ecd runs 0 ~ 8191
+#define SIM_ECD_RANGE 8192
+//IMU angle of the gimbal at body yaw 0 and zero motor angles, rad. The AHRS heading at
+//boot is arbitrary and the IMU pitch is level where the pitch encoder is not
+#define SIM_IMU_YAW_OFFSET -4.0
+#define SIM_IMU_PITCH_OFFSET -2.3
+
+//Motor slots, in CAN receive ID order 0x201 ~ 0x208
+typedef enum
+{
+    SIM_CHASSIS_M1 = 0,
+    SIM_CHASSIS_M2,
+    SIM_CHASSIS_M3,
+    SIM_CHASSIS_M4,
+    SIM_YAW,
+    SIM_PITCH,
+    SIM_TRIGGER,
+    SIM_HOPPER,
+    SIM_MOTOR_NUM,
+} sim_motor_e;
+
+typedef enum
+{
+    SIM_DRIVE_CURRENT,  //command is a current setpoint, C620 / C610
+    SIM_DRIVE_VOLTAGE,  //command is a voltage, GM6020
+} sim_drive_e;
+
+typedef struct
+{
+    sim_drive_e drive;
+    fp64 gear_ratio;        //rotor turns per output turn
+    fp64 cmd_per_unit;      //command LSB per amp (current drive) or per volt (voltage drive)
+    fp64 current_lsb;       //feedback current LSB per amp
+    fp64 kt;                //torque constant at the output shaft, Nm/A
+    fp64 ke;                //back-EMF constant at the output shaft, V.s/rad (voltage drive)
+    fp64 resistance;        //winding resistance, ohm (voltage drive)
+    fp64 no_load_speed;     //output shaft speed where a current drive runs out of voltage, rad/s
+    fp64 inertia;           //motor + load inertia at the output shaft, kg.m^2
+    fp64 viscous;           //Nm.s/rad
+    fp64 coulomb;           //Nm
+    int16_t cmd_max;
+} sim_motor_params_t;
+
+typedef struct
+{
+    const sim_motor_params_t *params;
+    fp64 angle;             //output shaft angle, rad, not wrapped
+    fp64 velocity;          //output shaft speed, rad/s
+    fp64 current;           //A
+    fp64 load_torque;       //external disturbance, Nm
+    fp64 frame_accel;       //angular acceleration of the body the motor is mounted on, rad/s^2
+    int16_t cmd;            //last command received over CAN
+    uint32_t cmd_count;
+} sim_motor_t;
+
+//Chassis body, rotation only
+typedef struct
+{
+    fp64 yaw;               //rad, not wrapped, counter clockwise seen from above
+    fp64 rate;              //rad/s
+} sim_body_t;
+
+extern const sim_motor_params_t sim_m3508_params;
+extern const sim_motor_params_t sim_gm6020_yaw_params;
+extern const sim_motor_params_t sim_gm6020_pitch_params;
+extern const sim_motor_params_t sim_p36_params;
+
+//Resets every motor to rest with its rotor encoder at initial_ecd[i]
+extern void sim_plant_init(const uint16_t initial_ecd[SIM_MOTOR_NUM]);
+extern sim_motor_t *sim_plant_motor(sim_motor_e motor);
+extern const sim_body_t *sim_plant_body(void);
+//Gimbal yaw as the IMU reports it, wrapped to -PI ~ PI
+extern fp64 sim_plant_imu_yaw(void);
+//Sends one feedback frame per motor through the CAN receive interrupts
+extern void sim_plant_publish_feedback(void);
+//Writes the gimbal angles and rates to the INS readings the firmware sees, ideal IMU
+extern void sim_plant_publish_imu(void);
+//Reads the commands the firmware transmitted since the last call
+extern void sim_plant_apply_commands(void);
+//Integrates the motors over dt seconds
+extern void sim_plant_step(fp64 dt);
+
+//Rotor encoder count and rotor speed, as the ESC reports them
+extern uint16_t sim_motor_ecd(const sim_motor_t *motor);
+extern fp64 sim_motor_rotor_rpm(const sim_motor_t *motor);
+
+#endif
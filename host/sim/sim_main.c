@@ -0,0 +1,542 @@
+/**
+  ******************************************************************************
+    * @file    host/sim/sim_main
+    * @date    16-October-2026
+    * @brief   Closed loop simulation of the chassis, gimbal and shoot control loops
+    *          against the plant model in plant.c. Runs the unmodified task loop
+    *          functions on a simulated 1 ms tick, drives them with SBUS frames
+    *          through the USART1 interrupt, and reports step response metrics and
+    *          the host CPU cost of every loop.
+    * @attention Everything is stepped in a fixed order from a single thread, so two
+    *          runs produce identical traces; only the CPU timings vary.
+    *          Exits non-zero if a scenario misses its bounds in scenarios[], or
+    *          if the chassis spin slows the yaw step by more than
+    *          SIM_SPIN_MAX_EXTRA_SETTLE_MS, ctest runs it.
+    *          Usage: infantry_sim [-v] [-t file] [-T file]
+    *              -v       dumps every trace as CSV on stdout
+    *              -t file  writes the USART6 telemetry stream to file, decode it
+    *                       with telemetry_decode
+    *              -T file  writes the TRACE ring at the end of the run, decode it
+    *                       with trace_decode infantry_sim file
+  ******************************************************************************
+**/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hal_host.h"
+#include "CAN_receive.h"
+#include "control_tick.h"
+#include "USART_comms.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "trig_lut.h"
+#include "remote_control.h"
+#include "chassis_task.h"
+#include "gimbal_task.h"
+#include "shoot_task.h"
+#include "plant.h"
+#include "sim_metrics.h"
+
+//DBUS receivers deliver a frame every 14 ms
+#define SIM_RC_PERIOD_MS 14
+//The chassis spin may slow the world frame yaw step by this much over the still chassis
+#define SIM_SPIN_MAX_EXTRA_SETTLE_MS 100.0
+
+//Firmware interrupt handlers, normally reached through the vector table
+extern void USART1_IRQHandler(void);
+extern void TIM4_IRQHandler(void);
+extern void DMA2_Stream6_IRQHandler(void);
+//Gimbal state lives in gimbal_task.c without a getter
+extern Gimbal_t gimbal;
+
+typedef struct
+{
+    int16_t ch[4];
+    int16_t dial;
+    uint8_t s[2];
+} sim_rc_t;
+
+typedef enum
+{
+    SIM_SCENARIO_CHASSIS_SPEED = 0,
+    SIM_SCENARIO_PITCH_STEP,
+    SIM_SCENARIO_YAW_STEP,
+    SIM_SCENARIO_TRIGGER_SPEED,
+    SIM_SCENARIO_YAW_SPIN,
+    SIM_SCENARIO_NUM,
+} sim_scenario_e;
+
+typedef struct
+{
+    const char *name;
+    const char *unit;
+    uint32_t duration_ms;
+    uint16_t initial_ecd[SIM_MOTOR_NUM];
+    //Pass bounds in the scenario's unit, max_settle_ms 0 if the scenario is only reported
+    fp64 max_settle_ms;
+    fp64 max_overshoot_pct;
+    fp64 max_ss_error;
+} sim_scenario_t;
+
+//The chassis wheel and trigger speed loops do not settle against the model with the
+//robot's gains yet, so those two are only reported
+static const sim_scenario_t scenarios[SIM_SCENARIO_NUM] = {
+    [SIM_SCENARIO_CHASSIS_SPEED] = {"chassis front left speed", "rpm", 1500,
+                                    {0, 0, 0, 0, 6144, 3000, 0, 0}, 0.0, 0.0, 0.0},
+    [SIM_SCENARIO_PITCH_STEP] = {"pitch position step", "ecd", 1500,
+                                 {0, 0, 0, 0, 6144, 2500, 0, 0}, 300.0, 5.0, 8.0},
+    [SIM_SCENARIO_YAW_STEP] = {"yaw rc step", "rad", 1500,
+                               {0, 0, 0, 0, 6144, 3000, 0, 0}, 350.0, 5.0, 0.005},
+    [SIM_SCENARIO_TRIGGER_SPEED] = {"trigger speed", "rpm", 1500,
+                                    {0, 0, 0, 0, 6144, 3000, 0, 0}, 0.0, 0.0, 0.0},
+    [SIM_SCENARIO_YAW_SPIN] = {"yaw rc step, chassis spin", "rad", 1500,
+                               {0, 0, 0, 0, 6144, 3000, 0, 0}, 400.0, 5.0, 0.005},
+};
+
+static sim_trace_t trace;
+static sim_cpu_stat_t cpu_gimbal, cpu_shoot, cpu_chassis;
+//Host task handles: notification counts given by the control tick
+static uint32_t task_notify[CONTROL_TICK_TASK_NUM];
+//USART6 capture given with -t, NULL discards the stream
+static FILE *telemetry_file;
+
+static void capture_telemetry(void);
+
+/**
+ * @brief  Prints a missed bound
+ * @retval 1 if cond failed
+ */
+static int sim_check(int cond, const char *name, const char *what, fp64 value, fp64 bound)
+{
+    if (!cond)
+    {
+        printf("FAIL: %s %s %.4f, bound %.4f\n", name, what, value, bound);
+    }
+    return !cond;
+}
+
+
+/**
+ * @brief  Packs stick and switch positions into an 18 byte DBUS frame and feeds it
+ *         through the USART1 DMA + IDLE interrupt path
+ * @param  rc stick values (-660 ~ 660) and switch positions
+ * @retval None
+ */
+static void sim_send_rc(const sim_rc_t *rc)
+{
+    uint8_t frame[RC_FRAME_LENGTH] = {0};
+    uint64_t bits = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        bits |= (uint64_t)((rc->ch[i] + RC_CH_VALUE_OFFSET) & 0x07FF) << (11 * i);
+    }
+    bits |= (uint64_t)(rc->s[0] & 0x03) << 44;
+    bits |= (uint64_t)(rc->s[1] & 0x03) << 46;
+    for (int i = 0; i < 6; i++)
+    {
+        frame[i] = bits >> (8 * i);
+    }
+    //Channel 4 is the dial
+    frame[16] = (rc->dial + RC_CH_VALUE_OFFSET) & 0xFF;
+    frame[17] = (rc->dial + RC_CH_VALUE_OFFSET) >> 8;
+
+    hal_host_uart_dma_write(HAL_USART1, frame, sizeof(frame));
+    USART1_IRQHandler();
+}
+
+/**
+ * @brief  Remote control input of a scenario at time t
+ * @param  scenario scenario being run
+ * @param  t_ms simulated time since the scenario started
+ * @param  rc filled with the stick and switch positions
+ * @retval None
+ */
+static void scenario_rc(sim_scenario_e scenario, uint32_t t_ms, sim_rc_t *rc)
+{
+    memset(rc, 0, sizeof(*rc));
+    switch (scenario)
+    {
+    case SIM_SCENARIO_CHASSIS_SPEED:
+        //Full drive, half stick forward
+        rc->s[RC_SWITCH_RIGHT] = RC_SW_DOWN;
+        rc->s[RC_SWITCH_LEFT] = RC_SW_DOWN;
+        rc->ch[1] = 330;
+        break;
+    case SIM_SCENARIO_PITCH_STEP:
+        //Pitch setpoint holds GIMBAL_PITCH_INITIAL_POSITION, the plant starts away from it
+        rc->s[RC_SWITCH_RIGHT] = RC_SW_DOWN;
+        rc->s[RC_SWITCH_LEFT] = RC_SW_DOWN;
+        break;
+    case SIM_SCENARIO_YAW_STEP:
+        //Gimbal mode, full yaw stick for 56 ms (four DBUS frames)
+        rc->s[RC_SWITCH_RIGHT] = RC_SW_MID;
+        rc->s[RC_SWITCH_LEFT] = RC_SW_DOWN;
+        rc->ch[2] = t_ms < 4 * SIM_RC_PERIOD_MS ? 660 : 0;
+        break;
+    case SIM_SCENARIO_TRIGGER_SPEED:
+        //Launcher powered, shoot ready
+        rc->s[POWER_SWITCH] = RC_SW_UP;
+        rc->s[SHOOT_SWITCH] = RC_SW_MID;
+        break;
+    case SIM_SCENARIO_YAW_SPIN:
+        //The yaw rc step while the chassis spins under the gimbal from the start
+        rc->s[RC_SWITCH_RIGHT] = RC_SW_MID;
+        rc->s[RC_SWITCH_LEFT] = RC_SW_DOWN;
+        rc->ch[2] = t_ms < 4 * SIM_RC_PERIOD_MS ? 660 : 0;
+        rc->dial = 660;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief  Setpoint and measured output of a scenario, in the scenario's unit
+ * @param  scenario scenario being run
+ * @param  setpoint filled with the controller setpoint
+ * @param  output filled with the plant output
+ * @retval None
+ */
+static void scenario_sample(sim_scenario_e scenario, fp64 *setpoint, fp64 *output)
+{
+    const Chassis_t *chassis = get_chassis_point();
+    const Shoot_t *launcher = get_launcher_pointer();
+
+    switch (scenario)
+    {
+    case SIM_SCENARIO_CHASSIS_SPEED:
+        *setpoint = chassis->motor[FRONT_LEFT].speed_set;
+        *output = sim_motor_rotor_rpm(sim_plant_motor(SIM_CHASSIS_M1 + FRONT_LEFT));
+        break;
+    case SIM_SCENARIO_PITCH_STEP:
+        *setpoint = gimbal.pitch_motor.pos_set;
+        *output = sim_motor_ecd(sim_plant_motor(SIM_PITCH));
+        break;
+    case SIM_SCENARIO_YAW_STEP:
+    case SIM_SCENARIO_YAW_SPIN:
+        //World frame hold, both in the IMU frame
+        *setpoint = atan2(gimbal.yaw_world_setpoint[1], gimbal.yaw_world_setpoint[0]);
+        *output = sim_plant_imu_yaw();
+        break;
+    case SIM_SCENARIO_TRIGGER_SPEED:
+        *setpoint = launcher->trigger_motor.speed_set;
+        *output = sim_motor_rotor_rpm(sim_plant_motor(SIM_TRIGGER));
+        break;
+    default:
+        *setpoint = 0.0;
+        *output = 0.0;
+        break;
+    }
+}
+
+/**
+ * @brief  Runs one scenario from a cold start. The task init delays are skipped,
+ *         the control tick releases the loops at their firmware periods and sends
+ *         their commands at the transmit phase, as TIM4 does on the robot.
+ * @param  scenario scenario to run
+ * @retval None
+ */
+static void run_scenario(sim_scenario_e scenario)
+{
+    const sim_scenario_t *desc = &scenarios[scenario];
+    sim_rc_t rc;
+
+    hal_host_reset();
+    CAN_receive_init();
+    CAN_update_filters();
+    control_tick_init();
+    remote_control_init();
+    sim_plant_init(desc->initial_ecd);
+    sim_trace_reset(&trace);
+
+    //Valid feedback and RC before the tasks latch their pointers
+    scenario_rc(scenario, 0, &rc);
+    sim_send_rc(&rc);
+    sim_plant_publish_feedback();
+    sim_plant_publish_imu();
+    shoot_task_init();
+    gimbal_task_init();
+    chassis_task_init();
+    memset(task_notify, 0, sizeof(task_notify));
+    control_tick_register_task(CONTROL_TICK_GIMBAL, &task_notify[CONTROL_TICK_GIMBAL], GIMBAL_TASK_DELAY);
+    control_tick_register_task(CONTROL_TICK_SHOOT, &task_notify[CONTROL_TICK_SHOOT], SHOOT_TASK_DELAY);
+    control_tick_register_task(CONTROL_TICK_CHASSIS, &task_notify[CONTROL_TICK_CHASSIS], CHASSIS_TASK_DELAY);
+
+    for (uint32_t t = 0; t < desc->duration_ms; t++)
+    {
+        if (t % SIM_RC_PERIOD_MS == 0)
+        {
+            scenario_rc(scenario, t, &rc);
+            sim_send_rc(&rc);
+        }
+        sim_plant_publish_feedback();
+        sim_plant_publish_imu();
+
+        //Tick: latch feedback, release the tasks due, run them in priority order
+        hal_host_timer_fire(HAL_TIMER_CONTROL_TICK);
+        TIM4_IRQHandler();
+        if (task_notify[CONTROL_TICK_SHOOT])
+        {
+            task_notify[CONTROL_TICK_SHOOT] = 0;
+            control_tick_wait(CONTROL_TICK_SHOOT);
+            sim_cpu_stat_call(&cpu_shoot, shoot_task_loop);
+        }
+        if (task_notify[CONTROL_TICK_CHASSIS])
+        {
+            task_notify[CONTROL_TICK_CHASSIS] = 0;
+            control_tick_wait(CONTROL_TICK_CHASSIS);
+            sim_cpu_stat_call(&cpu_chassis, chassis_task_loop);
+        }
+        if (task_notify[CONTROL_TICK_GIMBAL])
+        {
+            task_notify[CONTROL_TICK_GIMBAL] = 0;
+            control_tick_wait(CONTROL_TICK_GIMBAL);
+            sim_cpu_stat_call(&cpu_gimbal, gimbal_task_loop);
+        }
+
+        //Transmit phase
+        hal_host_cycle_advance(CONTROL_TICK_TX_OFFSET_US * HAL_CYCLES_PER_US);
+        hal_host_timer_fire_compare(HAL_TIMER_CONTROL_TICK);
+        TIM4_IRQHandler();
+
+        sim_plant_apply_commands();
+        //Log DMA, one ring chunk per ms
+        if (hal_host_uart_dma_tx_finish(HAL_USART6))
+        {
+            DMA2_Stream6_IRQHandler();
+        }
+        capture_telemetry();
+        sim_plant_step(0.001);
+        vTaskDelay(1);
+
+        fp64 setpoint, output;
+        scenario_sample(scenario, &setpoint, &output);
+        sim_trace_record(&trace, setpoint, output);
+    }
+}
+
+/**
+ * @brief  Moves the bytes sent on USART6 to the capture file, if one was given
+ * @param  None
+ * @retval None
+ */
+static void capture_telemetry(void)
+{
+    uint8_t buf[256];
+    uint16_t len;
+
+    while ((len = hal_host_uart_read_tx(HAL_USART6, buf, sizeof(buf))) > 0)
+    {
+        if (telemetry_file != NULL)
+        {
+            fwrite(buf, 1, len, telemetry_file);
+        }
+    }
+}
+
+static void print_trace(const char *name)
+{
+    printf("# %s\nt_ms,setpoint,output\n", name);
+    for (uint32_t i = 0; i < trace.len; i++)
+    {
+        printf("%u,%.6f,%.6f\n", i, trace.setpoint[i], trace.output[i]);
+    }
+}
+
+static void print_cpu(const sim_cpu_stat_t *stat)
+{
+    if (stat->calls == 0)
+    {
+        return;
+    }
+    printf("%-16s %10llu %10llu %10llu %10llu\n", stat->name,
+           (unsigned long long)stat->calls,
+           (unsigned long long)stat->min_ns,
+           (unsigned long long)(stat->total_ns / stat->calls),
+           (unsigned long long)stat->max_ns);
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t verbose = 0;
+    const char *trace_path = NULL;
+    sim_step_metrics_t metrics[SIM_SCENARIO_NUM];
+    uint64_t simulated_ms = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+        {
+            verbose = 1;
+        }
+        else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            telemetry_file = fopen(argv[++i], "wb");
+            if (telemetry_file == NULL)
+            {
+                perror(argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-v] [-t file] [-T file]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    trace_init();
+    trig_lut_init();
+    sim_cpu_stat_reset(&cpu_gimbal, "gimbal_loop");
+    sim_cpu_stat_reset(&cpu_shoot, "shoot_loop");
+    sim_cpu_stat_reset(&cpu_chassis, "chassis_loop");
+
+    uint64_t start = sim_now_ns();
+    for (sim_scenario_e s = 0; s < SIM_SCENARIO_NUM; s++)
+    {
+        run_scenario(s);
+        sim_step_metrics(&trace, &metrics[s]);
+        simulated_ms += scenarios[s].duration_ms;
+        if (verbose)
+        {
+            print_trace(scenarios[s].name);
+        }
+    }
+    fp64 wall_ms = (sim_now_ns() - start) / 1e6;
+
+    printf("%-26s %-4s %12s %12s %10s %11s %12s\n",
+           "scenario", "unit", "initial", "setpoint", "settle_ms", "overshoot%", "ss_error");
+    for (sim_scenario_e s = 0; s < SIM_SCENARIO_NUM; s++)
+    {
+        printf("%-26s %-4s %12.4f %12.4f %10.0f %11.2f %12.4f\n",
+               scenarios[s].name, scenarios[s].unit,
+               metrics[s].initial, metrics[s].final_setpoint, metrics[s].settling_ms,
+               metrics[s].overshoot_pct, metrics[s].steady_state_error);
+    }
+    int failed = 0;
+    for (sim_scenario_e s = 0; s < SIM_SCENARIO_NUM; s++)
+    {
+        const sim_scenario_t *desc = &scenarios[s];
+        if (desc->max_settle_ms == 0.0)
+        {
+            continue;
+        }
+        //settling_ms is negative if the output never settles
+        failed |= sim_check(metrics[s].settling_ms >= 0.0 && metrics[s].settling_ms <= desc->max_settle_ms,
+                            desc->name, "settle ms", metrics[s].settling_ms, desc->max_settle_ms);
+        failed |= sim_check(metrics[s].overshoot_pct <= desc->max_overshoot_pct, desc->name, "overshoot %",
+                            metrics[s].overshoot_pct, desc->max_overshoot_pct);
+        failed |= sim_check(fabs(metrics[s].steady_state_error) <= desc->max_ss_error, desc->name, "ss error",
+                            metrics[s].steady_state_error, desc->max_ss_error);
+    }
+    fp64 spin_extra_ms = metrics[SIM_SCENARIO_YAW_SPIN].settling_ms - metrics[SIM_SCENARIO_YAW_STEP].settling_ms;
+    failed |= sim_check(spin_extra_ms <= SIM_SPIN_MAX_EXTRA_SETTLE_MS, scenarios[SIM_SCENARIO_YAW_SPIN].name,
+                        "extra settle ms over the still chassis", spin_extra_ms, SIM_SPIN_MAX_EXTRA_SETTLE_MS);
+
+    printf("\n%-16s %10s %10s %10s %10s\n", "task", "calls", "min_ns", "avg_ns", "max_ns");
+    print_cpu(&cpu_gimbal);
+    print_cpu(&cpu_shoot);
+    print_cpu(&cpu_chassis);
+
+    printf("\n%-8s %10s %10s %12s\n", "can_id", "frames", "rate_hz", "max_gap_us");
+    for (can_msg_id_e id = CAN_3508_M1_ID; id <= CAN_HOPPER_MOTOR_ID; id++)
+    {
+        motor_rx_stats_t stats;
+        get_motor_rx_stats(id, &stats);
+        printf("0x%03X    %10u %10.1f %12u\n", id, stats.rx_count, stats.rate_hz,
+               stats.max_gap_cycles / HAL_CYCLES_PER_US);
+    }
+
+    printf("\n%-8s %12s %16s %10s %14s\n", "bus", "rx_irq_per_s", "frames_per_irq", "overruns", "max_irq_us");
+    for (hal_can_e can = HAL_CAN1; can < HAL_CAN_NUM; can++)
+    {
+        can_rx_bus_stats_t stats;
+        get_CAN_rx_bus_stats(can, &stats);
+        printf("CAN%u     %12.0f %16.2f %10u %14u\n", can + 1,
+               stats.irq_count * 1000.0 / scenarios[SIM_SCENARIO_NUM - 1].duration_ms,
+               stats.irq_count ? (fp64)stats.frame_count / stats.irq_count : 0.0,
+               stats.overrun_count[HAL_CAN_FIFO0] + stats.overrun_count[HAL_CAN_FIFO1],
+               stats.max_irq_cycles / HAL_CYCLES_PER_US);
+    }
+
+    printf("\n%-8s %10s %10s %10s %10s %10s\n", "bus", "tx_calls", "sent", "coalesced", "dropped", "max_depth");
+    for (hal_can_e can = HAL_CAN1; can < HAL_CAN_NUM; can++)
+    {
+        can_tx_stats_t stats;
+        get_CAN_tx_stats(can, &stats);
+        printf("CAN%u     %10u %10u %10u %10u %10u\n", can + 1, stats.requested, stats.sent,
+               stats.coalesced, stats.dropped, stats.max_depth);
+    }
+
+    static const char *const tick_task_name[CONTROL_TICK_TASK_NUM] = {"gimbal", "shoot", "chassis"};
+    static const uint32_t jitter_edges[CONTROL_TICK_JITTER_BINS - 1] = CONTROL_TICK_JITTER_EDGES_US;
+    printf("\n%-8s %10s %10s %10s %12s %14s   tx jitter histogram (us)\n", "task", "releases", "overruns",
+           "commands", "max_wake_us", "max_jitter_us");
+    for (control_tick_task_e task = CONTROL_TICK_GIMBAL; task < CONTROL_TICK_TASK_NUM; task++)
+    {
+        control_tick_task_stats_t stats;
+        get_control_tick_task_stats(task, &stats);
+        printf("%-8s %10u %10u %10u %12.2f %14.2f  ", tick_task_name[task], stats.releases, stats.overruns,
+               stats.commands_sent, (fp64)stats.max_wake_latency_cycles / HAL_CYCLES_PER_US,
+               (fp64)stats.max_tx_jitter_cycles / HAL_CYCLES_PER_US);
+        for (uint8_t bin = 0; bin < CONTROL_TICK_JITTER_BINS; bin++)
+        {
+            if (stats.tx_jitter_hist[bin])
+            {
+                if (bin < CONTROL_TICK_JITTER_BINS - 1)
+                {
+                    printf(" <%u:%u", jitter_edges[bin], stats.tx_jitter_hist[bin]);
+                }
+                else
+                {
+                    printf(" >=%u:%u", jitter_edges[bin - 1], stats.tx_jitter_hist[bin]);
+                }
+            }
+        }
+        printf("\n");
+    }
+
+    serial_tx_stats_t serial_stats;
+    get_serial_tx_stats(&serial_stats);
+    printf("\nUSART6 log: %u bytes queued, %u sent, %u dropped in %u writes, %u DMA errors, ring high water %u/%u\n",
+           serial_stats.bytes_queued, serial_stats.bytes_sent, serial_stats.bytes_dropped,
+           serial_stats.messages_dropped, serial_stats.dma_errors, serial_stats.max_used, SERIAL_TX_BUF_LEN);
+
+    telemetry_stats_t telemetry_stats;
+    get_telemetry_stats(&telemetry_stats);
+    printf("telemetry: %u frames sent, %u dropped, %u rate limited\n",
+           telemetry_stats.sent, telemetry_stats.dropped, telemetry_stats.rate_limited);
+    if (telemetry_file != NULL)
+    {
+        fclose(telemetry_file);
+    }
+
+    const trace_ring_t *ring = get_trace_ring();
+    printf("trace: %u records\n", ring->head);
+    if (trace_path != NULL)
+    {
+        FILE *trace_file = fopen(trace_path, "wb");
+        if (trace_file == NULL)
+        {
+            perror(trace_path);
+            return EXIT_FAILURE;
+        }
+        fwrite(ring, sizeof(*ring), 1, trace_file);
+        fclose(trace_file);
+    }
+
+    printf("\nsimulated %llu ms in %.1f ms wall clock, %.0fx realtime\n",
+           (unsigned long long)simulated_ms, wall_ms, simulated_ms / wall_ms);
+    printf("%s\n", failed ? "FAILED" : "PASS");
+    return failed;
+}
@@ -0,0 +1,123 @@
+/**
+  ******************************************************************************
+    * @file    host/sim/sim_metrics
+    * @date    16-October-2026
+    * @brief   Step response metrics and per-task CPU cost for the plant simulator.
+  ******************************************************************************
+**/
+
+#define _POSIX_C_SOURCE 199309L
+#include "sim_metrics.h"
+#include <math.h>
+#include <time.h>
+
+//Settling band, as a fraction of the step size
+#define SIM_SETTLING_BAND 0.02
+
+
+void sim_trace_reset(sim_trace_t *trace)
+{
+    trace->len = 0;
+}
+
+void sim_trace_record(sim_trace_t *trace, fp64 setpoint, fp64 output)
+{
+    if (trace->len < SIM_TRACE_LEN)
+    {
+        trace->setpoint[trace->len] = setpoint;
+        trace->output[trace->len] = output;
+        trace->len++;
+    }
+}
+
+void sim_step_metrics(const sim_trace_t *trace, sim_step_metrics_t *metrics)
+{
+    metrics->initial = 0.0;
+    metrics->final_setpoint = 0.0;
+    metrics->settling_ms = -1.0;
+    metrics->overshoot_pct = 0.0;
+    metrics->steady_state_error = 0.0;
+    if (trace->len == 0)
+    {
+        return;
+    }
+
+    uint32_t len = trace->len;
+    fp64 initial = trace->output[0];
+    fp64 target = trace->setpoint[len - 1];
+    fp64 step = target - initial;
+    fp64 band = fabs(step) * SIM_SETTLING_BAND;
+    metrics->initial = initial;
+    metrics->final_setpoint = target;
+
+    //Overshoot is measured in the direction of the step only
+    fp64 peak = 0.0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        fp64 beyond = (trace->output[i] - target) * (step >= 0.0 ? 1.0 : -1.0);
+        if (beyond > peak)
+        {
+            peak = beyond;
+        }
+    }
+    if (fabs(step) > 0.0)
+    {
+        metrics->overshoot_pct = peak / fabs(step) * 100.0;
+    }
+
+    //Walk back from the end to find the last sample outside the band
+    uint32_t i = len;
+    while (i > 0 && fabs(trace->output[i - 1] - target) <= band)
+    {
+        i--;
+    }
+    if (i < len)
+    {
+        metrics->settling_ms = i;
+    }
+
+    uint32_t tail = len / 10 > 0 ? len / 10 : 1;
+    fp64 sum = 0.0;
+    for (uint32_t k = len - tail; k < len; k++)
+    {
+        sum += trace->setpoint[k] - trace->output[k];
+    }
+    metrics->steady_state_error = sum / tail;
+}
+
+
+/******************** CPU cost ********************/
+
+uint64_t sim_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void sim_cpu_stat_reset(sim_cpu_stat_t *stat, const char *name)
+{
+    stat->name = name;
+    stat->calls = 0;
+    stat->total_ns = 0;
+    stat->min_ns = UINT64_MAX;
+    stat->max_ns = 0;
+}
+
+void sim_cpu_stat_call(sim_cpu_stat_t *stat, void (*fn)(void))
+{
+    uint64_t start = sim_now_ns();
+    fn();
+    uint64_t elapsed = sim_now_ns() - start;
+
+    stat->calls++;
+    stat->total_ns += elapsed;
+    if (elapsed < stat->min_ns)
+    {
+        stat->min_ns = elapsed;
+    }
+    if (elapsed > stat->max_ns)
+    {
+        stat->max_ns = elapsed;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+    * @file    host/sim/sim_metrics
+    * @date    16-October-2026
+    * @brief   Step response metrics and per-task CPU cost for the plant simulator.
+  ******************************************************************************
+**/
+
+#ifndef SIM_METRICS_H
+#define SIM_METRICS_H
+#include "main.h"
+
+//Longest trace a scenario can record, one sample per simulated ms
+#define SIM_TRACE_LEN 5000
+
+typedef struct
+{
+    fp64 setpoint[SIM_TRACE_LEN];
+    fp64 output[SIM_TRACE_LEN];
+    uint32_t len;
+} sim_trace_t;
+
+typedef struct
+{
+    fp64 initial;
+    fp64 final_setpoint;
+    fp64 settling_ms;       //last time the output entered the 2% band for good, -1 if never
+    fp64 overshoot_pct;     //percent of the step size, 0 if the output never passes the setpoint
+    fp64 steady_state_error;//mean setpoint - output over the last 10% of the trace
+} sim_step_metrics_t;
+
+typedef struct
+{
+    const char *name;
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} sim_cpu_stat_t;
+
+extern void sim_trace_reset(sim_trace_t *trace);
+extern void sim_trace_record(sim_trace_t *trace, fp64 setpoint, fp64 output);
+extern void sim_step_metrics(const sim_trace_t *trace, sim_step_metrics_t *metrics);
+
+extern void sim_cpu_stat_reset(sim_cpu_stat_t *stat, const char *name);
+//Runs fn once and accumulates its wall clock cost
+extern void sim_cpu_stat_call(sim_cpu_stat_t *stat, void (*fn)(void));
+extern uint64_t sim_now_ns(void);
+
+#endif
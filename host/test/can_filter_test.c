@@ -0,0 +1,190 @@
+/**
+  ******************************************************************************
+    * @file    host/test/can_filter_test
+    * @date    17-October-2026
+    * @brief   Unit test of the CAN filter bank packing (APP/CAN_receive/CAN_filter).
+    *          Each case packs a set of subscribed IDs with CAN_filter_pack and runs
+    *          all 2048 standard IDs through CAN_filter_match: every subscribed ID
+    *          must land in its FIFO and, while the banks suffice, nothing else may
+    *          pass. The bank layout (list or mask entries, FIFO split, bank count)
+    *          is checked against what the packer promises.
+    * @attention The last case goes through the host HAL: the firmware's own
+    *          registrations, CAN_update_filters and hal_host_can_push_rx, which
+    *          filters pushed frames with the same CAN_filter_match.
+    *          Exits non-zero on any failed check.
+  ******************************************************************************
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "CAN_filter.h"
+#include "CAN_receive.h"
+#include "hal_host.h"
+
+#define TEST_STD_ID_NUM 0x800u
+
+#define CHECK(cond, ...)                  \
+    do                                    \
+    {                                     \
+        test_checks++;                    \
+        if (!(cond))                      \
+        {                                 \
+            test_failures++;              \
+            printf("  FAIL: " __VA_ARGS__); \
+            putchar('\n');                \
+        }                                 \
+    } while (0)
+
+static uint32_t test_checks, test_failures;
+static hal_can_filter_bank_t banks[HAL_CAN_FILTER_BANKS];
+
+
+/**
+ * @brief  Packs ids and checks every standard ID against them
+ * @param  name: printed with the result
+ * @param  ids, n: subscribed IDs
+ * @param  max_banks: banks the bus has
+ * @param  exact: 1 if IDs nobody subscribed must be dropped
+ * @retval Banks used
+ */
+static uint8_t check_pack(const char *name, const can_filter_id_t *ids, uint16_t n, uint8_t max_banks,
+                          uint8_t exact)
+{
+    int8_t want[TEST_STD_ID_NUM];
+    uint32_t failures = test_failures;
+    uint8_t used = CAN_filter_pack(ids, n, banks, max_banks);
+
+    for (uint16_t id = 0; id < TEST_STD_ID_NUM; id++)
+    {
+        want[id] = -1;
+    }
+    for (uint16_t i = 0; i < n; i++)
+    {
+        want[ids[i].std_id] = (int8_t)ids[i].fifo;
+    }
+
+    CHECK(used <= max_banks, "%s: %u banks for %u available", name, used, max_banks);
+    for (uint8_t i = 1; i < used; i++)
+    {
+        CHECK(banks[i - 1].fifo <= banks[i].fifo, "%s: FIFO1 bank %u before a FIFO0 bank", name, i - 1);
+    }
+    for (uint16_t id = 0; id < TEST_STD_ID_NUM; id++)
+    {
+        int8_t fifo = CAN_filter_match(banks, used, id);
+        if (want[id] >= 0 && exact)
+        {
+            CHECK(fifo == want[id], "%s: 0x%03X lands in %d, not FIFO%d", name, id, fifo, want[id]);
+        }
+        else if (want[id] >= 0)
+        {
+            CHECK(fifo >= 0, "%s: subscribed 0x%03X dropped", name, id);
+        }
+        else if (exact)
+        {
+            CHECK(fifo < 0, "%s: 0x%03X passes, nobody subscribed", name, id);
+        }
+    }
+    printf("%-34s %2u banks  %s\n", name, used, test_failures == failures ? "ok" : "FAILED");
+    return used;
+}
+
+static uint8_t count_banks(uint8_t used, uint8_t mask_mode, uint8_t fifo)
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < used; i++)
+    {
+        count += banks[i].mask_mode == mask_mode && banks[i].fifo == fifo;
+    }
+    return count;
+}
+
+static void test_list(void)
+{
+    static const can_filter_id_t ids[] = {{0x100, 0}, {0x123, 0}, {0x2FF, 0}, {0x7FF, 0}, {0x001, 0}, {0x456, 0}};
+    uint8_t used = check_pack("scattered IDs, list banks", ids, 6, HAL_CAN_FILTER_BANKS, 1);
+
+    CHECK(used == 2 && count_banks(used, 0, 0) == 2, "6 scattered IDs take 2 list banks, got %u", used);
+}
+
+static void test_mask(void)
+{
+    can_filter_id_t ids[8];
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        ids[i].std_id = 0x208 - i;
+        ids[i].fifo = 1;
+    }
+    //0x201 ~ 0x208 is not aligned: 0x201, 0x202 ~ 0x203 as list, 0x204 ~ 0x207 as a mask, 0x208 as list
+    uint8_t used = check_pack("0x201 ~ 0x208, mask and list", ids, 8, HAL_CAN_FILTER_BANKS, 1);
+    CHECK(count_banks(used, 1, 1) == 1 && count_banks(used, 0, 1) == 1, "one mask and one list bank, got %u banks",
+          used);
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        ids[i].std_id = 0x300 + i;
+    }
+    used = check_pack("0x300 ~ 0x307, one aligned block", ids, 8, HAL_CAN_FILTER_BANKS, 1);
+    CHECK(used == 1 && banks[0].mask_mode, "an aligned block of 8 takes one mask bank, got %u", used);
+}
+
+static void test_fifo_split(void)
+{
+    static const can_filter_id_t ids[] = {
+        {0x201, 0}, {0x202, 0}, {0x203, 0}, {0x204, 0}, {0x205, 0}, {0x206, 0}, {0x207, 0}, {0x208, 0},
+        {0x211, 1}, {0x301, 1}, {0x302, 1}, {0x201, 0}, {0x211, 1},
+    };
+    uint8_t used = check_pack("both FIFOs, duplicates", ids, sizeof(ids) / sizeof(ids[0]), HAL_CAN_FILTER_BANKS, 1);
+
+    CHECK(count_banks(used, 0, 1) == 1 && count_banks(used, 1, 1) == 0, "FIFO1 IDs take one list bank");
+    CHECK(count_banks(used, 0, 0) + count_banks(used, 1, 0) >= 1, "FIFO0 IDs have banks of their own");
+}
+
+static void test_overflow(void)
+{
+    can_filter_id_t ids[CAN_FILTER_MAX_IDS];
+    for (uint8_t i = 0; i < CAN_FILTER_MAX_IDS; i++)
+    {
+        //Every 5th ID: no blocks, so exact packing needs 16 list banks
+        ids[i].std_id = 0x100 + 5 * i;
+        ids[i].fifo = i & 1;
+    }
+    uint8_t used = check_pack("64 scattered IDs, 14 banks", ids, CAN_FILTER_MAX_IDS, HAL_CAN_FILTER_BANKS, 0);
+    CHECK(used >= 1 && used <= HAL_CAN_FILTER_BANKS, "overflow still fits, got %u banks", used);
+
+    used = check_pack("64 scattered IDs, 2 banks", ids, CAN_FILTER_MAX_IDS, 2, 0);
+    CHECK(used == 2 && banks[0].mask_mode && banks[1].mask_mode, "2 banks: one superset mask per FIFO");
+
+    CHECK(CAN_filter_pack(ids, 0, banks, HAL_CAN_FILTER_BANKS) == 0, "no IDs, no banks");
+}
+
+//The firmware's registrations through CAN_update_filters and the host HAL
+static void test_firmware_filters(void)
+{
+    static const hal_can_frame_t motor = {.std_id = CAN_YAW_MOTOR_ID, .dlc = 8};
+    static const hal_can_frame_t chassis = {.std_id = CAN_3508_M1_ID, .dlc = 8};
+    static const hal_can_frame_t stranger = {.std_id = 0x555, .dlc = 8};
+    uint32_t failures = test_failures;
+
+    hal_host_reset();
+    CAN_receive_init();
+    CAN_update_filters();
+    CHECK(hal_host_can_push_rx(GIMBAL_CAN, &motor) == HAL_CAN_FIFO0, "yaw feedback lands in FIFO0");
+    CHECK(hal_host_can_push_rx(CHASSIS_CAN, &chassis) == HAL_CAN_FIFO0, "chassis feedback lands in FIFO0");
+    CHECK(hal_host_can_push_rx(GIMBAL_CAN, &chassis) == -1, "chassis ID dropped on the gimbal bus");
+    CHECK(hal_host_can_push_rx(GIMBAL_CAN, &stranger) == -1, "unregistered ID dropped");
+    CHECK(hal_host_can_filtered_count(GIMBAL_CAN) == 2, "dropped frames counted");
+    printf("%-34s %11s\n", "firmware registrations, host HAL", test_failures == failures ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    test_list();
+    test_mask();
+    test_fifo_split();
+    test_overflow();
+    test_firmware_filters();
+
+    printf("%u checks, %u failed\n", test_checks, test_failures);
+    return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+/**
+  ******************************************************************************
+    * @file    host/test/feedback_stress
+    * @date    17-October-2026
+    * @brief   Stress test of the motor feedback seqlock (CAN_receive). A writer
+    *          thread stands in for the CAN interrupt and pushes frames through
+    *          CAN2_RX0_IRQHandler into fill_motor_readings as fast as it can,
+    *          while reader threads take get_motor_feedback_snapshot copies.
+    *          Every field of frame k is derived from k, so a copy mixing two
+    *          frames shows up as fields that disagree with each other or with
+    *          the copy's seq.
+    * @attention One more reader copies the fields without the seqlock and only
+    *          counts its mixed copies, to show the race is really exercised.
+    *          Usage: feedback_stress [frames]
+    *          Exits non-zero on any mixed snapshot.
+  ******************************************************************************
+**/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "CAN_receive.h"
+#include "hal_host.h"
+
+#define STRESS_DEFAULT_FRAMES 2000000u
+#define STRESS_READERS 3
+
+extern void CAN2_RX0_IRQHandler(void);
+extern void CAN2_RX1_IRQHandler(void);
+
+typedef struct
+{
+    uint32_t copies;
+    uint32_t mixed;
+    uint32_t new_frames;    //copies whose seq moved on from the previous one
+} stress_reader_t;
+
+static const motor_feedback_t *stress_motor;
+static volatile int stress_done;
+static uint32_t stress_frames;
+
+
+static void stress_frame(uint32_t k, hal_can_frame_t *frame)
+{
+    uint16_t ecd = (uint16_t)(k & (MOTOR_ECD_RANGE - 1));
+    int16_t speed = (int16_t)k;
+    int16_t current = (int16_t)~k;
+
+    frame->std_id = CAN_3508_M1_ID;
+    frame->dlc = 8;
+    frame->data[0] = (uint8_t)(ecd >> 8);
+    frame->data[1] = (uint8_t)ecd;
+    frame->data[2] = (uint8_t)((uint16_t)speed >> 8);
+    frame->data[3] = (uint8_t)speed;
+    frame->data[4] = (uint8_t)((uint16_t)current >> 8);
+    frame->data[5] = (uint8_t)current;
+    frame->data[6] = (uint8_t)k;
+    frame->data[7] = 0;
+}
+
+/**
+ * @brief  Checks that a copy holds one frame: frame k is the (seq / 2)th
+ * @param  copy: fields to check, seq included
+ * @retval 1 if they belong together
+ */
+static int stress_consistent(const motor_feedback_t *copy)
+{
+    uint32_t k = copy->seq / 2u;
+    int16_t expected_speed = (int16_t)k;
+    int16_t expected_current = (int16_t)~k;
+    int16_t expected_last_ecd = (int16_t)((k - 1) & (MOTOR_ECD_RANGE - 1));
+
+    return copy->ecd == (k & (MOTOR_ECD_RANGE - 1)) && copy->speed_rpm == expected_speed &&
+           copy->current_read == expected_current && copy->temperate == (uint8_t)k &&
+           (k < 2 || copy->last_ecd == expected_last_ecd);
+}
+
+static void *stress_writer(void *arg)
+{
+    hal_can_frame_t frame;
+    (void)arg;
+
+    for (uint32_t k = 1; k <= stress_frames; k++)
+    {
+        stress_frame(k, &frame);
+        int8_t fifo = hal_host_can_push_rx(CHASSIS_CAN, &frame);
+        if (fifo == 0)
+        {
+            CAN2_RX0_IRQHandler();
+        }
+        else if (fifo == 1)
+        {
+            CAN2_RX1_IRQHandler();
+        }
+    }
+    __atomic_store_n(&stress_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *stress_reader(void *arg)
+{
+    stress_reader_t *reader = arg;
+    motor_feedback_t copy;
+    uint32_t last_seq = 0;
+
+    while (!__atomic_load_n(&stress_done, __ATOMIC_ACQUIRE))
+    {
+        get_motor_feedback_snapshot(stress_motor, &copy);
+        if (copy.seq == 0)
+        {
+            continue;
+        }
+        reader->copies++;
+        reader->new_frames += copy.seq != last_seq;
+        reader->mixed += !stress_consistent(&copy);
+        last_seq = copy.seq;
+    }
+    return NULL;
+}
+
+//Same copy with no seq check, the seq is read first like the snapshot does
+static void *stress_unprotected_reader(void *arg)
+{
+    stress_reader_t *reader = arg;
+    const volatile motor_feedback_t *src = stress_motor;
+    motor_feedback_t copy;
+
+    while (!__atomic_load_n(&stress_done, __ATOMIC_ACQUIRE))
+    {
+        copy.seq = src->seq & ~1u;
+        copy.ecd = src->ecd;
+        copy.speed_rpm = src->speed_rpm;
+        copy.current_read = src->current_read;
+        copy.temperate = src->temperate;
+        copy.last_ecd = src->last_ecd;
+        if (copy.seq == 0)
+        {
+            continue;
+        }
+        reader->copies++;
+        reader->mixed += !stress_consistent(&copy);
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    pthread_t writer, readers[STRESS_READERS + 1];
+    stress_reader_t results[STRESS_READERS + 1] = {{0}};
+    uint32_t mixed = 0;
+
+    stress_frames = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : STRESS_DEFAULT_FRAMES;
+    hal_host_reset();
+    CAN_receive_init();
+    CAN_update_filters();
+    stress_motor = get_chassis_motor_feedback_pointer(0);
+
+    for (int i = 0; i < STRESS_READERS; i++)
+    {
+        pthread_create(&readers[i], NULL, stress_reader, &results[i]);
+    }
+    pthread_create(&readers[STRESS_READERS], NULL, stress_unprotected_reader, &results[STRESS_READERS]);
+    pthread_create(&writer, NULL, stress_writer, NULL);
+    pthread_join(writer, NULL);
+    for (int i = 0; i <= STRESS_READERS; i++)
+    {
+        pthread_join(readers[i], NULL);
+    }
+
+    printf("%u frames written, %u received\n", stress_frames, stress_motor->seq / 2u);
+    printf("reader        copies    new frames     mixed\n");
+    for (int i = 0; i < STRESS_READERS; i++)
+    {
+        printf("snapshot %d %9u %13u %9u\n", i, results[i].copies, results[i].new_frames, results[i].mixed);
+        mixed += results[i].mixed;
+    }
+    printf("no seqlock %9u %13s %9u\n", results[STRESS_READERS].copies, "-", results[STRESS_READERS].mixed);
+
+    if (stress_motor->seq / 2u != stress_frames)
+    {
+        printf("FAIL: frames lost before the motor\n");
+        return EXIT_FAILURE;
+    }
+    if (mixed != 0)
+    {
+        printf("FAIL: %u snapshots mixed two frames\n", mixed);
+        return EXIT_FAILURE;
+    }
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+    * @file    host/test/mecanum_test
+    * @date    17-October-2026
+    * @brief   Unit test of the mecanum kinematics (APP/mecanum). Runs a grid of
+    *          body velocities through mecanum_mix and back through
+    *          mecanum_forward, which must give the same velocity to within the
+    *          rounding of the wheels to whole rpm, and checks that
+    *          mecanum_desaturate holds every wheel to the limit while keeping
+    *          the ratios between the wheels.
+    * @attention Exits non-zero on any failed check.
+  ******************************************************************************
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mecanum.h"
+
+//Body velocity grid, up to 4 m/s and 8 rad/s, beyond what the motors reach
+#define TEST_V_MAX_MM_S 4000
+#define TEST_V_STEP_MM_S 250
+#define TEST_W_MAX_MRAD_S 8000
+#define TEST_W_STEP_MRAD_S 500
+//One motor rpm is ~0.41 mm/s at the wheel and ~1 mrad/s of chassis rotation, so the
+//wheels' rounding to whole rpm can move the round trip by one unit
+#define TEST_ROUND_TRIP_TOLERANCE 1
+//M3508 rotor limit the chassis desaturates to
+#define TEST_MAX_RPM 9000
+
+#define CHECK(cond, ...)                  \
+    do                                    \
+    {                                     \
+        test_checks++;                    \
+        if (!(cond))                      \
+        {                                 \
+            test_failures++;              \
+            printf("  FAIL: " __VA_ARGS__); \
+            putchar('\n');                \
+        }                                 \
+    } while (0)
+
+static uint32_t test_checks, test_failures;
+
+
+//mecanum_forward(mecanum_mix(body)) == body over the whole grid, to the wheel rounding
+static void test_round_trip(void)
+{
+    uint32_t failures = test_failures;
+
+    for (int32_t vx = -TEST_V_MAX_MM_S; vx <= TEST_V_MAX_MM_S; vx += TEST_V_STEP_MM_S)
+    {
+        for (int32_t vy = -TEST_V_MAX_MM_S; vy <= TEST_V_MAX_MM_S; vy += TEST_V_STEP_MM_S)
+        {
+            for (int32_t wz = -TEST_W_MAX_MRAD_S; wz <= TEST_W_MAX_MRAD_S; wz += TEST_W_STEP_MRAD_S)
+            {
+                const mecanum_body_t body = {vx, vy, wz};
+                mecanum_body_t back;
+                int32_t wheel_rpm[MECANUM_WHEEL_NUM];
+
+                mecanum_mix(&body, wheel_rpm);
+                mecanum_forward(wheel_rpm, &back);
+                CHECK(abs(back.vx - vx) <= TEST_ROUND_TRIP_TOLERANCE &&
+                          abs(back.vy - vy) <= TEST_ROUND_TRIP_TOLERANCE &&
+                          abs(back.wz - wz) <= TEST_ROUND_TRIP_TOLERANCE,
+                      "(%d, %d, %d) comes back as (%d, %d, %d)", vx, vy, wz, back.vx, back.vy, back.wz);
+            }
+        }
+    }
+    printf("%-34s %s\n", "mix and forward round trip", test_failures == failures ? "ok" : "FAILED");
+}
+
+//Pure translation and pure rotation turn the wheels in the expected pattern
+static void test_directions(void)
+{
+    static const mecanum_body_t forward = {1000, 0, 0}, left = {0, 1000, 0}, spin = {0, 0, 1000};
+    int32_t w[MECANUM_WHEEL_NUM];
+    uint32_t failures = test_failures;
+
+    //Front right, front left, back left, back right; the right side motors are mounted mirrored
+    mecanum_mix(&forward, w);
+    CHECK(w[0] == -w[1] && w[1] == w[2] && w[2] == -w[3] && w[1] != 0, "forward: right side mirrors the left");
+    mecanum_mix(&left, w);
+    CHECK(w[0] == w[1] && w[2] == w[3] && w[0] == -w[2] && w[0] != 0, "left: front against back");
+    mecanum_mix(&spin, w);
+    CHECK(w[0] == w[1] && w[1] == w[2] && w[2] == w[3] && w[0] != 0, "spin: all wheels the same way");
+    printf("%-34s %s\n", "wheel patterns", test_failures == failures ? "ok" : "FAILED");
+}
+
+//Scaled wheels stay within the limit and within one rpm of the exact ratio
+static void test_desaturate(void)
+{
+    uint32_t failures = test_failures;
+    uint32_t scaled = 0;
+
+    for (int32_t vx = -TEST_V_MAX_MM_S; vx <= TEST_V_MAX_MM_S; vx += TEST_V_STEP_MM_S)
+    {
+        for (int32_t wz = -TEST_W_MAX_MRAD_S; wz <= TEST_W_MAX_MRAD_S; wz += TEST_W_STEP_MRAD_S)
+        {
+            const mecanum_body_t body = {vx, vx / 2, wz};
+            int32_t raw[MECANUM_WHEEL_NUM], w[MECANUM_WHEEL_NUM];
+            int32_t peak = 0;
+
+            mecanum_mix(&body, raw);
+            for (uint8_t i = 0; i < MECANUM_WHEEL_NUM; i++)
+            {
+                w[i] = raw[i];
+                peak = abs(raw[i]) > peak ? abs(raw[i]) : peak;
+            }
+            uint8_t did_scale = mecanum_desaturate(w, TEST_MAX_RPM);
+            CHECK(did_scale == (peak > TEST_MAX_RPM), "(%d, %d, %d): scaled %u with peak %d", vx, vx / 2, wz,
+                  did_scale, peak);
+            scaled += did_scale;
+
+            int32_t new_peak = 0;
+            for (uint8_t i = 0; i < MECANUM_WHEEL_NUM; i++)
+            {
+                fp64 exact = peak > TEST_MAX_RPM ? (fp64)raw[i] * TEST_MAX_RPM / peak : raw[i];
+                CHECK(abs(w[i]) <= TEST_MAX_RPM, "(%d, %d, %d): wheel %u at %d rpm", vx, vx / 2, wz, i, w[i]);
+                CHECK(w[i] - exact < 1.0 && exact - w[i] < 1.0, "(%d, %d, %d): wheel %u at %d, ratio wants %.2f",
+                      vx, vx / 2, wz, i, w[i], exact);
+                new_peak = abs(w[i]) > new_peak ? abs(w[i]) : new_peak;
+            }
+            CHECK(!did_scale || new_peak == TEST_MAX_RPM, "(%d, %d, %d): peak wheel at %d after scaling", vx,
+                  vx / 2, wz, new_peak);
+        }
+    }
+    CHECK(scaled > 0, "the grid never saturated a wheel");
+    printf("%-34s %s\n", "desaturation", test_failures == failures ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    test_round_trip();
+    test_directions();
+    test_desaturate();
+
+    printf("%u checks, %u failed\n", test_checks, test_failures);
+    return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
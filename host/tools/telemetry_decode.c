@@ -0,0 +1,316 @@
+/**
+  ******************************************************************************
+    * @file    host/tools/telemetry_decode
+    * @date    16-October-2026
+    * @brief   Decodes a USART6 telemetry capture (see APP/telemetry/telemetry.h)
+    *          into CSV. The stream is split on 0x00, each block is COBS decoded,
+    *          CRC checked and matched against its schema by msg_id and length.
+    *          The 32 bit cycle timestamp is unwrapped and printed in seconds
+    *          from the first frame.
+    * @attention Usage: telemetry_decode [-s schema] [file]   (stdin without file)
+    *              -s schema  prints a CSV header and only that schema
+    *                         (motor, pid, imu, rc, limiter, gimbal, profile, task)
+    *              otherwise every line starts with the schema name.
+    *          Frame, CRC error and sequence gap counts go to stderr.
+    *          Works on a live port too: telemetry_decode -s imu /dev/ttyUSB0
+  ******************************************************************************
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "FreeRTOS_middleware.h"
+
+//Longest block kept, anything longer is line noise
+#define DECODE_BLOCK_MAX 256
+
+typedef void (*decode_print_f)(const uint8_t *body);
+
+typedef struct
+{
+    const char *name;
+    uint8_t body_len;
+    const char *header;
+    decode_print_f print;
+} decode_schema_t;
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t crc_errors;
+    uint32_t malformed;     //bad COBS, too short, unknown msg_id or wrong body length
+    uint32_t seq_gaps;      //frames missing according to seq
+} decode_stats_t;
+
+static void print_motor(const uint8_t *body);
+static void print_pid(const uint8_t *body);
+static void print_imu(const uint8_t *body);
+static void print_rc(const uint8_t *body);
+static void print_limiter(const uint8_t *body);
+static void print_gimbal(const uint8_t *body);
+static void print_profile(const uint8_t *body);
+static void print_task(const uint8_t *body);
+
+static const decode_schema_t schemas[TELEMETRY_MSG_NUM] = {
+    [TELEMETRY_MSG_MOTOR] = {"motor", TELEMETRY_BODY_LEN_MOTOR,
+                             "motor,ecd,speed_rpm,current,temperate", print_motor},
+    [TELEMETRY_MSG_PID] = {"pid", TELEMETRY_BODY_LEN_PID,
+                           "loop,set,fdb,pout,iout,dout,out", print_pid},
+    [TELEMETRY_MSG_IMU] = {"imu", TELEMETRY_BODY_LEN_IMU,
+                           "yaw,pitch,roll,gyro_x,gyro_y,gyro_z,accel_x,accel_y,accel_z", print_imu},
+    [TELEMETRY_MSG_RC] = {"rc", TELEMETRY_BODY_LEN_RC,
+                          "ch0,ch1,ch2,ch3,ch4,s0,s1,mouse_x,mouse_y,mouse_z,press_l,press_r,key", print_rc},
+    [TELEMETRY_MSG_LIMITER] = {"limiter", TELEMETRY_BODY_LEN_LIMITER,
+                               "motor,limiter,current", print_limiter},
+    [TELEMETRY_MSG_GIMBAL] = {"gimbal", TELEMETRY_BODY_LEN_GIMBAL,
+                              "yaw_re,yaw_im,yaw_set_re,yaw_set_im,pitch_pos", print_gimbal},
+    [TELEMETRY_MSG_PROFILE] = {"profile", TELEMETRY_BODY_LEN_PROFILE,
+                               "loop,count,exec_min_us,exec_avg_us,exec_max_us,exec_p99_us,"
+                               "period_min_us,period_avg_us,period_max_us,period_p99_us", print_profile},
+    [TELEMETRY_MSG_TASK] = {"task", TELEMETRY_BODY_LEN_TASK,
+                            "slot,number,name,priority,cpu_pct,stack_free_words,run_time_s", print_task},
+};
+
+static const char *const pid_loop_name[TELEMETRY_PID_NUM] = {
+    "chassis_fr", "chassis_fl", "chassis_bl", "chassis_br", "yaw", "pitch", "trigger", "yaw_rate", "pitch_rate",
+};
+
+static const char *const profile_loop_name[PROFILER_LOOP_NUM] = {
+    "ins", "gimbal", "chassis", "shoot",
+};
+
+static decode_stats_t stats;
+//Schema to print, 0 prints them all with a name column
+static telemetry_msg_e only_msg;
+static uint8_t have_time, have_seq, last_seq;
+static uint32_t last_time;
+static uint64_t elapsed_cycles;
+
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static int16_t get_i16(const uint8_t *p)
+{
+    return (int16_t)get_u16(p);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return get_u16(p) | (uint32_t)get_u16(p + 2) << 16;
+}
+
+static float get_f32(const uint8_t *p)
+{
+    uint32_t bits = get_u32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void print_motor(const uint8_t *body)
+{
+    printf("%u,%u,%d,%d,%u", body[0], get_u16(body + 1), get_i16(body + 3), get_i16(body + 5), body[7]);
+}
+
+static void print_pid(const uint8_t *body)
+{
+    printf("%s", body[0] < TELEMETRY_PID_NUM ? pid_loop_name[body[0]] : "unknown");
+    for (int i = 0; i < 6; i++)
+    {
+        printf(",%g", get_f32(body + 1 + 4 * i));
+    }
+}
+
+static void print_imu(const uint8_t *body)
+{
+    for (int i = 0; i < 9; i++)
+    {
+        printf(i ? ",%g" : "%g", get_f32(body + 4 * i));
+    }
+}
+
+static void print_rc(const uint8_t *body)
+{
+    for (int i = 0; i < 5; i++)
+    {
+        printf("%d,", get_i16(body + 2 * i));
+    }
+    printf("%u,%u,%d,%d,%d,%u,%u,0x%04X", body[10], body[11], get_i16(body + 12), get_i16(body + 14),
+           get_i16(body + 16), body[18], body[19], get_u16(body + 20));
+}
+
+static void print_limiter(const uint8_t *body)
+{
+    printf("%u,%u,%d", body[0], body[1], get_i16(body + 2));
+}
+
+static void print_gimbal(const uint8_t *body)
+{
+    printf("%g,%g,%g,%g,%u", get_f32(body), get_f32(body + 4), get_f32(body + 8), get_f32(body + 12),
+           get_u16(body + 16));
+}
+
+static void print_profile(const uint8_t *body)
+{
+    printf("%s,%u", body[0] < PROFILER_LOOP_NUM ? profile_loop_name[body[0]] : "unknown", get_u32(body + 1));
+    for (int i = 0; i < 8; i++)
+    {
+        printf(",%.2f", (double)get_u32(body + 5 + 4 * i) / HAL_CYCLES_PER_US);
+    }
+}
+
+static void print_task(const uint8_t *body)
+{
+    char name[TASK_MONITOR_NAME_LEN + 1] = {0};
+
+    memcpy(name, body + 2, TASK_MONITOR_NAME_LEN);
+    printf("%u,%u,%s,%u,%.1f,%u,%.6f", body[0], body[1], name, body[10], get_u16(body + 11) / 10.0,
+           get_u16(body + 13), (double)get_u32(body + 15) / RUN_TIME_STATS_HZ);
+}
+
+/**
+ * @brief  Checks and prints one COBS block
+ * @param  block, len: bytes between two delimiters
+ * @retval None
+ */
+static void decode_block(const uint8_t *block, uint16_t len)
+{
+    uint8_t raw[DECODE_BLOCK_MAX];
+    uint16_t raw_len = telemetry_cobs_decode(block, len, raw);
+
+    if (raw_len < TELEMETRY_HEADER_LEN + TELEMETRY_CRC_LEN)
+    {
+        stats.malformed++;
+        return;
+    }
+    uint16_t body_len = raw_len - TELEMETRY_HEADER_LEN - TELEMETRY_CRC_LEN;
+    if (telemetry_crc16(TELEMETRY_CRC_INIT, raw, raw_len - TELEMETRY_CRC_LEN) != get_u16(raw + raw_len - TELEMETRY_CRC_LEN))
+    {
+        stats.crc_errors++;
+        return;
+    }
+
+    uint8_t msg = raw[0];
+    uint8_t seq = raw[1];
+    uint32_t time = get_u32(raw + 2);
+    stats.frames++;
+
+    //Seq counts every frame the firmware tried to send, including the ones it dropped
+    if (have_seq)
+    {
+        stats.seq_gaps += (uint8_t)(seq - last_seq - 1);
+    }
+    have_seq = 1;
+    last_seq = seq;
+    if (have_time)
+    {
+        elapsed_cycles += (uint32_t)(time - last_time);
+    }
+    have_time = 1;
+    last_time = time;
+
+    if (msg == 0 || msg >= TELEMETRY_MSG_NUM || schemas[msg].body_len != body_len)
+    {
+        stats.malformed++;
+        return;
+    }
+    if (only_msg != 0 && msg != only_msg)
+    {
+        return;
+    }
+    if (only_msg == 0)
+    {
+        printf("%s,", schemas[msg].name);
+    }
+    printf("%.6f,%u,", (double)elapsed_cycles / HAL_CYCLE_HZ, seq);
+    schemas[msg].print(raw + TELEMETRY_HEADER_LEN);
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    int arg = 1;
+
+    if (arg + 1 < argc && strcmp(argv[arg], "-s") == 0)
+    {
+        for (telemetry_msg_e msg = TELEMETRY_MSG_MOTOR; msg < TELEMETRY_MSG_NUM; msg++)
+        {
+            if (strcmp(argv[arg + 1], schemas[msg].name) == 0)
+            {
+                only_msg = msg;
+            }
+        }
+        if (only_msg == 0)
+        {
+            fprintf(stderr, "unknown schema %s\n", argv[arg + 1]);
+            return EXIT_FAILURE;
+        }
+        arg += 2;
+    }
+    if (arg < argc)
+    {
+        if (arg + 1 < argc || argv[arg][0] == '-')
+        {
+            fprintf(stderr, "usage: %s [-s schema] [file]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        in = fopen(argv[arg], "rb");
+        if (in == NULL)
+        {
+            perror(argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (only_msg != 0)
+    {
+        printf("t_s,seq,%s\n", schemas[only_msg].header);
+    }
+
+    uint8_t block[DECODE_BLOCK_MAX];
+    uint16_t len = 0;
+    uint8_t overflow = 0;
+    int c;
+    while ((c = fgetc(in)) != EOF)
+    {
+        if (c != TELEMETRY_FRAME_DELIMITER)
+        {
+            if (len < sizeof(block))
+            {
+                block[len++] = (uint8_t)c;
+            }
+            else
+            {
+                overflow = 1;
+            }
+            continue;
+        }
+        //Bytes before the first delimiter may be a partial frame, COBS or the CRC rejects it
+        if (overflow)
+        {
+            stats.malformed++;
+        }
+        else if (len > 0)
+        {
+            decode_block(block, len);
+        }
+        len = 0;
+        overflow = 0;
+    }
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+
+    fprintf(stderr, "%u frames, %u crc errors, %u malformed, %u lost by seq\n",
+            stats.frames, stats.crc_errors, stats.malformed, stats.seq_gaps);
+    return stats.frames > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
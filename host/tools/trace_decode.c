@@ -0,0 +1,373 @@
+/**
+  ******************************************************************************
+    * @file    host/tools/trace_decode
+    * @date    16-October-2026
+    * @brief   Rebuilds the TRACE log (see APP/trace/trace.h) from the image the
+    *          firmware ran and a memory dump holding trace_ring. Format strings
+    *          are read relative to the trace_fmt_anchor symbol from the image
+    *          section holding it (trace_fmt with GNU ld, ER_IROM1 with armlink),
+    *          and formatted here with the stored words.
+    * @attention Usage: trace_decode image dump
+    *              image  the ELF that produced the dump: the Keil .axf, or the
+    *                     host executable that wrote it (infantry_sim -T)
+    *              dump   raw binary or Intel HEX (uVision SAVE) of memory that
+    *                     contains the ring, it is found by its header
+    *          Prints one line per record, oldest first: seconds since the
+    *          oldest record, then the message.
+  ******************************************************************************
+**/
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "trace.h"
+
+typedef struct
+{
+    const uint8_t *fmt;         //section contents
+    uint64_t fmt_addr;
+    uint64_t fmt_size;
+    uint64_t anchor_addr;
+} trace_image_t;
+
+/**
+ * @brief  Reads a whole file
+ * @param  path file to read
+ * @param  len filled with the size
+ * @retval malloc'd contents, NULL on error
+ */
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc(size > 0 ? size : 1);
+    if (buf == NULL || fread(buf, 1, size, f) != (size_t)size)
+    {
+        fprintf(stderr, "%s: read failed\n", path);
+        free(buf);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *len = size;
+    return buf;
+}
+
+/**
+ * @brief  Finds the anchor symbol, then the loaded section holding it, for 32 and 64
+ *         bit little endian ELF. GNU ld keeps trace_fmt as its own section, armlink
+ *         without a scatter file merges it into ER_IROM1, so the name is not used.
+ *         Two copies keep the field widths straight.
+ * @retval 1 if both were found
+ */
+#define LOAD_ELF(Ehdr, Shdr, Sym)                                                                \
+    do                                                                                           \
+    {                                                                                            \
+        const Ehdr *eh = (const Ehdr *)elf;                                                      \
+        const Shdr *sh = (const Shdr *)(elf + eh->e_shoff);                                      \
+        for (unsigned i = 0; i < eh->e_shnum; i++)                                               \
+        {                                                                                        \
+            if (sh[i].sh_type == SHT_SYMTAB)                                                     \
+            {                                                                                    \
+                const Sym *sym = (const Sym *)(elf + sh[i].sh_offset);                           \
+                const char *str = (const char *)(elf + sh[sh[i].sh_link].sh_offset);             \
+                for (size_t s = 0; s < sh[i].sh_size / sizeof(Sym); s++)                         \
+                {                                                                                \
+                    if (strcmp(str + sym[s].st_name, "trace_fmt_anchor") == 0)                   \
+                    {                                                                            \
+                        image->anchor_addr = sym[s].st_value;                                    \
+                        found_anchor = 1;                                                        \
+                    }                                                                            \
+                }                                                                                \
+            }                                                                                    \
+        }                                                                                        \
+        for (unsigned i = 0; found_anchor && i < eh->e_shnum; i++)                               \
+        {                                                                                        \
+            if ((sh[i].sh_flags & SHF_ALLOC) && sh[i].sh_type != SHT_NOBITS &&                   \
+                image->anchor_addr >= sh[i].sh_addr &&                                           \
+                image->anchor_addr < sh[i].sh_addr + sh[i].sh_size &&                            \
+                sh[i].sh_offset + sh[i].sh_size <= len)                                          \
+            {                                                                                    \
+                image->fmt = elf + sh[i].sh_offset;                                              \
+                image->fmt_addr = sh[i].sh_addr;                                                 \
+                image->fmt_size = sh[i].sh_size;                                                 \
+            }                                                                                    \
+        }                                                                                        \
+    } while (0)
+
+static int load_image(const uint8_t *elf, size_t len, trace_image_t *image)
+{
+    int found_anchor = 0;
+
+    if (len < EI_NIDENT || memcmp(elf, ELFMAG, SELFMAG) != 0 || elf[EI_DATA] != ELFDATA2LSB)
+    {
+        fprintf(stderr, "image is not a little endian ELF file\n");
+        return 0;
+    }
+    if (elf[EI_CLASS] == ELFCLASS32)
+    {
+        LOAD_ELF(Elf32_Ehdr, Elf32_Shdr, Elf32_Sym);
+    }
+    else
+    {
+        LOAD_ELF(Elf64_Ehdr, Elf64_Shdr, Elf64_Sym);
+    }
+    if (image->fmt == NULL || !found_anchor)
+    {
+        fprintf(stderr, "image has no trace_fmt_anchor symbol in a loaded section\n");
+        return 0;
+    }
+    return 1;
+}
+
+static int hex_byte(const char *p)
+{
+    unsigned value;
+    return sscanf(p, "%2x", &value) == 1 ? (int)value : -1;
+}
+
+/**
+ * @brief  Turns an Intel HEX dump into the flat bytes it covers
+ * @param  text file contents, len: size
+ * @param  out_len filled with the flat size
+ * @retval malloc'd bytes from the lowest address on, gaps zeroed; NULL on error
+ */
+static uint8_t *parse_hex(const uint8_t *text, size_t len, size_t *out_len)
+{
+    uint32_t base = 0, low = UINT32_MAX, high = 0;
+    uint8_t *out = NULL;
+
+    //Two passes: the extent, then the data
+    for (int pass = 0; pass < 2; pass++)
+    {
+        base = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            if (text[i] != ':' || i + 11 > len)
+            {
+                continue;
+            }
+            const char *p = (const char *)text + i + 1;
+            int count = hex_byte(p);
+            int type = hex_byte(p + 6);
+            uint32_t addr = base + (uint32_t)(hex_byte(p + 2) << 8 | hex_byte(p + 4));
+            if (count < 0 || type < 0 || i + 11 + 2 * (size_t)count > len)
+            {
+                return NULL;
+            }
+            if (type == 0 && pass == 0)
+            {
+                low = addr < low ? addr : low;
+                high = addr + count > high ? addr + count : high;
+            }
+            else if (type == 0)
+            {
+                for (int b = 0; b < count; b++)
+                {
+                    out[addr - low + b] = hex_byte(p + 8 + 2 * b);
+                }
+            }
+            else if (type == 4)
+            {
+                base = (uint32_t)(hex_byte(p + 8) << 8 | hex_byte(p + 10)) << 16;
+            }
+        }
+        if (pass == 0)
+        {
+            if (high <= low)
+            {
+                return NULL;
+            }
+            *out_len = high - low;
+            out = calloc(*out_len, 1);
+            if (out == NULL)
+            {
+                return NULL;
+            }
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief  Finds the ring in a dump by its header
+ * @retval ring inside the dump, NULL if there is none
+ */
+static const trace_ring_t *find_ring(const uint8_t *dump, size_t len)
+{
+    for (size_t i = 0; i + sizeof(trace_ring_t) <= len; i += 4)
+    {
+        const trace_ring_t *ring = (const trace_ring_t *)(dump + i);
+        if (ring->magic == TRACE_MAGIC && ring->record_words == TRACE_RECORD_WORDS &&
+            ring->record_num == TRACE_RING_RECORDS)
+        {
+            return ring;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  printf with the stored argument words, one conversion at a time
+ * @param  fmt format string from the image
+ * @param  args, nargs: stored words
+ * @retval None
+ */
+static void print_record(const char *fmt, const uint32_t *args, uint32_t nargs)
+{
+    uint32_t arg = 0;
+
+    while (*fmt)
+    {
+        if (*fmt != '%')
+        {
+            putchar(*fmt++);
+            continue;
+        }
+        if (fmt[1] == '%')
+        {
+            putchar('%');
+            fmt += 2;
+            continue;
+        }
+
+        //Copy flags, width and precision, drop length modifiers: every argument is a word
+        char spec[32];
+        size_t n = 0;
+        spec[n++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) && n < sizeof(spec) - 3)
+        {
+            spec[n++] = *fmt++;
+        }
+        while (*fmt && strchr("hlzjtL", *fmt))
+        {
+            fmt++;
+        }
+        char conv = *fmt ? *fmt++ : 0;
+        spec[n++] = conv;
+        spec[n] = 0;
+
+        if (arg >= nargs)
+        {
+            printf("<missing>");
+            continue;
+        }
+        uint32_t word = args[arg++];
+        switch (conv)
+        {
+        case 'd':
+        case 'i':
+            printf(spec, (int)(int32_t)word);
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            printf(spec, (unsigned)word);
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            float value;
+            memcpy(&value, &word, sizeof(value));
+            printf(spec, (double)value);
+            break;
+        }
+        case 'p':
+            printf("0x%08X", (unsigned)word);
+            break;
+        default:
+            printf("<%%%c unsupported>", conv);
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t image_len, dump_len;
+    trace_image_t image = {0};
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s image dump\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    uint8_t *elf = read_file(argv[1], &image_len);
+    uint8_t *dump = read_file(argv[2], &dump_len);
+    if (elf == NULL || dump == NULL || !load_image(elf, image_len, &image))
+    {
+        return EXIT_FAILURE;
+    }
+    if (dump_len > 0 && dump[0] == ':')
+    {
+        uint8_t *flat = parse_hex(dump, dump_len, &dump_len);
+        free(dump);
+        dump = flat;
+        if (dump == NULL)
+        {
+            fprintf(stderr, "%s: bad Intel HEX file\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+    }
+    const trace_ring_t *ring = find_ring(dump, dump_len);
+    if (ring == NULL)
+    {
+        fprintf(stderr, "%s: no trace ring found\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t count = ring->head < TRACE_RING_RECORDS ? ring->head : TRACE_RING_RECORDS;
+    uint32_t bad = 0;
+    uint64_t elapsed = 0;
+    uint32_t last_time = 0;
+    for (uint32_t i = ring->head - count; i != ring->head; i++)
+    {
+        const trace_record_t *record = &ring->records[i & (TRACE_RING_RECORDS - 1)];
+        //Arithmetic shift keeps the sign of the offset
+        int64_t offset = (int32_t)record->header >> 4;
+        uint32_t nargs = record->header & 0xF;
+        uint64_t addr = image.anchor_addr + offset;
+
+        //The string has to end inside the section too, it may be a whole flash region
+        if (addr < image.fmt_addr || addr >= image.fmt_addr + image.fmt_size || nargs > TRACE_MAX_ARGS ||
+            memchr(image.fmt + (addr - image.fmt_addr), 0, image.fmt_addr + image.fmt_size - addr) == NULL)
+        {
+            bad++;
+            continue;
+        }
+        if (i != ring->head - count)
+        {
+            elapsed += (uint32_t)(record->time - last_time);
+        }
+        last_time = record->time;
+
+        const char *fmt = (const char *)image.fmt + (addr - image.fmt_addr);
+        printf("%12.6f  ", (double)elapsed / HAL_CYCLE_HZ);
+        print_record(fmt, record->args, nargs);
+        putchar('\n');
+    }
+
+    fprintf(stderr, "%u records (%u written since boot, %u lost to wrap), %u not in the image\n",
+            count, ring->head, ring->head - count, bad);
+    free(elf);
+    free(dump);
+    return bad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+    * @file    host/tools/trig_lut_gen
+    * @date    16-October-2026
+    * @brief   Writes user/user_lib/trig_lut_table.c, the Q15 quarter wave sine
+    *          table of user_lib/trig_lut, sized from trig_lut.h.
+    * @attention Usage: trig_lut_gen > user/user_lib/trig_lut_table.c
+  ******************************************************************************
+**/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trig_lut.h"
+
+//Entries per line of the generated file
+#define GEN_PER_LINE 12
+
+int main(void)
+{
+    printf("/**\n"
+           "  ******************************************************************************\n"
+           "    * @file    user_lib/trig_lut_table\n"
+           "    * @brief   Quarter wave Q15 sine table for trig_lut.c.\n"
+           "    * @attention Generated by host/tools/trig_lut_gen, do not edit.\n"
+           "  ******************************************************************************\n"
+           "**/\n\n"
+           "#include \"trig_lut.h\"\n\n"
+           "const int16_t trig_lut_quarter_sin[TRIG_LUT_QUARTER + 1] = {\n");
+    for (int i = 0; i <= TRIG_LUT_QUARTER; i++)
+    {
+        long value = lround(TRIG_LUT_ONE * sin(2.0 * M_PI * i / TRIG_LUT_ECD_RANGE));
+        printf("%s%ld,%s", i % GEN_PER_LINE ? " " : "    ", value,
+               i % GEN_PER_LINE == GEN_PER_LINE - 1 || i == TRIG_LUT_QUARTER ? "\n" : "");
+    }
+    printf("};\n");
+    return EXIT_SUCCESS;
+}
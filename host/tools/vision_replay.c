@@ -0,0 +1,304 @@
+/**
+  ******************************************************************************
+    * @file    host/tools/vision_replay
+    * @date    16-October-2026
+    * @brief   Stand-in for the vision PC. Sends target frames (see APP/vision/vision.h)
+    *          on a pseudo terminal, or a serial port wired to USART6, at a fixed
+    *          rate. Each frame is held back by the configured latency like a real
+    *          detection pipeline: the target is sampled at capture time and the
+    *          frame leaves latency (+ jitter) later, with latency_us filled in.
+    * @attention Usage: vision_replay [-r hz] [-l ms] [-j ms] [-t s] [-d device] [track]
+    *              -r hz      frame rate of synthetic tracks, default 100
+    *              -l ms      capture to send latency, default 30
+    *              -j ms      uniform extra latency 0 ~ ms per frame, default 0
+    *              -t s       length of synthetic tracks, default 10
+    *              -d device  serial port to use instead of a new pty, set to 115200 (USART6_BAUDRATE)
+    *              track      static, strafe or circle, or a CSV file of
+    *                         t_s,valid,yaw_rad,pitch_rad,distance_m rows sent at t_s
+    *          The pty's name is printed to stderr; open it raw on the other end.
+    *          Frames nobody reads are dropped rather than queued, like on a wire.
+  ******************************************************************************
+**/
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vision.h"
+
+//Robot at the origin facing +x, z up, metres
+#define REPLAY_TARGET_HEIGHT 0.2
+#define REPLAY_STRAFE_DISTANCE 3.0
+#define REPLAY_STRAFE_AMPLITUDE 1.0
+#define REPLAY_STRAFE_HZ 0.5
+#define REPLAY_CIRCLE_DISTANCE 4.0
+#define REPLAY_CIRCLE_RADIUS 0.3
+#define REPLAY_CIRCLE_HZ 1.0
+
+typedef enum
+{
+    REPLAY_TRACK_STATIC = 0,
+    REPLAY_TRACK_STRAFE,
+    REPLAY_TRACK_CIRCLE,
+    REPLAY_TRACK_NUM,
+} replay_track_e;
+
+static const char *const track_name[REPLAY_TRACK_NUM] = {"static", "strafe", "circle"};
+
+typedef struct
+{
+    uint32_t sent;
+    uint32_t dropped;
+} replay_stats_t;
+
+static int out_fd = -1;
+//Our end of the pty's slave side, flushed when nobody reads it
+static int pty_slave_fd = -1;
+static replay_stats_t stats;
+static uint8_t seq;
+static fp64 last_send_s;
+
+static fp64 now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void sleep_until(fp64 t_s)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)t_s;
+    ts.tv_nsec = (long)((t_s - ts.tv_sec) * 1e9);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+}
+
+/**
+ * @brief  Target direction of a synthetic track
+ * @param  track track to sample
+ * @param  t_s time since the start
+ * @param  frame yaw, pitch and distance filled in
+ * @retval None
+ */
+static void sample_track(replay_track_e track, fp64 t_s, vision_frame_t *frame)
+{
+    fp64 x = REPLAY_STRAFE_DISTANCE, y = 0.0, z = REPLAY_TARGET_HEIGHT;
+
+    switch (track)
+    {
+    case REPLAY_TRACK_STRAFE:
+        y = REPLAY_STRAFE_AMPLITUDE * sin(2.0 * M_PI * REPLAY_STRAFE_HZ * t_s);
+        break;
+    case REPLAY_TRACK_CIRCLE:
+        //An armour plate on a spinning robot, the near side of the circle faces us
+        x = REPLAY_CIRCLE_DISTANCE - REPLAY_CIRCLE_RADIUS * cos(2.0 * M_PI * REPLAY_CIRCLE_HZ * t_s);
+        y = REPLAY_CIRCLE_RADIUS * sin(2.0 * M_PI * REPLAY_CIRCLE_HZ * t_s);
+        break;
+    default:
+        break;
+    }
+    frame->yaw = (fp32)atan2(y, x);
+    frame->pitch = (fp32)atan2(z, hypot(x, y));
+    frame->distance = (fp32)sqrt(x * x + y * y + z * z);
+}
+
+/**
+ * @brief  Sends a frame captured at capture_s once its latency has passed
+ * @param  start_s clock at t = 0
+ * @param  capture_s capture time since the start
+ * @param  latency_s capture to send
+ * @param  frame target, seq, timestamp and latency are filled in here
+ * @retval None
+ */
+static void send_frame(fp64 start_s, fp64 capture_s, fp64 latency_s, vision_frame_t *frame)
+{
+    uint8_t buf[VISION_FRAME_LEN];
+    //A pipeline does not reorder its output
+    fp64 send_s = capture_s + latency_s > last_send_s ? capture_s + latency_s : last_send_s;
+
+    last_send_s = send_s;
+    sleep_until(start_s + send_s);
+    frame->seq = seq++;
+    frame->timestamp_us = (uint32_t)(capture_s * 1e6);
+    frame->latency_us = (uint32_t)((now_s() - start_s - capture_s) * 1e6);
+    vision_frame_pack(frame, buf);
+
+    ssize_t n = write(out_fd, buf, sizeof(buf));
+    if (n < 0 && errno == EAGAIN && pty_slave_fd >= 0)
+    {
+        //Nobody is reading, throw away what is queued so a late reader gets fresh frames
+        tcflush(pty_slave_fd, TCIFLUSH);
+        n = write(out_fd, buf, sizeof(buf));
+    }
+    if (n == (ssize_t)sizeof(buf))
+    {
+        stats.sent++;
+    }
+    else
+    {
+        stats.dropped++;
+    }
+}
+
+static int open_pty(void)
+{
+    struct termios tio;
+    int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0)
+    {
+        perror("pty");
+        return -1;
+    }
+    //Keep the slave open and raw: no EIO before a reader comes, and no line discipline
+    //turning 0x0D into 0x0A on the way through
+    pty_slave_fd = open(ptsname(fd), O_RDWR | O_NOCTTY);
+    if (pty_slave_fd < 0 || tcgetattr(pty_slave_fd, &tio) < 0)
+    {
+        perror(ptsname(fd));
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(pty_slave_fd, TCSANOW, &tio);
+    fprintf(stderr, "vision frames on %s\n", ptsname(fd));
+    return fd;
+}
+
+static int open_serial(const char *path)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if (fd < 0 || tcgetattr(fd, &tio) < 0)
+    {
+        perror(path);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, B115200);
+    tcsetattr(fd, TCSANOW, &tio);
+    return fd;
+}
+
+static int replay_csv(FILE *in, fp64 latency_s, fp64 jitter_s)
+{
+    char line[256];
+    fp64 start_s = now_s();
+
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        vision_frame_t frame = {0};
+        fp64 t_s, yaw, pitch, distance;
+        int valid;
+
+        //Header and comment lines do not parse
+        if (sscanf(line, "%lf,%d,%lf,%lf,%lf", &t_s, &valid, &yaw, &pitch, &distance) != 5)
+        {
+            continue;
+        }
+        frame.flags = valid ? VISION_FLAG_TARGET : 0;
+        frame.yaw = (fp32)yaw;
+        frame.pitch = (fp32)pitch;
+        frame.distance = (fp32)distance;
+        send_frame(start_s, t_s, latency_s + jitter_s * rand() / RAND_MAX, &frame);
+    }
+    return stats.sent > 0;
+}
+
+static int replay_track(replay_track_e track, fp64 rate_hz, fp64 length_s, fp64 latency_s, fp64 jitter_s)
+{
+    fp64 start_s = now_s();
+
+    for (uint32_t k = 0; k < length_s * rate_hz; k++)
+    {
+        vision_frame_t frame = {.flags = VISION_FLAG_TARGET};
+        fp64 capture_s = k / rate_hz;
+
+        sample_track(track, capture_s, &frame);
+        send_frame(start_s, capture_s, latency_s + jitter_s * rand() / RAND_MAX, &frame);
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    fp64 rate_hz = 100.0, latency_s = 0.030, jitter_s = 0.0, length_s = 10.0;
+    const char *device = NULL;
+    const char *track = track_name[REPLAY_TRACK_STRAFE];
+    int arg = 1;
+
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2)
+    {
+        const char *value = argv[arg + 1];
+        if (strcmp(argv[arg], "-r") == 0)
+        {
+            rate_hz = atof(value);
+        }
+        else if (strcmp(argv[arg], "-l") == 0)
+        {
+            latency_s = atof(value) * 1e-3;
+        }
+        else if (strcmp(argv[arg], "-j") == 0)
+        {
+            jitter_s = atof(value) * 1e-3;
+        }
+        else if (strcmp(argv[arg], "-t") == 0)
+        {
+            length_s = atof(value);
+        }
+        else if (strcmp(argv[arg], "-d") == 0)
+        {
+            device = value;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (arg < argc)
+    {
+        track = argv[arg++];
+    }
+    if (arg < argc || rate_hz <= 0.0 || latency_s < 0.0 || jitter_s < 0.0)
+    {
+        fprintf(stderr, "usage: %s [-r hz] [-l ms] [-j ms] [-t s] [-d device] [static|strafe|circle|file.csv]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    replay_track_e synthetic = REPLAY_TRACK_NUM;
+    FILE *csv = NULL;
+    for (replay_track_e t = REPLAY_TRACK_STATIC; t < REPLAY_TRACK_NUM; t++)
+    {
+        if (strcmp(track, track_name[t]) == 0)
+        {
+            synthetic = t;
+        }
+    }
+    if (synthetic == REPLAY_TRACK_NUM && (csv = fopen(track, "r")) == NULL)
+    {
+        perror(track);
+        return EXIT_FAILURE;
+    }
+
+    out_fd = device != NULL ? open_serial(device) : open_pty();
+    if (out_fd < 0)
+    {
+        return EXIT_FAILURE;
+    }
+    int ok = csv != NULL ? replay_csv(csv, latency_s, jitter_s)
+                         : replay_track(synthetic, rate_hz, length_s, latency_s, jitter_s);
+
+    fprintf(stderr, "%u frames sent, %u dropped\n", stats.sent, stats.dropped);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
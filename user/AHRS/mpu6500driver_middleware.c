@@ -23,6 +23,7 @@
 #if defined(MPU6500_USE_SPI)
 
 #include "spi.h"
+#include "hal.h"
 
 #elif defined(MPU6500_USE_IIC)
 
@@ -87,30 +88,7 @@ void mpu6500_SPI_NS_L(void)
 
 static uint8_t mpu6500_SPI_read_write_byte(uint8_t TxData)
 {
-    uint8_t retry = 0;
-    while (SPI_I2S_GetFlagStatus(SPI5, SPI_I2S_FLAG_TXE) == RESET)
-    {
-        retry++;
-        if (retry > 200)
-        {
-            return 0;
-        }
-    }
-
-    SPI_I2S_SendData(SPI5, TxData);
-
-    retry = 0;
-
-    while (SPI_I2S_GetFlagStatus(SPI5, SPI_I2S_FLAG_RXNE) == RESET)
-    {
-        retry++;
-        if (retry > 200)
-        {
-            return 0;
-        }
-    }
-
-    return SPI_I2S_ReceiveData(SPI5);
+    return hal_spi_read_write_byte(HAL_SPI5, TxData);
 }
 void mpu6500_write_single_reg(uint8_t reg, uint8_t data)
 {
@@ -0,0 +1,239 @@
+/**
+  ******************************************************************************
+    * @file    APP/CAN_filter
+    * @date    16-October-2026
+    * @brief   Packs subscribed CAN IDs into bxCAN filter banks, see CAN_filter.h
+  ******************************************************************************
+**/
+
+#include "CAN_filter.h"
+
+//16-bit filter register layout: STDID[10:0] RTR IDE EXID[17:15]
+#define FILTER_REG(id) ((uint16_t)((id) << 5))
+//Mask entries also require RTR = 0 and IDE = 0, list entries match them exactly anyway
+#define FILTER_MASK_REG(mask) ((uint16_t)(((mask) << 5) | 0x18))
+#define STD_ID_MASK 0x7FFu
+//Smallest block worth a mask entry, a pair of IDs fits the same half bank as two list entries
+#define MIN_MASK_BLOCK 4u
+
+typedef struct
+{
+    uint16_t list[CAN_FILTER_MAX_IDS];
+    uint16_t list_num;
+    uint16_t mask_id[CAN_FILTER_MAX_IDS];
+    uint16_t mask[CAN_FILTER_MAX_IDS];
+    uint16_t mask_num;
+} fifo_entries_t;
+
+static uint16_t collect_fifo_ids(const can_filter_id_t *ids, uint16_t n, uint8_t fifo, uint16_t *out);
+static void split_exact(const uint16_t *sorted, uint16_t n, fifo_entries_t *entries);
+static void collapse_to_mask(const uint16_t *sorted, uint16_t n, fifo_entries_t *entries);
+static uint8_t banks_needed(const fifo_entries_t *entries);
+static uint8_t emit_banks(const fifo_entries_t *entries, uint8_t fifo, hal_can_filter_bank_t *banks);
+
+
+/**
+* @brief  Packs subscribed IDs into filter banks, exact when they fit
+* @param  ids: subscribed IDs and the FIFO each should land in, duplicates are allowed
+* @param  n: number of ids, at most CAN_FILTER_MAX_IDS are used
+* @param  banks: filled with up to max_banks banks
+* @param  max_banks: banks available on the bus, at least 2
+* @retval Number of banks filled
+*/
+uint8_t CAN_filter_pack(const can_filter_id_t *ids, uint16_t n, hal_can_filter_bank_t *banks, uint8_t max_banks)
+{
+    static uint16_t sorted[2][CAN_FILTER_MAX_IDS];
+    static fifo_entries_t entries[2];
+    uint16_t count[2];
+    uint8_t used = 0;
+
+    if (n > CAN_FILTER_MAX_IDS)
+    {
+        n = CAN_FILTER_MAX_IDS;
+    }
+
+    for (uint8_t fifo = 0; fifo < 2; fifo++)
+    {
+        count[fifo] = collect_fifo_ids(ids, n, fifo, sorted[fifo]);
+        split_exact(sorted[fifo], count[fifo], &entries[fifo]);
+    }
+
+    //Too many entries: give up exactness on the FIFO with the most banks first
+    while (banks_needed(&entries[0]) + banks_needed(&entries[1]) > max_banks)
+    {
+        uint8_t fifo = banks_needed(&entries[0]) >= banks_needed(&entries[1]) ? 0 : 1;
+        if (banks_needed(&entries[fifo]) <= 1)
+        {
+            fifo = 1 - fifo;
+        }
+        if (banks_needed(&entries[fifo]) <= 1)
+        {
+            break;
+        }
+        collapse_to_mask(sorted[fifo], count[fifo], &entries[fifo]);
+    }
+
+    for (uint8_t fifo = 0; fifo < 2; fifo++)
+    {
+        used += emit_banks(&entries[fifo], fifo, &banks[used]);
+    }
+    return used;
+}
+
+
+/**
+* @brief  Software model of the bxCAN acceptance test, for checking packed banks and
+*         for the host HAL. The first bank that accepts the frame picks its FIFO
+* @param  banks: banks as filled by CAN_filter_pack
+* @param  bank_num: number of banks
+* @param  std_id: standard ID of a data frame
+* @retval FIFO of the accepting bank, -1 if the frame is dropped
+*/
+int8_t CAN_filter_match(const hal_can_filter_bank_t *banks, uint8_t bank_num, uint16_t std_id)
+{
+    uint16_t reg = FILTER_REG(std_id);
+
+    for (uint8_t i = 0; i < bank_num; i++)
+    {
+        const hal_can_filter_bank_t *bank = &banks[i];
+        if (bank->mask_mode)
+        {
+            if (((reg ^ bank->reg[0]) & bank->reg[1]) == 0 || ((reg ^ bank->reg[2]) & bank->reg[3]) == 0)
+            {
+                return (int8_t)bank->fifo;
+            }
+        }
+        else
+        {
+            for (uint8_t k = 0; k < 4; k++)
+            {
+                if (reg == bank->reg[k])
+                {
+                    return (int8_t)bank->fifo;
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+
+/******************** Private Function Implementations ********************/
+
+//Gathers the IDs of one FIFO, sorted and without duplicates. Returns how many
+static uint16_t collect_fifo_ids(const can_filter_id_t *ids, uint16_t n, uint8_t fifo, uint16_t *out)
+{
+    uint16_t count = 0;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        if (ids[i].fifo != fifo)
+        {
+            continue;
+        }
+        //Insertion sort, n is small and this only runs at init
+        uint16_t id = ids[i].std_id & STD_ID_MASK;
+        uint16_t pos = count;
+        while (pos > 0 && out[pos - 1] > id)
+        {
+            pos--;
+        }
+        if (pos > 0 && out[pos - 1] == id)
+        {
+            continue;
+        }
+        for (uint16_t k = count; k > pos; k--)
+        {
+            out[k] = out[k - 1];
+        }
+        out[pos] = id;
+        count++;
+    }
+    return count;
+}
+
+//Covers the IDs with the largest aligned blocks that contain only subscribed IDs
+static void split_exact(const uint16_t *sorted, uint16_t n, fifo_entries_t *entries)
+{
+    uint16_t i = 0;
+
+    entries->list_num = 0;
+    entries->mask_num = 0;
+    while (i < n)
+    {
+        uint16_t id = sorted[i];
+        uint16_t block = 1;
+
+        //Grow while the doubled block stays aligned and every ID in it is present
+        while (block < 0x400 && (id & (2 * block - 1)) == 0 && i + 2 * block <= n &&
+               sorted[i + 2 * block - 1] == id + 2 * block - 1)
+        {
+            block *= 2;
+        }
+
+        if (block >= MIN_MASK_BLOCK)
+        {
+            entries->mask_id[entries->mask_num] = id;
+            entries->mask[entries->mask_num] = STD_ID_MASK & ~(block - 1);
+            entries->mask_num++;
+        }
+        else
+        {
+            for (uint16_t k = 0; k < block; k++)
+            {
+                entries->list[entries->list_num++] = id + k;
+            }
+        }
+        i += block;
+    }
+}
+
+//Replaces all entries by one mask keeping only the bits every ID agrees on
+static void collapse_to_mask(const uint16_t *sorted, uint16_t n, fifo_entries_t *entries)
+{
+    uint16_t mask = STD_ID_MASK;
+
+    for (uint16_t i = 1; i < n; i++)
+    {
+        mask &= ~(sorted[i] ^ sorted[0]);
+    }
+    entries->list_num = 0;
+    entries->mask_num = 1;
+    entries->mask_id[0] = sorted[0] & mask;
+    entries->mask[0] = mask;
+}
+
+static uint8_t banks_needed(const fifo_entries_t *entries)
+{
+    return (entries->list_num + 3) / 4 + (entries->mask_num + 1) / 2;
+}
+
+//Writes the entries of one FIFO as banks, unused slots repeat the last entry
+static uint8_t emit_banks(const fifo_entries_t *entries, uint8_t fifo, hal_can_filter_bank_t *banks)
+{
+    uint8_t used = 0;
+
+    for (uint16_t i = 0; i < entries->list_num; i += 4)
+    {
+        hal_can_filter_bank_t *bank = &banks[used++];
+        bank->mask_mode = 0;
+        bank->fifo = fifo;
+        for (uint8_t k = 0; k < 4; k++)
+        {
+            uint16_t src = i + k < entries->list_num ? i + k : entries->list_num - 1;
+            bank->reg[k] = FILTER_REG(entries->list[src]);
+        }
+    }
+    for (uint16_t i = 0; i < entries->mask_num; i += 2)
+    {
+        hal_can_filter_bank_t *bank = &banks[used++];
+        uint16_t second = i + 1 < entries->mask_num ? i + 1 : i;
+        bank->mask_mode = 1;
+        bank->fifo = fifo;
+        bank->reg[0] = FILTER_REG(entries->mask_id[i]);
+        bank->reg[1] = FILTER_MASK_REG(entries->mask[i]);
+        bank->reg[2] = FILTER_REG(entries->mask_id[second]);
+        bank->reg[3] = FILTER_MASK_REG(entries->mask[second]);
+    }
+    return used;
+}
@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+    * @file    APP/CAN_filter
+    * @date    16-October-2026
+    * @brief   Packs a set of subscribed standard CAN IDs into bxCAN filter banks so
+    *          that only frames somebody handles ever reach the receive interrupt.
+    *          Runs of IDs that fill an aligned power of two block of 4 or more
+    *          become one mask entry, every other ID becomes a list entry. If the
+    *          exact packing needs more banks than the bus has, each FIFO falls back
+    *          to a single mask that passes a superset of its IDs.
+    * @attention Pure computation, the banks are written by hal_can_set_filters.
+  ******************************************************************************
+**/
+
+#ifndef CAN_FILTER_H
+#define CAN_FILTER_H
+#include "main.h"
+#include "hal.h"
+
+//Most IDs one bus can subscribe to
+#define CAN_FILTER_MAX_IDS 64
+
+typedef struct
+{
+    uint16_t std_id;
+    uint8_t fifo;       //0 or 1
+} can_filter_id_t;
+
+//Fills banks from ids, returns the number of banks used (0 if n is 0)
+extern uint8_t CAN_filter_pack(const can_filter_id_t *ids, uint16_t n, hal_can_filter_bank_t *banks, uint8_t max_banks);
+//FIFO a standard data frame with std_id lands in, -1 if no bank passes it
+extern int8_t CAN_filter_match(const hal_can_filter_bank_t *banks, uint8_t bank_num, uint16_t std_id);
+
+#endif
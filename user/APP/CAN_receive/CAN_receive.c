@@ -20,43 +20,336 @@
 
 
 /******************** User Includes ********************/
-#include "CAN_Receive.h"
-
-#include "stm32f4xx.h"
-#include "rng.h"
+#include "CAN_receive.h"
+#include "CAN_filter.h"
+#include "control_tick.h"
 
 #include "FreeRTOSConfig.h"
 #include "FreeRTOS.h"
 #include "task.h"
-#include "led.h"
-#include "delay.h"
-
 
+#include <string.h>
 
-/******************** Private Defines for Receiving ********************/
 
-#define fill_motor_readings(ptr, rx_message)                                                     \
-    {                                                                                          \
-        (ptr)->last_ecd = (ptr)->ecd;                                                          \
-        (ptr)->ecd = (uint16_t)((rx_message)->Data[0] << 8 | (rx_message)->Data[1]);           \
-        (ptr)->speed_rpm = (uint16_t)((rx_message)->Data[2] << 8 | (rx_message)->Data[3]);     \
-        (ptr)->current_read = (uint16_t)((rx_message)->Data[4] << 8 | (rx_message)->Data[5]); \
-        (ptr)->temperate = (rx_message)->Data[6];                                              \
-    }
 
 /******************** Private User Declarations ********************/
 		
+//Motor feedback IDs 0x200 ~ 0x20F are looked up by direct index
+#define CAN_RX_MOTOR_BLOCK_BASE 0x200u
+#define CAN_RX_MOTOR_BLOCK_SIZE 16u
+//Every other ID goes in an open addressing hash table, size must be a power of 2
+#define CAN_RX_HASH_SIZE 16u
+#define CAN_RX_HASH(id) (((id) ^ ((id) >> 4) ^ ((id) >> 8)) & (CAN_RX_HASH_SIZE - 1))
+
+typedef struct
+{
+    uint32_t std_id;
+    can_rx_priority_e priority;
+    can_rx_handler_f handler;
+    void *dest;
+} can_rx_entry_t;
+
+//Receive FIFO each priority is filtered into
+static const uint8_t can_rx_priority_fifo[CAN_RX_PRIORITY_NUM] = {HAL_CAN_FIFO0, HAL_CAN_FIFO1};
+
+//Shared body of the receive interrupts
+static void CAN_rx_irq(hal_can_e can, hal_can_fifo_e fifo);
+//Moves queued frames into free TX mailboxes
+static void CAN_tx_flush(hal_can_e can);
 //CAN received data handler
-static void CAN_hook(CanRxMsg *rx_message);
+static void CAN_hook(hal_can_e can, hal_can_frame_t *rx_message);
+//Registration table lookup
+static can_rx_entry_t *find_rx_entry(hal_can_e can, uint32_t std_id);
+//Handler registered for every RM motor ID
+static void motor_feedback_handler(const hal_can_frame_t *rx_message, void *dest);
+//Seqlock writer of a motor frame, also unwraps the position and filters the speed
+static void fill_motor_readings(motor_feedback_t *motor, const hal_can_frame_t *rx_message);
+//Updates the receive statistics of a motor ID
+static void update_rx_stats(uint32_t std_id);
+//Age of a motor's snapshot, latched at CAN_FEEDBACK_AGE_LIMIT_US
+static uint32_t motor_feedback_age_us(uint8_t index, const motor_feedback_t *snapshot);
+//Registration tables, per bus
+static can_rx_entry_t can_rx_motor_block[HAL_CAN_NUM][CAN_RX_MOTOR_BLOCK_SIZE];
+static can_rx_entry_t can_rx_hash[HAL_CAN_NUM][CAN_RX_HASH_SIZE];
+static uint32_t can_unknown_id_count[HAL_CAN_NUM];
+static uint32_t can_last_unknown_id[HAL_CAN_NUM];
+static can_rx_bus_stats_t can_rx_bus_stats[HAL_CAN_NUM];
+
+//Frames waiting for a free TX mailbox, per bus
+#define CAN_TX_QUEUE_LEN 8
+typedef struct
+{
+    hal_can_frame_t frames[CAN_TX_QUEUE_LEN];
+    uint8_t head;
+    uint8_t count;
+    can_tx_stats_t stats;
+} can_tx_queue_t;
+static can_tx_queue_t can_tx_queue[HAL_CAN_NUM];
 //motor measure pointers declaration
 static motor_feedback_t motor_yaw, motor_pit, motor_trigger, motor_hopper, motor_chassis[4];
+//Same motors indexed by ID - CAN_3508_M1_ID, and their copies taken at the last control tick
+static motor_feedback_t *const motor_by_index[CAN_MOTOR_NUM] = {
+    &motor_chassis[0], &motor_chassis[1], &motor_chassis[2], &motor_chassis[3],
+    &motor_yaw, &motor_pit, &motor_trigger, &motor_hopper};
+static motor_feedback_t motor_latched[CAN_MOTOR_NUM];
+//receive statistics, indexed by ID - CAN_3508_M1_ID
+static motor_rx_stats_t motor_rx_stats[CAN_MOTOR_NUM];
+static uint32_t motor_last_rx_time[CAN_MOTOR_NUM];
+//seq of the frame after which each motor went silent for CAN_FEEDBACK_AGE_LIMIT_US. Its age
+//stays at the limit until a new frame changes seq, so it never wraps back to fresh
+static uint32_t motor_silent_seq[CAN_MOTOR_NUM];
 //CAN transmit message struct declaration
-static CanTxMsg GIMBAL_TxMessage;
+static hal_can_frame_t GIMBAL_TxMessage;
 		
 
 		
+/******************** Public CAN Setup Functions ********************/
+
+/**
+* @brief  Clears the registration tables and registers the chassis and gimbal motors.
+*         Must run before the CAN receive interrupts are enabled. The filter banks are
+*         left alone, CAN_update_filters programs them once the buses are up.
+* @param  None
+* @retval None
+*/
+void CAN_receive_init(void)
+{
+    memset(can_rx_motor_block, 0, sizeof(can_rx_motor_block));
+    memset(can_rx_hash, 0, sizeof(can_rx_hash));
+    memset(can_unknown_id_count, 0, sizeof(can_unknown_id_count));
+    memset(can_last_unknown_id, 0, sizeof(can_last_unknown_id));
+    memset(can_rx_bus_stats, 0, sizeof(can_rx_bus_stats));
+    memset(can_tx_queue, 0, sizeof(can_tx_queue));
+    memset(motor_latched, 0, sizeof(motor_latched));
+    memset(motor_silent_seq, 0, sizeof(motor_silent_seq));
+    //Unwrapping restarts from the next frame
+    for (uint8_t i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        memset(motor_by_index[i], 0, sizeof(motor_feedback_t));
+    }
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        CAN_register_rx_handler(CHASSIS_CAN, CAN_3508_M1_ID + i, CAN_RX_PRIORITY_HIGH, motor_feedback_handler, &motor_chassis[i]);
+        CAN_set_motor_gear_ratio(CAN_3508_M1_ID + i, M3508_GEAR_NUM, M3508_GEAR_DEN);
+    }
+    CAN_register_rx_handler(GIMBAL_CAN, CAN_YAW_MOTOR_ID, CAN_RX_PRIORITY_HIGH, motor_feedback_handler, &motor_yaw);
+    CAN_register_rx_handler(GIMBAL_CAN, CAN_PIT_MOTOR_ID, CAN_RX_PRIORITY_HIGH, motor_feedback_handler, &motor_pit);
+    CAN_register_rx_handler(GIMBAL_CAN, CAN_TRIGGER_MOTOR_ID, CAN_RX_PRIORITY_HIGH, motor_feedback_handler, &motor_trigger);
+    CAN_register_rx_handler(GIMBAL_CAN, CAN_HOPPER_MOTOR_ID, CAN_RX_PRIORITY_HIGH, motor_feedback_handler, &motor_hopper);
+    CAN_set_motor_gear_ratio(CAN_YAW_MOTOR_ID, GM6020_GEAR_NUM, GM6020_GEAR_DEN);
+    CAN_set_motor_gear_ratio(CAN_PIT_MOTOR_ID, GM6020_GEAR_NUM, GM6020_GEAR_DEN);
+    CAN_set_motor_gear_ratio(CAN_TRIGGER_MOTOR_ID, P36_GEAR_NUM, P36_GEAR_DEN);
+    CAN_set_motor_gear_ratio(CAN_HOPPER_MOTOR_ID, P36_GEAR_NUM, P36_GEAR_DEN);
+}
+
+
+/**
+* @brief  Sets the gearbox between a motor's rotor and its output shaft. The CAN interrupt
+*         always tracks the rotor, the ratio only scales what get_motor_output_* return.
+* @param  id: feedback ID of the motor, CAN_3508_M1_ID ~ CAN_HOPPER_MOTOR_ID
+* @param  gear_num, gear_den: rotor turns per output turn as a fraction, neither 0
+* @retval None
+*/
+void CAN_set_motor_gear_ratio(can_msg_id_e id, uint16_t gear_num, uint16_t gear_den)
+{
+    uint32_t index = id - CAN_3508_M1_ID;
+    if (index >= CAN_MOTOR_NUM || gear_num == 0 || gear_den == 0)
+    {
+        return;
+    }
+
+    motor_feedback_t *motor = motor_by_index[index];
+    uint32_t irq_state = hal_irq_disable();
+    motor->gear_num = gear_num;
+    motor->gear_den = gear_den;
+    hal_irq_restore(irq_state);
+}
+
+
+/**
+* @brief  Reprograms the hardware filter banks of both buses from the registration tables,
+*         so frames nobody handles are dropped before they raise an interrupt. Call again
+*         after registering handlers outside CAN_receive_init.
+* @param  None
+* @retval None
+*/
+void CAN_update_filters(void)
+{
+    static can_filter_id_t ids[CAN_RX_MOTOR_BLOCK_SIZE + CAN_RX_HASH_SIZE];
+    static hal_can_filter_bank_t banks[HAL_CAN_FILTER_BANKS];
+
+    for (hal_can_e can = HAL_CAN1; can < HAL_CAN_NUM; can++)
+    {
+        uint16_t n = 0;
+        for (uint8_t i = 0; i < CAN_RX_MOTOR_BLOCK_SIZE + CAN_RX_HASH_SIZE; i++)
+        {
+            const can_rx_entry_t *entry = i < CAN_RX_MOTOR_BLOCK_SIZE ? &can_rx_motor_block[can][i]
+                                                                       : &can_rx_hash[can][i - CAN_RX_MOTOR_BLOCK_SIZE];
+            if (entry->handler != NULL)
+            {
+                ids[n].std_id = entry->std_id;
+                ids[n].fifo = can_rx_priority_fifo[entry->priority];
+                n++;
+            }
+        }
+        hal_can_set_filters(can, banks, CAN_filter_pack(ids, n, banks, HAL_CAN_FILTER_BANKS));
+    }
+}
+
+
+/**
+* @brief  Routes every frame with std_id received on a bus to handler. Registering an ID
+*         again replaces its handler. Not safe against the receive interrupt, call at init.
+* @param  can: bus the frames arrive on
+* @param  std_id: standard CAN ID
+* @param  priority: high for control loop feedback, low for everything else
+* @param  handler: called from the CAN receive interrupt with the frame and dest
+* @param  dest: passed to handler untouched, usually the struct the frame is decoded into
+* @retval 1 on success, 0 if the hash table of the bus is full
+*/
+uint8_t CAN_register_rx_handler(hal_can_e can, uint32_t std_id, can_rx_priority_e priority, can_rx_handler_f handler, void *dest)
+{
+    can_rx_entry_t *entry = find_rx_entry(can, std_id);
+
+    if (entry == NULL)
+    {
+        //Not registered and outside the motor block: take the first free hash slot
+        uint32_t slot = CAN_RX_HASH(std_id);
+        for (uint8_t probe = 0; probe < CAN_RX_HASH_SIZE && entry == NULL; probe++)
+        {
+            if (can_rx_hash[can][slot].handler == NULL)
+            {
+                entry = &can_rx_hash[can][slot];
+            }
+            slot = (slot + 1) & (CAN_RX_HASH_SIZE - 1);
+        }
+        if (entry == NULL)
+        {
+            return 0;
+        }
+    }
+
+    entry->std_id = std_id;
+    entry->priority = priority;
+    entry->dest = dest;
+    entry->handler = handler;
+    return 1;
+}
+
+
+//Number of frames received on a bus with no registered handler
+uint32_t get_CAN_unknown_id_count(hal_can_e can)
+{
+    return can_unknown_id_count[can];
+}
+
+
+//Most recent unregistered ID seen on a bus
+uint32_t get_CAN_last_unknown_id(hal_can_e can)
+{
+    return can_last_unknown_id[can];
+}
+
+
+//Copies the receive interrupt counters of a bus
+void get_CAN_rx_bus_stats(hal_can_e can, can_rx_bus_stats_t *stats)
+{
+    uint32_t irq_state = hal_irq_disable();
+    *stats = can_rx_bus_stats[can];
+    hal_irq_restore(irq_state);
+}
+
+
+
 /******************** Public CAN Write Functions ********************/
 
+/**
+* @brief  Queues a frame for transmission without blocking. If a frame with the same ID is
+*         still waiting, its data is replaced so only the latest command goes out. Frames go
+*         straight into a free mailbox when there is one, the rest are sent from the TX
+*         mailbox empty interrupt. Safe to call from tasks and interrupts.
+* @param  can: bus to send on
+* @param  frame: frame to send, copied
+* @retval 1 if queued, 0 if the queue was full and the oldest waiting frame was dropped for it
+*/
+uint8_t CAN_send(hal_can_e can, const hal_can_frame_t *frame)
+{
+    can_tx_queue_t *queue = &can_tx_queue[can];
+    uint8_t queued = 1;
+    uint32_t irq_state = hal_irq_disable();
+
+    queue->stats.requested++;
+
+    //Coalesce with a waiting frame of the same ID
+    for (uint8_t i = 0; i < queue->count; i++)
+    {
+        hal_can_frame_t *waiting = &queue->frames[(queue->head + i) % CAN_TX_QUEUE_LEN];
+        if (waiting->std_id == frame->std_id)
+        {
+            *waiting = *frame;
+            queue->stats.coalesced++;
+            CAN_tx_flush(can);
+            hal_irq_restore(irq_state);
+            return 1;
+        }
+    }
+
+    if (queue->count == CAN_TX_QUEUE_LEN)
+    {
+        //Commands go stale, keep the newest
+        queue->head = (queue->head + 1) % CAN_TX_QUEUE_LEN;
+        queue->count--;
+        queue->stats.dropped++;
+        queued = 0;
+    }
+    queue->frames[(queue->head + queue->count) % CAN_TX_QUEUE_LEN] = *frame;
+    queue->count++;
+    if (queue->count > queue->stats.max_depth)
+    {
+        queue->stats.max_depth = queue->count;
+    }
+
+    CAN_tx_flush(can);
+    hal_irq_restore(irq_state);
+    return queued;
+}
+
+
+//Copies the transmit queue counters of a bus
+void get_CAN_tx_stats(hal_can_e can, can_tx_stats_t *stats)
+{
+    uint32_t irq_state = hal_irq_disable();
+    *stats = can_tx_queue[can].stats;
+    stats->depth = can_tx_queue[can].count;
+    hal_irq_restore(irq_state);
+}
+
+
+/**
+* @brief  CAN1 TX mailbox empty interrupt handler, sends the next queued gimbal frames
+* @param  None
+* @retval None
+*/
+void CAN1_TX_IRQHandler(void)
+{
+    hal_can_tx_irq_ack(HAL_CAN1);
+    CAN_tx_flush(HAL_CAN1);
+}
+
+
+/**
+* @brief  CAN2 TX mailbox empty interrupt handler, sends the next queued chassis frames
+* @param  None
+* @retval None
+*/
+void CAN2_TX_IRQHandler(void)
+{
+    hal_can_tx_irq_ack(HAL_CAN2);
+    CAN_tx_flush(HAL_CAN2);
+}
+
+
 /**
 * @brief  Writes a CAN message to 4 gimbal motors
 * @param  yaw, pitch: speed for the yaw and pitch channelM6020 motors, in range of 0 to 4095
@@ -66,27 +359,21 @@ static CanTxMsg GIMBAL_TxMessage;
 
 void CAN_CMD_GIMBAL(int16_t yaw, int16_t pitch, int16_t trigger, int16_t hopper)
 {
-    GIMBAL_TxMessage.StdId = CAN_GIMBAL_ALL_ID;
-    GIMBAL_TxMessage.IDE = CAN_ID_STD;
-    GIMBAL_TxMessage.RTR = CAN_RTR_DATA;
-    GIMBAL_TxMessage.DLC = 0x08;
-    GIMBAL_TxMessage.Data[0] = (yaw >> 8);
-    GIMBAL_TxMessage.Data[1] = yaw;
-    GIMBAL_TxMessage.Data[2] = (pitch >> 8);
-    GIMBAL_TxMessage.Data[3] = pitch;
-    GIMBAL_TxMessage.Data[4] = (trigger >> 8);
-    GIMBAL_TxMessage.Data[5] = trigger;
-    GIMBAL_TxMessage.Data[6] = (hopper >> 8);
-    GIMBAL_TxMessage.Data[7] = hopper;
+    GIMBAL_TxMessage.std_id = CAN_GIMBAL_ALL_ID;
+    GIMBAL_TxMessage.dlc = 0x08;
+    GIMBAL_TxMessage.data[0] = (yaw >> 8);
+    GIMBAL_TxMessage.data[1] = yaw;
+    GIMBAL_TxMessage.data[2] = (pitch >> 8);
+    GIMBAL_TxMessage.data[3] = pitch;
+    GIMBAL_TxMessage.data[4] = (trigger >> 8);
+    GIMBAL_TxMessage.data[5] = trigger;
+    GIMBAL_TxMessage.data[6] = (hopper >> 8);
+    GIMBAL_TxMessage.data[7] = hopper;
 
 #if GIMBAL_MOTOR_6020_CAN_LOSE_SLOVE
-
-    TIM6->CNT = 0;
-    TIM6->ARR = delay_time ;
-
-    TIM_Cmd(TIM6,ENABLE);
+    hal_timer_start(HAL_TIMER_CAN_DELAY, delay_time);
 #else
-	CAN_Transmit( GIMBAL_CAN,  &GIMBAL_TxMessage );
+	control_tick_send( CONTROL_TICK_GIMBAL, GIMBAL_CAN,  &GIMBAL_TxMessage );
 #endif
 
 }
@@ -99,14 +386,12 @@ void CAN_CMD_GIMBAL(int16_t yaw, int16_t pitch, int16_t trigger, int16_t hopper)
 */
 void TIM6_DAC_IRQHandler(void)
 {
-    if( TIM_GetITStatus( TIM6, TIM_IT_Update )!= RESET )
+    if( hal_timer_update_flag( HAL_TIMER_CAN_DELAY ) )
     {
-
-        TIM_ClearFlag( TIM6, TIM_IT_Update );
 #if GIMBAL_MOTOR_6020_CAN_LOSE_SLOVE
-        CAN_Transmit( GIMBAL_CAN,  &GIMBAL_TxMessage );
+        CAN_send( GIMBAL_CAN,  &GIMBAL_TxMessage );
 #endif
-        TIM_Cmd(TIM6,DISABLE);
+        hal_timer_stop(HAL_TIMER_CAN_DELAY);
     }
 }
 
@@ -119,21 +404,19 @@ void TIM6_DAC_IRQHandler(void)
 void CAN_CMD_CHASSIS_RESET_ID(void)
 {
 
-    CanTxMsg TxMessage;
-    TxMessage.StdId = 0x700;
-    TxMessage.IDE = CAN_ID_STD;
-    TxMessage.RTR = CAN_RTR_DATA;
-    TxMessage.DLC = 0x08;
-    TxMessage.Data[0] = 0;
-    TxMessage.Data[1] = 0;
-    TxMessage.Data[2] = 0;
-    TxMessage.Data[3] = 0;
-    TxMessage.Data[4] = 0;
-    TxMessage.Data[5] = 0;
-    TxMessage.Data[6] = 0;
-    TxMessage.Data[7] = 0;
-
-    CAN_Transmit(CAN2, &TxMessage);
+    hal_can_frame_t TxMessage;
+    TxMessage.std_id = 0x700;
+    TxMessage.dlc = 0x08;
+    TxMessage.data[0] = 0;
+    TxMessage.data[1] = 0;
+    TxMessage.data[2] = 0;
+    TxMessage.data[3] = 0;
+    TxMessage.data[4] = 0;
+    TxMessage.data[5] = 0;
+    TxMessage.data[6] = 0;
+    TxMessage.data[7] = 0;
+
+    CAN_send(CHASSIS_CAN, &TxMessage);
 }
 
 
@@ -144,21 +427,19 @@ void CAN_CMD_CHASSIS_RESET_ID(void)
  */
 void CAN_CMD_CHASSIS(int16_t motor1, int16_t motor2, int16_t motor3, int16_t motor4)
 {
-    CanTxMsg TxMessage;
-    TxMessage.StdId = CAN_CHASSIS_ALL_ID;
-    TxMessage.IDE = CAN_ID_STD;
-    TxMessage.RTR = CAN_RTR_DATA;
-    TxMessage.DLC = 0x08;
-    TxMessage.Data[0] = motor1 >> 8;
-    TxMessage.Data[1] = motor1;
-    TxMessage.Data[2] = motor2 >> 8;
-    TxMessage.Data[3] = motor2;
-    TxMessage.Data[4] = motor3 >> 8;
-    TxMessage.Data[5] = motor3;
-    TxMessage.Data[6] = motor4 >> 8;
-    TxMessage.Data[7] = motor4;
-
-    CAN_Transmit(CHASSIS_CAN, &TxMessage);
+    hal_can_frame_t TxMessage;
+    TxMessage.std_id = CAN_CHASSIS_ALL_ID;
+    TxMessage.dlc = 0x08;
+    TxMessage.data[0] = motor1 >> 8;
+    TxMessage.data[1] = motor1;
+    TxMessage.data[2] = motor2 >> 8;
+    TxMessage.data[3] = motor2;
+    TxMessage.data[4] = motor3 >> 8;
+    TxMessage.data[5] = motor3;
+    TxMessage.data[6] = motor4 >> 8;
+    TxMessage.data[7] = motor4;
+
+    control_tick_send(CONTROL_TICK_CHASSIS, CHASSIS_CAN, &TxMessage);
 }
 
 
@@ -196,91 +477,505 @@ const motor_feedback_t *get_chassis_motor_feedback_pointer(uint8_t i)
 }
 
 
-/******************** Private Function Implementationss ********************/
+/**
+* @brief  Copies one motor's data without locking. The CAN interrupt bumps seq before and
+*         after writing a frame, so a copy is only kept if seq was even and unchanged around
+*         it. On a single core the loop retries only when a CAN interrupt lands mid-copy.
+* @param  motor: pointer returned by one of the get_*_motor_feedback_pointer functions
+* @param  snapshot: filled with a consistent copy, its seq tells readers if a new frame arrived
+* @retval None
+*/
+void get_motor_feedback_snapshot(const motor_feedback_t *motor, motor_feedback_t *snapshot)
+{
+    const volatile motor_feedback_t *src = motor;
+    uint32_t seq;
+
+    do
+    {
+        seq = src->seq;
+        hal_memory_barrier();
+        snapshot->ecd = src->ecd;
+        snapshot->speed_rpm = src->speed_rpm;
+        snapshot->current_read = src->current_read;
+        snapshot->temperate = src->temperate;
+        snapshot->last_ecd = src->last_ecd;
+        snapshot->rx_time = src->rx_time;
+        snapshot->total_ecd = src->total_ecd;
+        snapshot->speed_filtered_rpm = src->speed_filtered_rpm;
+        snapshot->gear_num = src->gear_num;
+        snapshot->gear_den = src->gear_den;
+        hal_memory_barrier();
+    } while ((seq & 1u) || seq != src->seq);
+
+    snapshot->seq = seq;
+}
+
 
 /**
-* @brief  CAN1 interrupt handler, used for reading gimbal messages
+* @brief  Copies every motor's current data into the latch, so all tasks released by
+*         one control tick work from the same set of frames. Called from the tick interrupt;
+*         the latch uses the same seqlock as the live data in case a task overran into it.
 * @param  None
-* @modify rx1_message
 * @retval None
 */
-void CAN1_RX0_IRQHandler(void)
+void CAN_latch_motor_feedback(void)
+{
+    motor_feedback_t snapshot;
+
+    for (uint8_t i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        motor_feedback_t *latched = &motor_latched[i];
+        get_motor_feedback_snapshot(motor_by_index[i], &snapshot);
+        if (snapshot.seq == 0)
+        {
+            continue;
+        }
+        //Ages every motor once per tick, whether or not a task asks
+        motor_feedback_age_us(i, &snapshot);
+
+        latched->seq++;
+        hal_memory_barrier();
+        latched->ecd = snapshot.ecd;
+        latched->speed_rpm = snapshot.speed_rpm;
+        latched->current_read = snapshot.current_read;
+        latched->temperate = snapshot.temperate;
+        latched->last_ecd = snapshot.last_ecd;
+        latched->rx_time = snapshot.rx_time;
+        latched->total_ecd = snapshot.total_ecd;
+        latched->speed_filtered_rpm = snapshot.speed_filtered_rpm;
+        latched->gear_num = snapshot.gear_num;
+        latched->gear_den = snapshot.gear_den;
+        hal_memory_barrier();
+        latched->seq++;
+    }
+}
+
+
+/**
+* @brief  Copies a motor's data as of the last control tick. Falls back to the live
+*         data until the first latch, e.g. when the control tick is disabled.
+* @param  motor: pointer returned by one of the get_*_motor_feedback_pointer functions
+* @param  snapshot: filled with a consistent copy
+* @retval None
+*/
+void get_motor_feedback_latched(const motor_feedback_t *motor, motor_feedback_t *snapshot)
 {
-    static CanRxMsg rx1_message;
+    for (uint8_t i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        if (motor_by_index[i] == motor && motor_latched[i].seq != 0)
+        {
+            get_motor_feedback_snapshot(&motor_latched[i], snapshot);
+            return;
+        }
+    }
+    get_motor_feedback_snapshot(motor, snapshot);
+}
 
-    if (CAN_GetITStatus(CAN1, CAN_IT_FMP0) != RESET) // Ensure CAN channel is open to receive data
+
+/**
+* @brief  Output shaft position of a motor, rotor counts divided by its gearbox. Only the
+*         rotor is absolute, so a geared output starts at the rotor's first ecd / ratio.
+* @param  feedback: snapshot from get_motor_feedback_snapshot or get_motor_feedback_latched
+* @retval Multi-turn position, MOTOR_ECD_RANGE counts per output turn
+*/
+int32_t get_motor_output_ecd(const motor_feedback_t *feedback)
+{
+    if (feedback->gear_num == 0)
     {
-        CAN_ClearITPendingBit(CAN1, CAN_IT_FMP0);
-        CAN_Receive(CAN1, CAN_FIFO0, &rx1_message);  // Receives CAN1 (gimbal) data and stores in rx1_message
-        CAN_hook(&rx1_message); // Call to CAN_hook and allocates the received message to a data struct
+        return feedback->total_ecd;
     }
+    return (int32_t)((int64_t)feedback->total_ecd * feedback->gear_den / feedback->gear_num);
 }
 
 
 /**
-* @brief  CAN2 interrupt handler, used for reading chassis messages
+* @brief  Output shaft angle of a motor, see get_motor_output_ecd
+* @param  feedback: snapshot from get_motor_feedback_snapshot or get_motor_feedback_latched
+* @retval Multi-turn angle in radians, counter clockwise seen from the output shaft
+*/
+fp32 get_motor_output_angle(const motor_feedback_t *feedback)
+{
+    fp32 rotor_turns = (fp32)feedback->total_ecd / MOTOR_ECD_RANGE;
+    if (feedback->gear_num != 0)
+    {
+        rotor_turns = rotor_turns * feedback->gear_den / feedback->gear_num;
+    }
+    return rotor_turns * 2.0f * PI;
+}
+
+
+/**
+* @brief  Filtered output shaft speed of a motor
+* @param  feedback: snapshot from get_motor_feedback_snapshot or get_motor_feedback_latched
+* @retval speed_filtered_rpm divided by the gearbox, in rpm
+*/
+fp32 get_motor_output_rpm(const motor_feedback_t *feedback)
+{
+    if (feedback->gear_num == 0)
+    {
+        return feedback->speed_filtered_rpm;
+    }
+    return (fp32)feedback->speed_filtered_rpm * feedback->gear_den / feedback->gear_num;
+}
+
+
+/**
+* @brief  Time since the last frame of a motor, held at CAN_FEEDBACK_AGE_LIMIT_US once it
+*         gets there so it does not wrap with the cycle counter (~23.8 s)
+* @param  motor: pointer returned by one of the get_*_motor_feedback_pointer functions
+* @retval Age in microseconds, CAN_FEEDBACK_AGE_LIMIT_US if never received
+*/
+uint32_t get_motor_feedback_age_us(const motor_feedback_t *motor)
+{
+    motor_feedback_t snapshot;
+    get_motor_feedback_snapshot(motor, &snapshot);
+    for (uint8_t i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        if (motor_by_index[i] == motor)
+        {
+            return motor_feedback_age_us(i, &snapshot);
+        }
+    }
+    return (hal_cycle_count() - snapshot.rx_time) / HAL_CYCLES_PER_US;
+}
+
+
+/**
+* @brief  Checks that a motor is still talking, tasks should stop driving it otherwise
+* @param  motor: pointer returned by one of the get_*_motor_feedback_pointer functions
+* @param  timeout_us: oldest acceptable frame, below CAN_FEEDBACK_AGE_LIMIT_US
+* @retval 1 if stale or never received, 0 if fresh
+*/
+uint8_t motor_feedback_is_stale(const motor_feedback_t *motor, uint32_t timeout_us)
+{
+    //seq only stays 0 until the first frame
+    if (motor->seq == 0)
+    {
+        return 1;
+    }
+    return get_motor_feedback_age_us(motor) > timeout_us;
+}
+
+
+/**
+* @brief  Copies the receive statistics of a motor and converts the average gap into a rate
+* @param  id: feedback ID of the motor, CAN_3508_M1_ID ~ CAN_HOPPER_MOTOR_ID
+* @param  stats: filled with the statistics, zeroed for an unknown ID
+* @retval None
+*/
+void get_motor_rx_stats(can_msg_id_e id, motor_rx_stats_t *stats)
+{
+    uint32_t index = id - CAN_3508_M1_ID;
+    if (index >= CAN_MOTOR_NUM)
+    {
+        stats->rx_count = 0;
+        stats->avg_gap_cycles = 0;
+        stats->max_gap_cycles = 0;
+        stats->rate_hz = 0.0f;
+        return;
+    }
+
+    uint32_t irq_state = hal_irq_disable();
+    *stats = motor_rx_stats[index];
+    hal_irq_restore(irq_state);
+
+    stats->rate_hz = stats->avg_gap_cycles ? (fp32)HAL_CYCLE_HZ / stats->avg_gap_cycles : 0.0f;
+}
+
+
+//Clears the max gap of every motor
+void reset_motor_rx_max_gap(void)
+{
+    uint32_t irq_state = hal_irq_disable();
+    for (uint8_t i = 0; i < CAN_MOTOR_NUM; i++)
+    {
+        motor_rx_stats[i].max_gap_cycles = 0;
+    }
+    hal_irq_restore(irq_state);
+}
+
+
+/******************** Private Function Implementationss ********************/
+
+/**
+* @brief  CAN1 FIFO0 interrupt handler, gimbal motor feedback
+* @param  None
+* @retval None
+*/
+void CAN1_RX0_IRQHandler(void)
+{
+    CAN_rx_irq(HAL_CAN1, HAL_CAN_FIFO0);
+}
+
+
+/**
+* @brief  CAN1 FIFO1 interrupt handler, low priority gimbal bus traffic
+* @param  None
+* @retval None
+*/
+void CAN1_RX1_IRQHandler(void)
+{
+    CAN_rx_irq(HAL_CAN1, HAL_CAN_FIFO1);
+}
+
+
+/**
+* @brief  CAN2 FIFO0 interrupt handler, chassis motor feedback
 * @param  None
-* @modify rx2_message
 * @retval None
 */
 void CAN2_RX0_IRQHandler(void)
 {
-    static CanRxMsg rx2_message;
-    if (CAN_GetITStatus(CAN2, CAN_IT_FMP0) != RESET) // Ensure CAN channel is open to receive data
+    CAN_rx_irq(HAL_CAN2, HAL_CAN_FIFO0);
+}
+
+
+/**
+* @brief  CAN2 FIFO1 interrupt handler, low priority chassis bus traffic
+* @param  None
+* @retval None
+*/
+void CAN2_RX1_IRQHandler(void)
+{
+    CAN_rx_irq(HAL_CAN2, HAL_CAN_FIFO1);
+}
+
+
+/**
+* @brief  Body of the four receive interrupts. Empties the FIFO in one entry instead of
+*         taking an exception per frame, counts overruns and times itself.
+* @param  can: bus that raised the interrupt
+* @param  fifo: FIFO that raised the interrupt
+* @modify can_rx_bus_stats
+* @retval None
+*/
+static void CAN_rx_irq(hal_can_e can, hal_can_fifo_e fifo)
+{
+    hal_can_frame_t rx_message;
+    can_rx_bus_stats_t *stats = &can_rx_bus_stats[can];
+    uint32_t start = hal_cycle_count();
+
+    stats->irq_count++;
+    if (hal_can_fifo_overrun(can, fifo))
+    {
+        stats->overrun_count[fifo]++;
+    }
+    while (hal_can_receive(can, fifo, &rx_message))
+    {
+        stats->frame_count++;
+        CAN_hook(can, &rx_message);
+    }
+
+    uint32_t elapsed = hal_cycle_count() - start;
+    if (elapsed > stats->max_irq_cycles)
     {
-        CAN_ClearITPendingBit(CAN2, CAN_IT_FMP0);
-        CAN_Receive(CAN2, CAN_FIFO0, &rx2_message); // Receives CAN2 (chassis) data and stores in rx1_messag
-        CAN_hook(&rx2_message); // Call to CAN_hook and allocates the received message to a data struct
+        stats->max_irq_cycles = elapsed;
     }
 }
 
 
 /**
-* @brief  Handles CAN messages received, takes motor ID and calls handling function of that motor
-*					The method runs in the background and updates the relevant motor information automatically
-* @param  rx_message: pointer to the raw data read on CAN
-* @modify (one of) motor_yaw, motor_pit, motor_trigger, motor_revolver, and motor_chassis
+* @brief  Moves queued frames into free mailboxes. The TX interrupt is left enabled only
+*         while frames are waiting, it would fire continuously on empty mailboxes otherwise.
+*         Runs with interrupts masked or from the TX interrupt.
+* @param  can: bus to flush
+* @retval None
+*/
+static void CAN_tx_flush(hal_can_e can)
+{
+    can_tx_queue_t *queue = &can_tx_queue[can];
 
+    while (queue->count > 0)
+    {
+        if (hal_can_transmit(can, &queue->frames[queue->head]) == HAL_CAN_NO_MAILBOX)
+        {
+            break;
+        }
+        queue->head = (queue->head + 1) % CAN_TX_QUEUE_LEN;
+        queue->count--;
+        queue->stats.sent++;
+    }
+    hal_can_tx_irq_enable(can, queue->count > 0);
+}
+
+
+/**
+* @brief  Handles CAN messages received, looks the ID up in the registration table of the bus
+*         and calls its handler. Motor IDs 0x200 ~ 0x20F are a direct index, other IDs go
+*         through a small open addressing hash. Unknown IDs are counted.
+* @param  can: bus the message arrived on
+* @param  rx_message: pointer to the raw data read on CAN
 * @retval None
 */
-static void CAN_hook(CanRxMsg *rx_message)
+static void CAN_hook(hal_can_e can, hal_can_frame_t *rx_message)
+{
+    const can_rx_entry_t *entry = find_rx_entry(can, rx_message->std_id);
+
+    if (entry == NULL || entry->handler == NULL)
+    {
+        can_unknown_id_count[can]++;
+        can_last_unknown_id[can] = rx_message->std_id;
+        return;
+    }
+    entry->handler(rx_message, entry->dest);
+}
+
+
+/**
+* @brief  Finds the registration table slot of an ID
+* @param  can: bus to look in
+* @param  std_id: standard CAN ID
+* @retval The slot holding std_id, NULL if it is not registered
+*/
+static can_rx_entry_t *find_rx_entry(hal_can_e can, uint32_t std_id)
 {
-    switch (rx_message->StdId) //Gets the ID from the received CAN message
+    if ((std_id & ~(CAN_RX_MOTOR_BLOCK_SIZE - 1)) == CAN_RX_MOTOR_BLOCK_BASE)
     {
-    case CAN_YAW_MOTOR_ID:
+        return &can_rx_motor_block[can][std_id - CAN_RX_MOTOR_BLOCK_BASE];
+    }
+
+    uint32_t slot = CAN_RX_HASH(std_id);
+    for (uint8_t probe = 0; probe < CAN_RX_HASH_SIZE; probe++)
     {
-        fill_motor_readings(&motor_yaw, rx_message);
-        break;
+        can_rx_entry_t *entry = &can_rx_hash[can][slot];
+        if (entry->handler == NULL)
+        {
+            return NULL;
+        }
+        if (entry->std_id == std_id)
+        {
+            return entry;
+        }
+        slot = (slot + 1) & (CAN_RX_HASH_SIZE - 1);
     }
-    case CAN_PIT_MOTOR_ID:
+    return NULL;
+}
+
+
+/**
+* @brief  Registration table handler of the RM motor ESCs, stores the frame in a motor_feedback_t
+* @param  rx_message: frame received
+* @param  dest: motor_feedback_t registered with the ID
+* @retval None
+*/
+static void motor_feedback_handler(const hal_can_frame_t *rx_message, void *dest)
+{
+    motor_feedback_t *motor = dest;
+    update_rx_stats(rx_message->std_id);
+    fill_motor_readings(motor, rx_message);
+}
+
+
+/**
+* @brief  Copies a frame into a motor_feedback_t with seq odd for the whole copy, so readers
+*         know to retry. The rotor turn count is kept here, where every frame is seen: the
+*         step between two frames is taken as the one closest to what the average reported
+*         speed covers in the time between them, so a few lost frames at full speed do not
+*         slip a turn. Integer only, it runs in the receive interrupt.
+* @param  motor: motor the frame belongs to
+* @param  rx_message: frame received
+* @retval None
+*/
+static void fill_motor_readings(motor_feedback_t *motor, const hal_can_frame_t *rx_message)
+{
+    uint16_t ecd = (uint16_t)(rx_message->data[0] << 8 | rx_message->data[1]);
+    int16_t speed_rpm = (int16_t)(rx_message->data[2] << 8 | rx_message->data[3]);
+    uint32_t now = hal_cycle_count();
+
+    motor->seq++;
+    hal_memory_barrier();
+    if (motor->seq == 1)
     {
-        fill_motor_readings(&motor_pit, rx_message);
-        break;
+        //First frame since init
+        motor->total_ecd = ecd;
+        motor->speed_filter_state = speed_rpm * MOTOR_SPEED_FILTER_SCALE;
     }
-    case CAN_TRIGGER_MOTOR_ID:
+    else
     {
-        fill_motor_readings(&motor_trigger, rx_message);
-        break;
+        uint32_t gap_us = (now - motor->rx_time) / HAL_CYCLES_PER_US;
+        if (gap_us > MOTOR_UNWRAP_MAX_GAP_US)
+        {
+            gap_us = MOTOR_UNWRAP_MAX_GAP_US;
+        }
+        //|rpm| <= 32767 times gap_us <= 65535 fits in 31 bits
+        int32_t predicted = ((motor->speed_rpm + speed_rpm) / 2) * (int32_t)gap_us / MOTOR_RPM_US_PER_ECD;
+        //Step congruent to the ecd change, within half a turn of the prediction
+        int32_t error = (int32_t)((uint16_t)(ecd - motor->ecd - predicted + MOTOR_ECD_RANGE / 2) & (MOTOR_ECD_RANGE - 1))
+                        - MOTOR_ECD_RANGE / 2;
+        motor->total_ecd = (int32_t)((uint32_t)motor->total_ecd + (uint32_t)(predicted + error));
+        motor->speed_filter_state += (speed_rpm * MOTOR_SPEED_FILTER_SCALE - motor->speed_filter_state) / MOTOR_SPEED_FILTER_GAIN;
     }
-		case CAN_HOPPER_MOTOR_ID:
+    motor->speed_filtered_rpm = (int16_t)(motor->speed_filter_state / MOTOR_SPEED_FILTER_SCALE);
+    motor->last_ecd = motor->ecd;
+    motor->ecd = ecd;
+    motor->speed_rpm = speed_rpm;
+    motor->current_read = (int16_t)(rx_message->data[4] << 8 | rx_message->data[5]);
+    motor->temperate = rx_message->data[6];
+    motor->rx_time = now;
+    hal_memory_barrier();
+    motor->seq++;
+}
+
+
+/**
+* @brief  Tracks the inter-arrival time of one motor ID. The average is an exponential
+*         moving average over ~16 frames, kept in integer cycles to stay off the FPU in
+*         the interrupt.
+* @param  std_id: ID of the frame just received
+* @retval None
+*/
+static void update_rx_stats(uint32_t std_id)
+{
+    uint32_t index = std_id - CAN_3508_M1_ID;
+    if (index >= CAN_MOTOR_NUM)
     {
-        fill_motor_readings(&motor_hopper, rx_message);
-        break;
+        return;
     }
-    case CAN_3508_M1_ID:
-    case CAN_3508_M2_ID:
-    case CAN_3508_M3_ID:
-    case CAN_3508_M4_ID:
-    {
-        static uint8_t i = 0;
-        i = rx_message->StdId - CAN_3508_M1_ID; //get motor ID
-        fill_motor_readings(&motor_chassis[i], rx_message); //Use motor ID as index of array
-        break;
+
+    motor_rx_stats_t *stats = &motor_rx_stats[index];
+    uint32_t now = hal_cycle_count();
+
+    if (stats->rx_count > 0)
+    {
+        uint32_t gap = now - motor_last_rx_time[index];
+        if (stats->rx_count == 1)
+        {
+            stats->avg_gap_cycles = gap;
+        }
+        else
+        {
+            stats->avg_gap_cycles += ((int32_t)(gap - stats->avg_gap_cycles)) / 16;
+        }
+        if (gap > stats->max_gap_cycles)
+        {
+            stats->max_gap_cycles = gap;
+        }
     }
+    motor_last_rx_time[index] = now;
+    stats->rx_count++;
+}
+
 
-    default:
+/**
+* @brief  Age of a motor's last frame. Once it reaches CAN_FEEDBACK_AGE_LIMIT_US the frame's
+*         seq is latched and the age stays at the limit until the next frame. The limit is
+*         well inside the counter's wrap, and the control tick ages every motor each ms.
+* @param  index: motor index, ID - CAN_3508_M1_ID
+* @param  snapshot: consistent copy of the motor's data
+* @retval Age in microseconds, CAN_FEEDBACK_AGE_LIMIT_US if never received
+*/
+static uint32_t motor_feedback_age_us(uint8_t index, const motor_feedback_t *snapshot)
+{
+    //Also true before the first frame, seq and the latch both start at 0
+    if (motor_silent_seq[index] == snapshot->seq)
     {
-        break;
+        return CAN_FEEDBACK_AGE_LIMIT_US;
     }
+    uint32_t age = (hal_cycle_count() - snapshot->rx_time) / HAL_CYCLES_PER_US;
+    if (age >= CAN_FEEDBACK_AGE_LIMIT_US)
+    {
+        motor_silent_seq[index] = snapshot->seq;
+        return CAN_FEEDBACK_AGE_LIMIT_US;
     }
+    return age;
 }
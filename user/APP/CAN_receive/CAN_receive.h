@@ -21,12 +21,13 @@
 #ifndef CANTASK_H
 #define CANTASK_H
 #include "main.h"
+#include "hal.h"
 
 
 /******************** Public Definitions & Structs ********************/
 
-#define CHASSIS_CAN CAN2
-#define GIMBAL_CAN CAN1
+#define CHASSIS_CAN HAL_CAN2
+#define GIMBAL_CAN HAL_CAN1
 
 // CAN send and receive IDs
 typedef enum
@@ -46,20 +47,119 @@ typedef enum
 } can_msg_id_e;
 
 
+//Encoder counts per rotor turn of every RM motor
+#define MOTOR_ECD_RANGE 8192
+//Microseconds for one encoder count at 1 rpm, 60e6 / MOTOR_ECD_RANGE rounded
+#define MOTOR_RPM_US_PER_ECD 7324
+//Frame gaps longer than this are predicted as this long, keeps the prediction in 32 bits
+#define MOTOR_UNWRAP_MAX_GAP_US 65535
+//speed_filtered_rpm: first order low pass with gain 1 / MOTOR_SPEED_FILTER_GAIN per frame,
+//the state keeps MOTOR_SPEED_FILTER_SCALE fractional steps per rpm
+#define MOTOR_SPEED_FILTER_GAIN 4
+#define MOTOR_SPEED_FILTER_SCALE 16
+
+//Gearbox ratios, rotor turns per output shaft turn as numerator / denominator
+#define M3508_GEAR_NUM 3591
+#define M3508_GEAR_DEN 187
+#define P36_GEAR_NUM 36
+#define P36_GEAR_DEN 1
+#define GM6020_GEAR_NUM 1
+#define GM6020_GEAR_DEN 1
+
 //Motor data struct for GM6020 and M3508
+//seq is the seqlock counter written by the CAN interrupt: odd while a frame is being
+//copied in, even once the fields are consistent. Read through get_motor_feedback_snapshot
 typedef struct
 {
+    volatile uint32_t seq;
     uint16_t ecd;
     int16_t speed_rpm;
     int16_t current_read;
     uint8_t temperate;
     int16_t last_ecd;
+    //hal_cycle_count() when the frame arrived
+    uint32_t rx_time;
+    //Rotor position since boot in encoder counts, unwrapped by the CAN interrupt. Starts at
+    //the first ecd and wraps after 2^31 counts (~29 min at 9000 rpm), differences stay valid
+    int32_t total_ecd;
+    //speed_rpm through a low pass, rotor rpm
+    int16_t speed_filtered_rpm;
+    //Gearbox of the motor, set at init, read with get_motor_output_ecd/angle/rpm
+    uint16_t gear_num;
+    uint16_t gear_den;
+    //Private: low pass state of speed_filtered_rpm, not copied into snapshots
+    int32_t speed_filter_state;
 } motor_feedback_t;
 
+//Number of motors with a feedback ID, 0x201 ~ 0x208
+#define CAN_MOTOR_NUM 8
+//Feedback ages stop here, well inside the cycle counter's ~23.8 s wrap
+#define CAN_FEEDBACK_AGE_LIMIT_US 10000000u
+
+//Receive statistics of one motor ID, updated by the CAN interrupt
+typedef struct
+{
+    uint32_t rx_count;
+    uint32_t avg_gap_cycles;    //moving average of the time between frames
+    uint32_t max_gap_cycles;    //longest time between frames since the last reset
+    fp32 rate_hz;               //receive rate from avg_gap_cycles, filled in by get_motor_rx_stats
+} motor_rx_stats_t;
+
+
+
+//Called from the CAN receive interrupt with the frame and the dest pointer it was registered with
+typedef void (*can_rx_handler_f)(const hal_can_frame_t *rx_message, void *dest);
+
+//Receive interrupt counters of one bus. Frames per entry above 1 means the drain loop
+//saved exception entries; overruns mean frames were lost while the interrupt was held off
+typedef struct
+{
+    uint32_t irq_count;
+    uint32_t frame_count;
+    uint32_t overrun_count[HAL_CAN_FIFO_NUM];
+    uint32_t max_irq_cycles;
+} can_rx_bus_stats_t;
+
+//Transmit queue counters of one bus
+typedef struct
+{
+    uint32_t requested;     //CAN_send calls
+    uint32_t sent;          //frames handed to a mailbox
+    uint32_t coalesced;     //frames that replaced a waiting frame with the same ID
+    uint32_t dropped;       //waiting frames pushed out of a full queue
+    uint8_t depth;          //frames waiting now
+    uint8_t max_depth;
+} can_tx_stats_t;
+
+//High priority IDs get their own receive FIFO, so bursts of other traffic cannot delay them
+typedef enum
+{
+    CAN_RX_PRIORITY_HIGH = 0,
+    CAN_RX_PRIORITY_LOW,
+    CAN_RX_PRIORITY_NUM,
+} can_rx_priority_e;
 
 
 /******************** Main Functions Called From Outside ********************/
 
+//Fills the receive tables with the chassis and gimbal motors, call before the CAN peripherals are initialised
+extern void CAN_receive_init(void);
+//Routes a CAN ID on a bus to a handler, returns 0 if the table is full
+extern uint8_t CAN_register_rx_handler(hal_can_e can, uint32_t std_id, can_rx_priority_e priority, can_rx_handler_f handler, void *dest);
+//Sets the gearbox a motor's output shaft getters divide by, id is one of CAN_3508_M1_ID ~ CAN_HOPPER_MOTOR_ID
+extern void CAN_set_motor_gear_ratio(can_msg_id_e id, uint16_t gear_num, uint16_t gear_den);
+//Rebuilds the hardware filter banks from the registered IDs
+extern void CAN_update_filters(void);
+//Frames received with no registered handler
+extern uint32_t get_CAN_unknown_id_count(hal_can_e can);
+extern uint32_t get_CAN_last_unknown_id(hal_can_e can);
+//Receive interrupt entries, frames, FIFO overruns and longest interrupt of a bus
+extern void get_CAN_rx_bus_stats(hal_can_e can, can_rx_bus_stats_t *stats);
+
+//Queues a frame without blocking, keeping only the latest frame per ID
+extern uint8_t CAN_send(hal_can_e can, const hal_can_frame_t *frame);
+//Transmit queue counters of a bus
+extern void get_CAN_tx_stats(hal_can_e can, can_tx_stats_t *stats);
 //Resets chassis motor CAN ID
 extern void CAN_CMD_CHASSIS_RESET_ID(void);
 //Send to yaw, pitch , trigger, and revolver
@@ -71,11 +171,31 @@ extern const motor_feedback_t *get_yaw_gimbal_motor_feedback_pointer(void);
 //Return a pointer to pitch motor data
 extern const motor_feedback_t *get_pitch_motor_feedback_pointer(void);
 //Return a pointer to trigger motor data
-extern const motor_feedback_t *get_Trigger_Motor_Measure_Point(void);
-//Return a pointer to trigger motor data
-extern const motor_feedback_t *get_Revolver_Motor_Measure_Point(void);
+extern const motor_feedback_t *get_trigger_motor_feedback_pointer(void);
+//Return a pointer to hopper motor data
+extern const motor_feedback_t *get_hopper_motor_feedback_pointer(void);
 //Return a pointer to chassis motors data
 extern const motor_feedback_t *get_chassis_motor_feedback_pointer(uint8_t i);
+//Copies a consistent snapshot of one motor's data, never mixing two CAN frames
+extern void get_motor_feedback_snapshot(const motor_feedback_t *motor, motor_feedback_t *snapshot);
+//Copies every motor's data into the latch, called by the control tick
+extern void CAN_latch_motor_feedback(void);
+//Copies one motor's data as of the last control tick
+extern void get_motor_feedback_latched(const motor_feedback_t *motor, motor_feedback_t *snapshot);
+//Multi-turn output shaft position of a snapshot, MOTOR_ECD_RANGE counts per output turn
+extern int32_t get_motor_output_ecd(const motor_feedback_t *feedback);
+//Multi-turn output shaft angle of a snapshot, in radians
+extern fp32 get_motor_output_angle(const motor_feedback_t *feedback);
+//Filtered output shaft speed of a snapshot, in rpm
+extern fp32 get_motor_output_rpm(const motor_feedback_t *feedback);
+//Time since the last frame of a motor, in microseconds, at most CAN_FEEDBACK_AGE_LIMIT_US
+extern uint32_t get_motor_feedback_age_us(const motor_feedback_t *motor);
+//Returns 1 if the motor never reported or its last frame is older than timeout_us
+extern uint8_t motor_feedback_is_stale(const motor_feedback_t *motor, uint32_t timeout_us);
+//Copies the receive statistics of a motor, id is one of CAN_3508_M1_ID ~ CAN_HOPPER_MOTOR_ID
+extern void get_motor_rx_stats(can_msg_id_e id, motor_rx_stats_t *stats);
+//Clears the max gap of every motor, e.g. after a deliberate bus interruption
+extern void reset_motor_rx_max_gap(void);
 
 #if GIMBAL_MOTOR_6020_CAN_LOSE_SLOVE
 extern void GIMBAL_lose_slove(void);
@@ -16,6 +16,7 @@
 
 #include "FreeRTOS_Middleware.h"
 #include "stm32f4xx.h"
+#include "timer.h"
 
 #include "FreeRTOSConfig.h"
 #include "FreeRTOS.h"
@@ -35,20 +36,14 @@ void SysTick_Handler(void)
     }
 }
 
-//tim3ΪͳʱĿǰcpu
-volatile uint64_t FreeRTOSRunTimeTicks = 0;
-
+//Run time stats clock. TIM2 is 32 bits wide: free running at RUN_TIME_STATS_HZ it
+//wraps after 71 minutes and needs no interrupt. TIM3 is left to the IMU heater PWM
 void ConfigureTimeForRunTimeStats(void)
 {
-    FreeRTOSRunTimeTicks = 0;
+    TIM2_Init(RUN_TIME_STATS_TIMER_CLOCK_HZ / RUN_TIME_STATS_HZ);
 }
 
-void TIM3_IRQHandler(void)
+uint32_t GetRunTimeCounterValue(void)
 {
-    if (TIM_GetITStatus(TIM3, TIM_IT_Update) != RESET)
-    {
-        TIM_ClearFlag(TIM3, TIM_IT_Update);
-        FreeRTOSRunTimeTicks++;
-    }
+    return TIM2->CNT;
 }
- 
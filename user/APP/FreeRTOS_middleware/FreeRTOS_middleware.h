@@ -18,4 +18,11 @@
 #define FREERTOS_MIDDLEWARE_H
 #include "main.h"
 
+//Run time stats resolution, TIM2 runs from the 90 MHz APB1 timer clock
+#define RUN_TIME_STATS_HZ 1000000
+#define RUN_TIME_STATS_TIMER_CLOCK_HZ 90000000
+
+extern void ConfigureTimeForRunTimeStats(void);
+extern uint32_t GetRunTimeCounterValue(void);
+
 #endif
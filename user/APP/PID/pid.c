@@ -16,6 +16,8 @@
   */
 
 #include "pid.h"
+#include "arm_math.h"
+#include <string.h>
 
 #define LimitMax(input, max)   \
     {                          \
@@ -95,3 +97,227 @@ void PID_clear(PidTypeDef *pid)
     pid->out = pid->Pout = pid->Iout = pid->Dout = 0.0f;
     pid->fdb = pid->set = 0.0f;
 }
+
+void PID_full_init(PidFullTypeDef *pid, const PidFullConfigTypeDef *config)
+{
+    if (pid == NULL || config == NULL)
+    {
+        return;
+    }
+    pid->config = *config;
+    PID_full_clear(pid);
+}
+
+/**
+ * @brief  One step of the full PID
+ * @param  pid: controller
+ * @param  ref: measurement
+ * @param  set: setpoint
+ * @param  ff_vel, ff_acc: setpoint velocity and acceleration, 0 without a trajectory
+ * @param  dt: seconds since the last call, a non positive dt holds the last output
+ * @retval output, within +-max_out
+ */
+fp32 PID_full_calc(PidFullTypeDef *pid, fp32 ref, fp32 set, fp32 ff_vel, fp32 ff_acc, fp32 dt)
+{
+    if (pid == NULL)
+    {
+        return 0.0f;
+    }
+    if (dt <= 0.0f)
+    {
+        return pid->out;
+    }
+    const PidFullConfigTypeDef *config = &pid->config;
+    fp32 error = set - ref;
+
+    pid->set = set;
+    pid->fdb = ref;
+    pid->Pout = config->Kp * error;
+
+    //Derivative of the measurement, not the error: setpoint steps do not kick the output
+    fp32 rate = pid->started ? (pid->last_fdb - ref) / dt : 0.0f;
+    if (config->d_cutoff_hz > 0.0f)
+    {
+        //alpha = dt / (tau + dt), tau = 1 / (2 pi fc)
+        fp32 alpha = dt / (1.0f / (2.0f * 3.14159265f * config->d_cutoff_hz) + dt);
+        pid->d_filtered += alpha * (rate - pid->d_filtered);
+    }
+    else
+    {
+        pid->d_filtered = rate;
+    }
+    pid->last_fdb = ref;
+    pid->started = 1;
+    pid->Dout = config->Kd * pid->d_filtered;
+
+    pid->Fout = config->Kff_vel * ff_vel + config->Kff_acc * ff_acc;
+
+    //Output with last step's integrator, decides how this step may integrate
+    fp32 unsaturated = pid->Pout + pid->Iout + pid->Dout + pid->Fout;
+    fp32 saturated = unsaturated;
+    LimitMax(saturated, config->max_out);
+
+    switch (config->anti_windup)
+    {
+    case PID_AW_CLAMP:
+        if (saturated == unsaturated || error * unsaturated < 0.0f)
+        {
+            pid->Iout += config->Ki * error * dt;
+        }
+        break;
+    case PID_AW_BACK_CALC:
+        pid->Iout += (config->Ki * error + config->Kaw * (saturated - unsaturated)) * dt;
+        break;
+    case PID_AW_NONE:
+    default:
+        pid->Iout += config->Ki * error * dt;
+        break;
+    }
+    LimitMax(pid->Iout, config->max_iout);
+
+    pid->out = pid->Pout + pid->Iout + pid->Dout + pid->Fout;
+    LimitMax(pid->out, config->max_out);
+    return pid->out;
+}
+
+void PID_full_clear(PidFullTypeDef *pid)
+{
+    if (pid == NULL)
+    {
+        return;
+    }
+    pid->set = pid->fdb = 0.0f;
+    pid->out = pid->Pout = pid->Iout = pid->Dout = pid->Fout = 0.0f;
+    pid->d_filtered = pid->last_fdb = 0.0f;
+    pid->started = 0;
+}
+
+//Same gains and limits for every controller, num is capped at PID_BANK_MAX
+void PID_bank_init(PidBankTypeDef *bank, uint8_t num, const fp32 PID[3], fp32 max_out, fp32 max_iout)
+{
+    if (bank == NULL || PID == NULL)
+    {
+        return;
+    }
+    bank->num = num < PID_BANK_MAX ? num : PID_BANK_MAX;
+    bank->Kp = PID[0];
+    bank->Ki = PID[1];
+    bank->Kd = PID[2];
+    bank->max_out = max_out;
+    bank->max_iout = max_iout;
+    PID_bank_clear(bank);
+}
+
+//One position mode step of every controller in the bank, outputs land in bank->out.
+//Same arithmetic as PID_Calc in PID_POSITION mode, without the per call checks
+//and the mode branch. The clamps compile to conditional moves, so the loop has no
+//data dependent branches
+void PID_bank_calc(PidBankTypeDef *bank, const fp32 *ref, const fp32 *set)
+{
+    const fp32 Kp = bank->Kp, Ki = bank->Ki, Kd = bank->Kd;
+    const fp32 max_out = bank->max_out, max_iout = bank->max_iout;
+    const uint8_t num = bank->num;
+
+    for (uint8_t i = 0; i < num; i++)
+    {
+        fp32 error = set[i] - ref[i];
+        fp32 Iout = bank->Iout[i] + Ki * error;
+        Iout = Iout > max_iout ? max_iout : Iout;
+        Iout = Iout < -max_iout ? -max_iout : Iout;
+
+        fp32 Dout = Kd * (error - bank->error[i]);
+        fp32 out = Kp * error + Iout + Dout;
+        out = out > max_out ? max_out : out;
+        out = out < -max_out ? -max_out : out;
+
+        bank->set[i] = set[i];
+        bank->fdb[i] = ref[i];
+        bank->last_error[i] = bank->error[i];
+        bank->error[i] = error;
+        bank->Pout[i] = Kp * error;
+        bank->Iout[i] = Iout;
+        bank->Dout[i] = Dout;
+        bank->out[i] = out;
+    }
+}
+
+void PID_bank_clear(PidBankTypeDef *bank)
+{
+    if (bank == NULL)
+    {
+        return;
+    }
+    memset(bank->set, 0, sizeof(bank->set));
+    memset(bank->fdb, 0, sizeof(bank->fdb));
+    memset(bank->out, 0, sizeof(bank->out));
+    memset(bank->Pout, 0, sizeof(bank->Pout));
+    memset(bank->Iout, 0, sizeof(bank->Iout));
+    memset(bank->Dout, 0, sizeof(bank->Dout));
+    memset(bank->error, 0, sizeof(bank->error));
+    memset(bank->last_error, 0, sizeof(bank->last_error));
+}
+
+//Gains and limits in Q15.16, see PID_Q_CONST. num is capped at PID_BANK_MAX
+void PID_bank_q_init(PidBankQTypeDef *bank, uint8_t num, const int32_t PID[3], int32_t max_out, int32_t max_iout)
+{
+    if (bank == NULL || PID == NULL)
+    {
+        return;
+    }
+    bank->num = num < PID_BANK_MAX ? num : PID_BANK_MAX;
+    bank->Kp = PID[0];
+    bank->Ki = PID[1];
+    bank->Kd = PID[2];
+    bank->max_out = max_out;
+    bank->max_iout = max_iout;
+    PID_bank_q_clear(bank);
+}
+
+//PID_bank_calc in Q15.16. The errors are whole units, so gain * error is already
+//Q15.16 and needs no shift; the 64 bit products and sums go through
+//clip_q63_to_q31 before the limits, so a large error saturates instead of wrapping
+void PID_bank_q_calc(PidBankQTypeDef *bank, const int32_t *ref, const int32_t *set)
+{
+    const int32_t Kp = bank->Kp, Ki = bank->Ki, Kd = bank->Kd;
+    const int32_t max_out = bank->max_out, max_iout = bank->max_iout;
+    const uint8_t num = bank->num;
+
+    for (uint8_t i = 0; i < num; i++)
+    {
+        int32_t error = clip_q63_to_q31((q63_t)set[i] - ref[i]);
+        int32_t Pout = clip_q63_to_q31((q63_t)Kp * error);
+        int32_t Iout = clip_q63_to_q31(bank->Iout[i] + (q63_t)Ki * error);
+        Iout = Iout > max_iout ? max_iout : Iout;
+        Iout = Iout < -max_iout ? -max_iout : Iout;
+
+        int32_t Dout = clip_q63_to_q31((q63_t)Kd * ((q63_t)error - bank->error[i]));
+        int32_t out = clip_q63_to_q31((q63_t)Pout + Iout + Dout);
+        out = out > max_out ? max_out : out;
+        out = out < -max_out ? -max_out : out;
+
+        bank->set[i] = set[i];
+        bank->fdb[i] = ref[i];
+        bank->last_error[i] = bank->error[i];
+        bank->error[i] = error;
+        bank->Pout[i] = Pout;
+        bank->Iout[i] = Iout;
+        bank->Dout[i] = Dout;
+        bank->out[i] = out;
+    }
+}
+
+void PID_bank_q_clear(PidBankQTypeDef *bank)
+{
+    if (bank == NULL)
+    {
+        return;
+    }
+    memset(bank->set, 0, sizeof(bank->set));
+    memset(bank->fdb, 0, sizeof(bank->fdb));
+    memset(bank->out, 0, sizeof(bank->out));
+    memset(bank->Pout, 0, sizeof(bank->Pout));
+    memset(bank->Iout, 0, sizeof(bank->Iout));
+    memset(bank->Dout, 0, sizeof(bank->Dout));
+    memset(bank->error, 0, sizeof(bank->error));
+    memset(bank->last_error, 0, sizeof(bank->last_error));
+}
@@ -49,8 +49,134 @@ typedef struct
 
 } PidTypeDef;
 
+//Integrator handling of PidFullTypeDef when the output saturates
+enum PID_ANTI_WINDUP
+{
+    PID_AW_NONE = 0,    //integrate always, Iout only bounded by max_iout
+    PID_AW_CLAMP,       //stop integrating while the output is saturated in the direction of the error
+    PID_AW_BACK_CALC    //bleed the integrator by Kaw * (saturated - unsaturated output)
+};
+
+//Gains of PidFullTypeDef. Unlike PidTypeDef they are in physical time units, so
+//they stay valid when the loop rate changes
+typedef struct
+{
+    fp32 Kp;
+    fp32 Ki;            //per second
+    fp32 Kd;            //seconds, applied to the measurement only
+    fp32 d_cutoff_hz;   //first order low pass on the derivative, 0 leaves it unfiltered
+    fp32 Kff_vel;       //output per unit of setpoint velocity
+    fp32 Kff_acc;       //output per unit of setpoint acceleration
+    fp32 Kaw;           //back calculation gain, per second
+    uint8_t anti_windup;
+
+    fp32 max_out;
+    fp32 max_iout;
+} PidFullConfigTypeDef;
+
+//Position controller with filtered derivative on measurement, anti-windup,
+//velocity and acceleration feed-forward, and an explicit sample period
+typedef struct
+{
+    PidFullConfigTypeDef config;
+
+    fp32 set;
+    fp32 fdb;
+
+    fp32 out;
+    fp32 Pout;
+    fp32 Iout;
+    fp32 Dout;
+    fp32 Fout;
+    fp32 d_filtered;    //filtered measurement rate
+    fp32 last_fdb;
+    uint8_t started;    //0 until the first sample, which has no derivative
+
+} PidFullTypeDef;
+
+//Largest number of controllers in a PID bank
+#define PID_BANK_MAX 8
+
+//Bank of position mode controllers sharing gains and limits, each state variable
+//stored as one contiguous array so a single update runs over all of them
+typedef struct
+{
+    uint8_t num;
+
+    fp32 Kp;
+    fp32 Ki;
+    fp32 Kd;
+
+    fp32 max_out;
+    fp32 max_iout;
+
+    fp32 set[PID_BANK_MAX];
+    fp32 fdb[PID_BANK_MAX];
+
+    fp32 out[PID_BANK_MAX];
+    fp32 Pout[PID_BANK_MAX];
+    fp32 Iout[PID_BANK_MAX];
+    fp32 Dout[PID_BANK_MAX];
+    fp32 error[PID_BANK_MAX];
+    fp32 last_error[PID_BANK_MAX];
+
+} PidBankTypeDef;
+
+//1 runs the chassis wheel and trigger speed loops on PidBankQTypeDef instead of
+//float, which keeps those tasks off the FPU: the port then skips stacking
+//s16-s31 when it switches them out. The gimbal cascade stays in float
+#ifndef PID_FIXED_POINT
+#define PID_FIXED_POINT 0
+#endif
+
+//Fixed point values are Q15.16, a q31_t with PID_Q_FRAC_BITS fraction bits.
+//Inputs and outputs are whole motor units (rpm, current LSB)
+#define PID_Q_FRAC_BITS 16
+//Q15.16 of a constant, rounded to nearest. Folded by the compiler, no float at run time
+#define PID_Q_CONST(x) ((int32_t)((x) * (1 << PID_Q_FRAC_BITS) + ((x) < 0 ? -0.5 : 0.5)))
+//Whole units of a Q15.16 value, truncated toward zero like a float to int conversion
+#define PID_Q_TO_INT(q) ((q) / (1 << PID_Q_FRAC_BITS))
+#define PID_Q_FROM_INT(x) ((int32_t)(x) * (1 << PID_Q_FRAC_BITS))
+
+//PidBankTypeDef in fixed point. Gains, limits and the out/Pout/Iout/Dout terms
+//are Q15.16, set, fdb and errors whole units. Every sum and product saturates
+typedef struct
+{
+    uint8_t num;
+
+    int32_t Kp;
+    int32_t Ki;
+    int32_t Kd;
+
+    int32_t max_out;
+    int32_t max_iout;
+
+    int32_t set[PID_BANK_MAX];
+    int32_t fdb[PID_BANK_MAX];
+
+    int32_t out[PID_BANK_MAX];
+    int32_t Pout[PID_BANK_MAX];
+    int32_t Iout[PID_BANK_MAX];
+    int32_t Dout[PID_BANK_MAX];
+    int32_t error[PID_BANK_MAX];
+    int32_t last_error[PID_BANK_MAX];
+
+} PidBankQTypeDef;
+
 extern void PID_Init(PidTypeDef *pid, uint8_t mode, const fp32 PID[3], fp32 max_out, fp32 max_iout);
 extern fp32 PID_Calc(PidTypeDef *pid, fp32 ref, fp32 set);
 extern void PID_clear(PidTypeDef *pid);
 
+extern void PID_full_init(PidFullTypeDef *pid, const PidFullConfigTypeDef *config);
+extern fp32 PID_full_calc(PidFullTypeDef *pid, fp32 ref, fp32 set, fp32 ff_vel, fp32 ff_acc, fp32 dt);
+extern void PID_full_clear(PidFullTypeDef *pid);
+
+extern void PID_bank_init(PidBankTypeDef *bank, uint8_t num, const fp32 PID[3], fp32 max_out, fp32 max_iout);
+extern void PID_bank_calc(PidBankTypeDef *bank, const fp32 *ref, const fp32 *set);
+extern void PID_bank_clear(PidBankTypeDef *bank);
+
+extern void PID_bank_q_init(PidBankQTypeDef *bank, uint8_t num, const int32_t PID[3], int32_t max_out, int32_t max_iout);
+extern void PID_bank_q_calc(PidBankQTypeDef *bank, const int32_t *ref, const int32_t *set);
+extern void PID_bank_q_clear(PidBankQTypeDef *bank);
+
 #endif
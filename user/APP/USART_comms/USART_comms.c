@@ -1,27 +1,113 @@
-#include "stm32f4xx.h"
 #include "USART_comms.h"
+#include "hal.h"
 #include <stdio.h>
+#include <string.h>
 
-// Sends one string over USART
+// Log ring: writers copy in at head, the DMA reads straight out of the ring from tail.
+// tx_dma_len bytes from tail are owned by the running transfer
+static uint8_t tx_buf[SERIAL_TX_BUF_LEN];
+static uint16_t tx_head;
+static uint16_t tx_tail;
+static uint16_t tx_used;
+static uint16_t tx_dma_len;
+static serial_tx_stats_t tx_stats;
+
+static void serial_tx_start(void);
+
+// Queues bytes for USART6 without waiting on the UART. Safe from tasks and interrupts
+uint8_t serial_write(const uint8_t *data, uint16_t len)
+{
+	uint32_t irq_state = hal_irq_disable();
+
+	if (len > SERIAL_TX_BUF_LEN - tx_used) {
+		// A truncated debug line is worse than a missing one
+		tx_stats.bytes_dropped += len;
+		tx_stats.messages_dropped++;
+		hal_irq_restore(irq_state);
+		return 0;
+	}
+
+	uint16_t first = SERIAL_TX_BUF_LEN - tx_head;
+	if (first > len) {
+		first = len;
+	}
+	memcpy(&tx_buf[tx_head], data, first);
+	memcpy(tx_buf, data + first, len - first);
+	tx_head = (tx_head + len) & (SERIAL_TX_BUF_LEN - 1);
+	tx_used += len;
+	tx_stats.bytes_queued += len;
+	if (tx_used > tx_stats.max_used) {
+		tx_stats.max_used = tx_used;
+	}
+
+	if (tx_dma_len == 0) {
+		serial_tx_start();
+	}
+	hal_irq_restore(irq_state);
+	return 1;
+}
+
+// Copies the log channel counters
+void get_serial_tx_stats(serial_tx_stats_t *stats)
+{
+	uint32_t irq_state = hal_irq_disable();
+	*stats = tx_stats;
+	hal_irq_restore(irq_state);
+}
+
+// Hands the next contiguous run of the ring to the DMA, up to the wrap point.
+// Runs with interrupts masked or from the DMA interrupt
+static void serial_tx_start(void)
+{
+	uint16_t len = SERIAL_TX_BUF_LEN - tx_tail;
+	if (len > tx_used) {
+		len = tx_used;
+	}
+	if (len > 0 && hal_uart_dma_tx(HAL_USART6, &tx_buf[tx_tail], len)) {
+		tx_dma_len = len;
+	}
+}
+
+// USART6 TX DMA complete, frees the bytes just sent and starts on the rest.
+// After a transfer error it is unknown how much of the chunk went out, so the chunk is
+// dropped rather than resent; the telemetry decoder resyncs on the next frame delimiter.
+// Masked like serial_write: CAN, TIM4 and USART6 RX preempt this interrupt and may log
+void DMA2_Stream6_IRQHandler(void)
+{
+	uint32_t irq_state = hal_irq_disable();
+
+	if (hal_uart_dma_tx_error(HAL_USART6)) {
+		tx_tail = (tx_tail + tx_dma_len) & (SERIAL_TX_BUF_LEN - 1);
+		tx_used -= tx_dma_len;
+		tx_stats.bytes_dropped += tx_dma_len;
+		tx_stats.dma_errors++;
+		tx_dma_len = 0;
+		serial_tx_start();
+	}
+	if (hal_uart_dma_tx_done(HAL_USART6)) {
+		tx_tail = (tx_tail + tx_dma_len) & (SERIAL_TX_BUF_LEN - 1);
+		tx_used -= tx_dma_len;
+		tx_stats.bytes_sent += tx_dma_len;
+		tx_dma_len = 0;
+		serial_tx_start();
+	}
+	hal_irq_restore(irq_state);
+}
+
+// Queues one string for USART, returns before it is sent
 // Example usage: serial_send_string("Nando eats Nando's at Nando's");
 void serial_send_string(volatile char *str)
 {
-	while (*str) {
-		// Once previous byte is finished being transmitted, transmit next byte
-		while (USART_GetFlagStatus(USART6, USART_FLAG_TC) == RESET);
-		USART_SendData(USART6, *str);
-		str++;
-	}
+	serial_write((const uint8_t *)str, strlen((const char *)str));
 }
 
-// Send (a part of) an array
+// Send (a part of) an array, the low byte of each element
 // ** Assumes length <= length of array
 void serial_send_int_array(volatile int *arr, int length)
 {
 	for (int i = 0; i < length; i++) {
-		// Once previous byte is finished being transmitted, transmit next byte
-		while (USART_GetFlagStatus(USART6, USART_FLAG_TC) == RESET);
-		USART_SendData(USART6, *arr);
+		uint8_t byte = *arr;
+		serial_write(&byte, 1);
 		arr++;
 	}
 }
@@ -1,5 +1,25 @@
 #ifndef USART_COMMS_H
 #define USART_COMMS_H
+#include "main.h"
+
+// USART6 log ring, must be a power of 2. At 115200 baud it drains ~11.5 bytes per ms
+#define SERIAL_TX_BUF_LEN 1024
+
+// Log channel counters
+typedef struct
+{
+	uint32_t bytes_queued;
+	uint32_t bytes_sent;
+	uint32_t bytes_dropped;
+	uint32_t messages_dropped;	// writes refused whole because the ring was full
+	uint16_t max_used;			// high water mark of the ring
+	uint32_t dma_errors;		// transfers stopped by a DMA transfer error, their bytes count as dropped
+} serial_tx_stats_t;
+
+// Queues bytes for the DMA and returns at once, returns 0 and drops the whole write if it does not fit
+extern uint8_t serial_write(const uint8_t *data, uint16_t len);
+// Copies the log channel counters
+extern void get_serial_tx_stats(serial_tx_stats_t *stats);
 
 extern void serial_send_string(volatile char *str);
 extern void serial_send_int_array(volatile int *arr, int length);
@@ -0,0 +1,590 @@
+/**
+  ******************************************************************************
+    * @file    APP/aim
+    * @date    16-October-2026
+    * @brief   Target predictor, see aim.h.
+    * @attention The three axes share one filter: the measurement noise is much
+    *          larger along the line of sight than across it, which couples them.
+    *          With 9 states at most and one frame per 10 ms the matrix work is a
+    *          few thousand multiply-adds per frame.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "aim.h"
+#include "hal.h"
+
+#include <math.h>
+#include <string.h>
+
+
+/******************** Private User Declarations ********************/
+
+#define AIM_HISTORY_MASK (AIM_HISTORY_LEN - 1u)
+#define AIM_CYCLES_TO_S(cycles) ((fp32)(int32_t)(cycles) / HAL_CYCLE_HZ)
+
+//1 / k! for the Taylor terms of the motion model
+static const fp32 aim_inv_factorial[4] = {1.0f, 1.0f, 0.5f, 1.0f / 6.0f};
+
+static void aim_quat_rotate(const fp32 quat[4], const fp32 in[3], fp32 out[3]);
+static void aim_measurement_noise(const fp32 world[3], fp32 R[3][3]);
+static void aim_start_track(aim_predictor_t *aim, const fp32 world[3], const fp32 R[3][3], uint32_t cycles);
+static void aim_kf_predict(aim_predictor_t *aim, fp32 dt);
+static fp32 aim_kf_update(aim_predictor_t *aim, const fp32 world[3], const fp32 R[3][3]);
+static void aim_extrapolate(const fp32 x[AIM_STATE_MAX], aim_model_e model, fp32 dt, fp32 position[3],
+                            fp32 velocity[3]);
+static fp32 aim_significance(const aim_predictor_t *aim, uint8_t order);
+static uint8_t aim_invert3(const fp32 m[3][3], fp32 inv[3][3]);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+/**
+* @brief  Clears the track and the attitude history
+* @param  aim: predictor to reset
+* @param  model: motion model of the target
+* @retval None
+*/
+void aim_init(aim_predictor_t *aim, aim_model_e model)
+{
+    memset(aim, 0, sizeof(*aim));
+    aim->model = model;
+}
+
+
+/**
+* @brief  Records the attitude at a point in time, call every gimbal iteration
+* @param  aim: predictor
+* @param  cycles: hal_cycle_count() the attitude belongs to
+* @param  quat: INS quaternion w, x, y, z
+* @retval None
+*/
+void aim_attitude_push(aim_predictor_t *aim, uint32_t cycles, const fp32 quat[4])
+{
+    aim_attitude_t *sample = &aim->history[aim->history_head];
+
+    sample->cycles = cycles;
+    memcpy(sample->quat, quat, sizeof(sample->quat));
+    aim->history_head = (aim->history_head + 1u) & AIM_HISTORY_MASK;
+    if (aim->history_count < AIM_HISTORY_LEN)
+    {
+        aim->history_count++;
+    }
+}
+
+
+/**
+* @brief  Attitude at a point in time, normalised linear interpolation between the
+*         two samples around it. Later than the newest sample gives the newest
+* @param  aim: predictor
+* @param  cycles: time to look up
+* @param  quat: filled in, identity if there is no sample at all
+* @retval 0 if the time is older than the history, quat is then the oldest sample
+*/
+uint8_t aim_attitude_at(const aim_predictor_t *aim, uint32_t cycles, fp32 quat[4])
+{
+    const aim_attitude_t *newer = NULL;
+
+    if (aim->history_count == 0)
+    {
+        quat[0] = 1.0f;
+        quat[1] = quat[2] = quat[3] = 0.0f;
+        return 0;
+    }
+    //Newest first, the latency is short compared to the history
+    for (uint16_t i = 1; i <= aim->history_count; i++)
+    {
+        const aim_attitude_t *older = &aim->history[(aim->history_head - i) & AIM_HISTORY_MASK];
+        int32_t after = (int32_t)(cycles - older->cycles);
+
+        if (after < 0)
+        {
+            newer = older;
+            continue;
+        }
+        if (newer == NULL)
+        {
+            memcpy(quat, older->quat, sizeof(older->quat));
+            return 1;
+        }
+
+        fp32 t = (fp32)after / (fp32)(int32_t)(newer->cycles - older->cycles);
+        //Same hemisphere, q and -q are the same rotation
+        fp32 sign = older->quat[0] * newer->quat[0] + older->quat[1] * newer->quat[1] +
+                    older->quat[2] * newer->quat[2] + older->quat[3] * newer->quat[3] < 0.0f ? -1.0f : 1.0f;
+        fp32 norm = 0.0f;
+        for (uint8_t k = 0; k < 4; k++)
+        {
+            quat[k] = (1.0f - t) * older->quat[k] + t * sign * newer->quat[k];
+            norm += quat[k] * quat[k];
+        }
+        norm = 1.0f / sqrtf(norm);
+        for (uint8_t k = 0; k < 4; k++)
+        {
+            quat[k] *= norm;
+        }
+        return 1;
+    }
+    memcpy(quat, newer->quat, sizeof(newer->quat));
+    return 0;
+}
+
+
+/**
+* @brief  Target position of a frame in the world frame
+* @param  quat: camera attitude when the frame was captured
+* @param  frame: yaw, pitch and distance relative to the camera
+* @param  world: filled in, m
+* @retval None
+*/
+void aim_camera_to_world(const fp32 quat[4], const vision_frame_t *frame, fp32 world[3])
+{
+    fp32 camera[3];
+    fp32 across = frame->distance * cosf(frame->pitch);
+
+    camera[0] = across * cosf(frame->yaw);
+    camera[1] = across * sinf(frame->yaw);
+    camera[2] = frame->distance * sinf(frame->pitch);
+    aim_quat_rotate(quat, camera, world);
+}
+
+
+/**
+* @brief  Feeds a vision frame to the filter. The frame is re-projected through the
+*         attitude at its capture time, the filter is moved to that time and updated.
+*         Frames outside the gate are dropped until AIM_GATE_RESETS in a row restart
+*         the track on the new target
+* @param  aim: predictor
+* @param  target: newest frame from get_vision_target_point
+* @retval 1 if the frame updated or started the track
+*/
+uint8_t aim_measure(aim_predictor_t *aim, const vision_target_t *target)
+{
+    fp32 quat[4], world[3], R[3][3];
+
+    if (target->count == 0 || target->count == aim->last_vision_count)
+    {
+        return 0;
+    }
+    aim->last_vision_count = target->count;
+    if (!(target->frame.flags & VISION_FLAG_TARGET) || target->frame.distance <= 0.0f)
+    {
+        return 0;
+    }
+    aim->stats.measurements++;
+
+    if (!aim_attitude_at(aim, target->capture_cycles, quat))
+    {
+        aim->stats.history_misses++;
+    }
+    aim_camera_to_world(quat, &target->frame, world);
+    aim_measurement_noise(world, R);
+
+    int32_t since_state = (int32_t)(target->capture_cycles - aim->state_cycles);
+    if (aim->updates == 0 || since_state > (int32_t)(AIM_TRACK_TIMEOUT_US * HAL_CYCLES_PER_US))
+    {
+        aim_start_track(aim, world, R, target->capture_cycles);
+        return 1;
+    }
+    //Capture times only go backwards by the rounding of latency_us
+    if (since_state > 0)
+    {
+        aim_kf_predict(aim, AIM_CYCLES_TO_S(since_state));
+        aim->state_cycles = target->capture_cycles;
+    }
+
+    if (aim_kf_update(aim, world, R) > AIM_GATE)
+    {
+        aim->stats.gated++;
+        if (++aim->outliers < AIM_GATE_RESETS)
+        {
+            return 0;
+        }
+        aim_start_track(aim, world, R, target->capture_cycles);
+        return 1;
+    }
+    aim->outliers = 0;
+    if (aim->updates < 0xFFFF)
+    {
+        aim->updates++;
+    }
+    return 1;
+}
+
+
+/**
+* @brief  Predicted target position at a point in time
+* @param  aim: predictor
+* @param  cycles: time to predict for
+* @param  position: filled in, world frame m
+* @param  velocity: filled in, m/s, may be NULL
+* @retval 0 if there is no usable track at that time
+*/
+uint8_t aim_predict(const aim_predictor_t *aim, uint32_t cycles, fp32 position[3], fp32 velocity[3])
+{
+    int32_t since_state = (int32_t)(cycles - aim->state_cycles);
+
+    if (aim->updates < AIM_TRACK_MIN_UPDATES || since_state > (int32_t)(AIM_TRACK_TIMEOUT_US * HAL_CYCLES_PER_US))
+    {
+        return 0;
+    }
+    aim_extrapolate(aim->x, aim->model, AIM_CYCLES_TO_S(since_state), position, velocity);
+    return 1;
+}
+
+
+/**
+* @brief  Aim for a projectile fired from the origin at speed, no drag. Of the two
+*         gravity arcs through the target the flat one is taken
+* @param  position: target, world frame m
+* @param  speed: muzzle speed m/s
+* @param  yaw, pitch: filled in, INS_Angle convention
+* @param  flight_time: filled in, s
+* @retval 0 if the target is out of reach, pitch and flight_time are then the straight line's
+*/
+uint8_t aim_ballistic(const fp32 position[3], fp32 speed, fp32 *yaw, fp32 *pitch, fp32 *flight_time)
+{
+    fp32 across = sqrtf(position[0] * position[0] + position[1] * position[1]);
+    fp32 height = position[2];
+    fp32 v2 = speed * speed;
+    fp32 discriminant = v2 * v2 - AIM_GRAVITY * (AIM_GRAVITY * across * across + 2.0f * height * v2);
+
+    *yaw = atan2f(position[1], position[0]);
+    if (speed <= 0.0f || across < 1e-3f || discriminant < 0.0f)
+    {
+        *pitch = -atan2f(height, across);
+        *flight_time = speed > 0.0f ? sqrtf(across * across + height * height) / speed : 0.0f;
+        return 0;
+    }
+    fp32 elevation = atanf((v2 - sqrtf(discriminant)) / (AIM_GRAVITY * across));
+    *pitch = -elevation;
+    *flight_time = across / (speed * cosf(elevation));
+    return 1;
+}
+
+
+/**
+* @brief  Where to point now: the filter's prediction for now plus the flight time,
+*         which is found by iterating since it depends on where the target will be.
+*         A velocity or acceleration within the noise of its own estimate is taken as
+*         zero, so a still target is not led by the filter's jitter
+* @param  aim: predictor
+* @param  now_cycles: hal_cycle_count() of the gimbal iteration
+* @param  solution: filled in, valid is 0 without a usable track
+* @retval None
+*/
+void aim_solve(const aim_predictor_t *aim, uint32_t now_cycles, aim_solution_t *solution)
+{
+    fp32 position[3], velocity[3], x[AIM_STATE_MAX];
+
+    solution->valid = aim_predict(aim, now_cycles, position, velocity);
+    if (!solution->valid)
+    {
+        return;
+    }
+    memcpy(x, aim->x, sizeof(x));
+    for (uint8_t order = 1; order < aim->model; order++)
+    {
+        if (aim_significance(aim, order) < AIM_LEAD_SIGNIFICANCE)
+        {
+            memset(&x[3 * order], 0, 3 * sizeof(fp32));
+        }
+    }
+    fp32 now = AIM_CYCLES_TO_S(now_cycles - aim->state_cycles);
+    solution->flight_time = 0.0f;
+    for (uint8_t i = 0; i < AIM_LEAD_ITERATIONS; i++)
+    {
+        aim_extrapolate(x, aim->model, now + solution->flight_time, position, velocity);
+        solution->reachable = aim_ballistic(position, AIM_BULLET_SPEED, &solution->yaw, &solution->pitch,
+                                            &solution->flight_time);
+    }
+    fp32 across2 = position[0] * position[0] + position[1] * position[1];
+    solution->yaw_rate = across2 > 1e-6f ? (position[0] * velocity[1] - position[1] * velocity[0]) / across2 : 0.0f;
+    solution->distance = sqrtf(across2 + position[2] * position[2]);
+}
+
+
+
+/******************** Private Functions ********************/
+
+//v' = v + 2w (u x v) + 2 u x (u x v), u the vector part
+static void aim_quat_rotate(const fp32 quat[4], const fp32 in[3], fp32 out[3])
+{
+    fp32 w = quat[0], x = quat[1], y = quat[2], z = quat[3];
+    fp32 tx = 2.0f * (y * in[2] - z * in[1]);
+    fp32 ty = 2.0f * (z * in[0] - x * in[2]);
+    fp32 tz = 2.0f * (x * in[1] - y * in[0]);
+
+    out[0] = in[0] + w * tx + (y * tz - z * ty);
+    out[1] = in[1] + w * ty + (z * tx - x * tz);
+    out[2] = in[2] + w * tz + (x * ty - y * tx);
+}
+
+//Angle noise across the line of sight, range noise along it
+static void aim_measurement_noise(const fp32 world[3], fp32 R[3][3])
+{
+    fp32 distance2 = world[0] * world[0] + world[1] * world[1] + world[2] * world[2];
+    fp32 across = AIM_ANGLE_NOISE * AIM_ANGLE_NOISE * distance2;
+    fp32 along = AIM_RANGE_NOISE * AIM_RANGE_NOISE * distance2;
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            R[i][j] = (along - across) * world[i] * world[j] / distance2 + (i == j ? across : 0.0f);
+        }
+    }
+}
+
+static void aim_start_track(aim_predictor_t *aim, const fp32 world[3], const fp32 R[3][3], uint32_t cycles)
+{
+    static const fp32 derivative_var[3] = {0.0f, AIM_INIT_VELOCITY_STD * AIM_INIT_VELOCITY_STD,
+                                           AIM_INIT_ACCEL_STD * AIM_INIT_ACCEL_STD};
+
+    memset(aim->x, 0, sizeof(aim->x));
+    memset(aim->P, 0, sizeof(aim->P));
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        aim->x[i] = world[i];
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            aim->P[i][j] = R[i][j];
+        }
+        for (uint8_t r = 1; r < aim->model; r++)
+        {
+            aim->P[3 * r + i][3 * r + i] = derivative_var[r];
+        }
+    }
+    aim->state_cycles = cycles;
+    aim->updates = 1;
+    aim->outliers = 0;
+    aim->stats.resets++;
+}
+
+/**
+* @brief  x = F x, P = F P F' + Q. F and Q act on each axis alike, so they are built as
+*         model sized blocks: F[r][c] = dt^(c-r) / (c-r)!, Q the white noise integral
+* @param  aim: predictor
+* @param  dt: s, > 0
+* @retval None
+*/
+static void aim_kf_predict(aim_predictor_t *aim, fp32 dt)
+{
+    uint8_t n = aim->model;
+    uint8_t size = 3 * n;
+    fp32 F[3][3] = {{0}};
+    fp32 dt_pow[6] = {1.0f};
+    fp32 T[AIM_STATE_MAX][AIM_STATE_MAX];
+    fp32 x[AIM_STATE_MAX];
+    fp32 q = n == AIM_MODEL_CV ? AIM_CV_PROCESS_NOISE : AIM_CA_PROCESS_NOISE;
+
+    for (uint8_t k = 1; k < 6; k++)
+    {
+        dt_pow[k] = dt_pow[k - 1] * dt;
+    }
+    for (uint8_t r = 0; r < n; r++)
+    {
+        for (uint8_t c = r; c < n; c++)
+        {
+            F[r][c] = dt_pow[c - r] * aim_inv_factorial[c - r];
+        }
+    }
+
+    memcpy(x, aim->x, sizeof(x));
+    for (uint8_t i = 0; i < size; i++)
+    {
+        uint8_t r = i / 3, axis = i % 3;
+        aim->x[i] = 0.0f;
+        for (uint8_t c = r; c < n; c++)
+        {
+            aim->x[i] += F[r][c] * x[3 * c + axis];
+        }
+    }
+
+    //T = F P, then P = T F'
+    for (uint8_t i = 0; i < size; i++)
+    {
+        uint8_t r = i / 3, axis = i % 3;
+        for (uint8_t j = 0; j < size; j++)
+        {
+            T[i][j] = 0.0f;
+            for (uint8_t c = r; c < n; c++)
+            {
+                T[i][j] += F[r][c] * aim->P[3 * c + axis][j];
+            }
+        }
+    }
+    for (uint8_t i = 0; i < size; i++)
+    {
+        for (uint8_t j = 0; j < size; j++)
+        {
+            uint8_t r = j / 3, axis = j % 3;
+            aim->P[i][j] = 0.0f;
+            for (uint8_t c = r; c < n; c++)
+            {
+                aim->P[i][j] += T[i][3 * c + axis] * F[r][c];
+            }
+        }
+    }
+
+    //Q[r][c] = q dt^(2n-1-r-c) / ((n-1-r)! (n-1-c)! (2n-1-r-c)), same axis only
+    for (uint8_t r = 0; r < n; r++)
+    {
+        for (uint8_t c = 0; c < n; c++)
+        {
+            uint8_t order = 2 * n - 1 - r - c;
+            fp32 Q = q * dt_pow[order] * aim_inv_factorial[n - 1 - r] * aim_inv_factorial[n - 1 - c] / order;
+            for (uint8_t axis = 0; axis < 3; axis++)
+            {
+                aim->P[3 * r + axis][3 * c + axis] += Q;
+            }
+        }
+    }
+}
+
+/**
+* @brief  Position measurement update, H picks the first three states. Skipped if the
+*         innovation is outside AIM_GATE
+* @param  aim: predictor
+* @param  world: measured position
+* @param  R: its covariance
+* @retval squared Mahalanobis distance of the innovation
+*/
+static fp32 aim_kf_update(aim_predictor_t *aim, const fp32 world[3], const fp32 R[3][3])
+{
+    uint8_t size = 3 * aim->model;
+    fp32 S[3][3], S_inv[3][3], K[AIM_STATE_MAX][3], PH[AIM_STATE_MAX][3];
+    fp32 y[3], S_inv_y[3];
+    fp32 distance2 = 0.0f;
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        y[i] = world[i] - aim->x[i];
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            S[i][j] = aim->P[i][j] + R[i][j];
+        }
+    }
+    if (!aim_invert3(S, S_inv))
+    {
+        return 0.0f;
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        S_inv_y[i] = S_inv[i][0] * y[0] + S_inv[i][1] * y[1] + S_inv[i][2] * y[2];
+        distance2 += y[i] * S_inv_y[i];
+    }
+    if (distance2 > AIM_GATE)
+    {
+        return distance2;
+    }
+
+    for (uint8_t i = 0; i < size; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            PH[i][j] = aim->P[i][j];
+        }
+    }
+    for (uint8_t i = 0; i < size; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            K[i][j] = PH[i][0] * S_inv[0][j] + PH[i][1] * S_inv[1][j] + PH[i][2] * S_inv[2][j];
+        }
+        aim->x[i] += K[i][0] * y[0] + K[i][1] * y[1] + K[i][2] * y[2];
+    }
+    //P -= K H P, H P is the first three rows of P, i.e. PH transposed
+    for (uint8_t i = 0; i < size; i++)
+    {
+        for (uint8_t j = 0; j < size; j++)
+        {
+            aim->P[i][j] -= K[i][0] * PH[j][0] + K[i][1] * PH[j][1] + K[i][2] * PH[j][2];
+        }
+    }
+    //Keep it symmetric against rounding
+    for (uint8_t i = 0; i < size; i++)
+    {
+        for (uint8_t j = i + 1; j < size; j++)
+        {
+            fp32 mean = 0.5f * (aim->P[i][j] + aim->P[j][i]);
+            aim->P[i][j] = aim->P[j][i] = mean;
+        }
+    }
+    return distance2;
+}
+
+//Position and velocity of state x dt seconds on, velocity may be NULL
+static void aim_extrapolate(const fp32 x[AIM_STATE_MAX], aim_model_e model, fp32 dt, fp32 position[3],
+                            fp32 velocity[3])
+{
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        fp32 p = 0.0f, v = 0.0f, dt_pow = 1.0f;
+        for (uint8_t c = 0; c < (uint8_t)model; c++)
+        {
+            p += x[3 * c + axis] * dt_pow * aim_inv_factorial[c];
+            if (c + 1 < (uint8_t)model)
+            {
+                v += x[3 * (c + 1) + axis] * dt_pow * aim_inv_factorial[c];
+            }
+            dt_pow *= dt;
+        }
+        position[axis] = p;
+        if (velocity != NULL)
+        {
+            velocity[axis] = v;
+        }
+    }
+}
+
+//Squared Mahalanobis distance from zero of the velocity (order 1) or acceleration (order 2)
+static fp32 aim_significance(const aim_predictor_t *aim, uint8_t order)
+{
+    fp32 P[3][3], P_inv[3][3];
+    const fp32 *d = &aim->x[3 * order];
+    fp32 distance2 = 0.0f;
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            P[i][j] = aim->P[3 * order + i][3 * order + j];
+        }
+    }
+    if (!aim_invert3(P, P_inv))
+    {
+        return 0.0f;
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        distance2 += d[i] * (P_inv[i][0] * d[0] + P_inv[i][1] * d[1] + P_inv[i][2] * d[2]);
+    }
+    return distance2;
+}
+
+static uint8_t aim_invert3(const fp32 m[3][3], fp32 inv[3][3])
+{
+    fp32 c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    fp32 c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    fp32 c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    fp32 det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+
+    if (fabsf(det) < 1e-20f)
+    {
+        return 0;
+    }
+    fp32 inv_det = 1.0f / det;
+    inv[0][0] = c00 * inv_det;
+    inv[1][0] = c01 * inv_det;
+    inv[2][0] = c02 * inv_det;
+    inv[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inv_det;
+    inv[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inv_det;
+    inv[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inv_det;
+    inv[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inv_det;
+    inv[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inv_det;
+    inv[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inv_det;
+    return 1;
+}
@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+    * @file    APP/aim
+    * @date    16-October-2026
+    * @brief   Latency compensated target prediction for vision aiming. Vision
+    *          frames are 20 ~ 60 ms old when they arrive, and the gimbal has
+    *          moved since. The gimbal pushes its attitude (INS quaternion) every
+    *          iteration into a short history; each frame is re-projected through
+    *          the attitude at its capture time into the world frame, where a
+    *          constant velocity or constant acceleration Kalman filter tracks the
+    *          target. The aim is the filter's prediction for now plus the
+    *          projectile's flight time, raised for gravity.
+    * @attention World frame: the AHRS navigation frame, x forward at start, z up.
+    *          Camera frame: the IMU board's, x forward, y left, z up; the camera
+    *          sits on the pitch stage with the board and its offset from the
+    *          pivot is ignored. Aim angles follow get_angle (INS_Angle): yaw is
+    *          atan2(y, x), pitch is asin(-z / |p|), nose down positive.
+  ******************************************************************************
+**/
+
+#ifndef AIM_H
+#define AIM_H
+#include "main.h"
+#include "vision.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+//Attitude samples kept, must be a power of 2. At one per ms this covers the worst latency
+#define AIM_HISTORY_LEN 128u
+
+//Kalman filter. Process noise is the spectral density of the first derivative the model
+//leaves out: acceleration for AIM_MODEL_CV, jerk for AIM_MODEL_CA
+#define AIM_CV_PROCESS_NOISE 5.0f       // (m/s^2)^2 / Hz
+#define AIM_CA_PROCESS_NOISE 1000.0f    // (m/s^3)^2 / Hz
+//Measurement noise: across the line of sight from the angles, along it from the range
+#define AIM_ANGLE_NOISE 0.003f          // rad
+#define AIM_RANGE_NOISE 0.03f           // fraction of the distance
+//Initial spread of the derivatives a new track starts at zero
+#define AIM_INIT_VELOCITY_STD 3.0f      // m/s
+#define AIM_INIT_ACCEL_STD 10.0f        // m/s^2
+//Innovation gate, chi-square with 3 degrees of freedom at 99.9%. This many frames in a
+//row outside it mean the vision PC switched targets and the track restarts
+#define AIM_GATE 16.27f
+#define AIM_GATE_RESETS 3
+//Updates before the track is used, and the longest gap before it is dropped
+#define AIM_TRACK_MIN_UPDATES 3
+#define AIM_TRACK_TIMEOUT_US 200000
+
+//Projectile: 17 mm muzzle speed, no drag
+#define AIM_BULLET_SPEED 18.0f          // m/s
+#define AIM_GRAVITY 9.81f               // m/s^2
+//Velocity and acceleration are only led when their squared Mahalanobis distance from zero
+//is above this, chi-square with 3 degrees of freedom at 99.9%
+#define AIM_LEAD_SIGNIFICANCE 16.27f
+//Flight time iterations: the flight time moves the target, which changes the flight time
+#define AIM_LEAD_ITERATIONS 3
+
+typedef enum
+{
+    AIM_MODEL_CV = 2,   //constant velocity, state per axis: position, velocity
+    AIM_MODEL_CA = 3,   //constant acceleration, state per axis: position, velocity, acceleration
+} aim_model_e;
+
+#define AIM_STATE_MAX 9
+
+typedef struct
+{
+    uint32_t cycles;    //hal_cycle_count() when it was taken
+    fp32 quat[4];       //w, x, y, z, camera to world
+} aim_attitude_t;
+
+typedef struct
+{
+    uint32_t measurements;      //frames with a target
+    uint32_t gated;             //frames outside the innovation gate
+    uint32_t resets;            //tracks started
+    uint32_t history_misses;    //frames captured before the oldest attitude sample
+} aim_stats_t;
+
+typedef struct
+{
+    aim_model_e model;
+    //State [position xyz, velocity xyz, acceleration xyz] in the world frame at state_cycles
+    fp32 x[AIM_STATE_MAX];
+    fp32 P[AIM_STATE_MAX][AIM_STATE_MAX];
+    uint32_t state_cycles;
+    uint16_t updates;           //0 when there is no track
+    uint8_t outliers;           //frames in a row outside the gate
+    uint32_t last_vision_count; //count of the last vision_target_t taken
+
+    aim_attitude_t history[AIM_HISTORY_LEN];
+    uint16_t history_head;      //next slot to write
+    uint16_t history_count;
+
+    aim_stats_t stats;
+} aim_predictor_t;
+
+typedef struct
+{
+    uint8_t valid;          //a track is up, the rest is meaningless otherwise
+    uint8_t reachable;      //the projectile can reach the target, pitch is the straight line if not
+    fp32 yaw;               //rad, INS_Angle convention
+    fp32 pitch;
+    fp32 yaw_rate;          //rad/s of the aim point's yaw, gimbal feed-forward
+    fp32 distance;          //m to the aim point
+    fp32 flight_time;       //s
+} aim_solution_t;
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Clears the track and the attitude history
+extern void aim_init(aim_predictor_t *aim, aim_model_e model);
+//Records the attitude at a point in time, call every gimbal iteration
+extern void aim_attitude_push(aim_predictor_t *aim, uint32_t cycles, const fp32 quat[4]);
+//Attitude at a point in time, interpolated; returns 0 and the oldest sample if it is too old
+extern uint8_t aim_attitude_at(const aim_predictor_t *aim, uint32_t cycles, fp32 quat[4]);
+//Target position of a frame in the world frame, seen through the given attitude
+extern void aim_camera_to_world(const fp32 quat[4], const vision_frame_t *frame, fp32 world[3]);
+//Feeds a vision frame to the filter, frames already taken are ignored. Returns 1 if it was used
+extern uint8_t aim_measure(aim_predictor_t *aim, const vision_target_t *target);
+//Predicted target position at a point in time, returns 0 without a track
+extern uint8_t aim_predict(const aim_predictor_t *aim, uint32_t cycles, fp32 position[3], fp32 velocity[3]);
+//Yaw, pitch and flight time to hit a world position with a projectile fired from the origin
+extern uint8_t aim_ballistic(const fp32 position[3], fp32 speed, fp32 *yaw, fp32 *pitch, fp32 *flight_time);
+//Where to point now, leading the target by the flight time
+extern void aim_solve(const aim_predictor_t *aim, uint32_t now_cycles, aim_solution_t *solution);
+
+#endif
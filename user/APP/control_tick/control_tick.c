@@ -0,0 +1,272 @@
+/**
+  ******************************************************************************
+    * @file    APP/control_tick
+    * @date    16-October-2026
+    * @brief   Control tick: feedback latch, task release and phase aligned command
+    *          transmission, all driven by TIM4. See control_tick.h.
+    * @attention TIM4 must be configured by TIM4_Init in hardware/timer.c before
+    *          control_tick_init starts it. Its interrupt runs at TIM4_NVIC, low
+    *          enough to call the FreeRTOS FromISR API; the CAN interrupts above it
+    *          can still delay the transmit phase by a few microseconds.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "control_tick.h"
+#include "CAN_receive.h"
+#include "trace.h"
+
+#include <string.h>
+
+
+/******************** Private User Declarations ********************/
+
+typedef struct
+{
+    TaskHandle_t handle;
+    uint8_t divider;
+    //Set on release, cleared when the task comes back to control_tick_wait
+    volatile uint8_t running;
+    uint32_t release_tick;
+    uint32_t release_time;
+    //Command waiting for the transmit phase
+    volatile uint8_t staged;
+    hal_can_e can;
+    hal_can_frame_t frame;
+    uint32_t last_tx_time;
+    control_tick_task_stats_t stats;
+} control_tick_slot_t;
+
+static const uint32_t jitter_edges_us[CONTROL_TICK_JITTER_BINS - 1] = CONTROL_TICK_JITTER_EDGES_US;
+
+static control_tick_slot_t control_tick_slot[CONTROL_TICK_TASK_NUM];
+static volatile uint32_t control_tick_count;
+static uint32_t control_tick_time;
+
+//Latches feedback and releases the tasks due this tick
+static void control_tick_update(void);
+//Sends every staged command
+static void control_tick_transmit(void);
+//Hands a command to the CAN queue and records its interval
+static void control_tick_tx(control_tick_slot_t *slot, const hal_can_frame_t *frame);
+//Adds a duration to a histogram
+static void jitter_hist_add(uint32_t hist[CONTROL_TICK_JITTER_BINS], uint32_t *max_cycles, uint32_t cycles);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+/**
+* @brief  Clears the task slots and starts TIM4 at CONTROL_TICK_HZ with the compare
+*         channel at CONTROL_TICK_TX_OFFSET_US. Tasks registering later are picked
+*         up from the next tick on.
+* @param  None
+* @retval None
+*/
+void control_tick_init(void)
+{
+    memset(control_tick_slot, 0, sizeof(control_tick_slot));
+    control_tick_count = 0;
+    control_tick_time = hal_cycle_count();
+
+#if CONTROL_TICK_ENABLE
+    //TIM4 counts microseconds
+    hal_timer_set_compare(HAL_TIMER_CONTROL_TICK, CONTROL_TICK_TX_OFFSET_US);
+    hal_timer_start(HAL_TIMER_CONTROL_TICK, CONTROL_TICK_PERIOD_US - 1);
+#endif
+}
+
+
+/**
+* @brief  Binds a task to a slot. Called by the task itself before its loop
+* @param  task: slot of the calling task
+* @param  handle: task to notify, normally xTaskGetCurrentTaskHandle()
+* @param  divider: release every divider ticks, the old vTaskDelay value in ms
+* @retval None
+*/
+void control_tick_register_task(control_tick_task_e task, TaskHandle_t handle, uint8_t divider)
+{
+    control_tick_slot_t *slot = &control_tick_slot[task];
+    uint32_t irq_state = hal_irq_disable();
+
+    slot->divider = divider ? divider : 1;
+    slot->handle = handle;
+    slot->running = 0;
+    hal_irq_restore(irq_state);
+}
+
+
+/**
+* @brief  Blocks the calling task until the tick releases it again. A task that
+*         overran its period finds the notification already pending and runs at once.
+* @param  task: slot of the calling task
+* @retval None
+*/
+void control_tick_wait(control_tick_task_e task)
+{
+    control_tick_slot_t *slot = &control_tick_slot[task];
+
+#if CONTROL_TICK_ENABLE
+    slot->running = 0;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    uint32_t irq_state = hal_irq_disable();
+    jitter_hist_add(slot->stats.wake_latency_hist, &slot->stats.max_wake_latency_cycles,
+                    hal_cycle_count() - slot->release_time);
+    hal_irq_restore(irq_state);
+#else
+    vTaskDelay(slot->divider * configTICK_RATE_HZ / CONTROL_TICK_HZ);
+#endif
+}
+
+
+/**
+* @brief  Stages a command for the transmit phase of the current period. Without
+*         the tick it is sent right away, so the histograms show the old phase jitter.
+* @param  task: slot of the calling task
+* @param  can: bus to send on
+* @param  frame: command, copied
+* @retval None
+*/
+void control_tick_send(control_tick_task_e task, hal_can_e can, const hal_can_frame_t *frame)
+{
+    control_tick_slot_t *slot = &control_tick_slot[task];
+    uint32_t irq_state = hal_irq_disable();
+
+#if CONTROL_TICK_ENABLE
+    slot->can = can;
+    slot->frame = *frame;
+    slot->staged = 1;
+#else
+    slot->can = can;
+    control_tick_tx(slot, frame);
+#endif
+    hal_irq_restore(irq_state);
+}
+
+
+//Ticks since control_tick_init
+uint32_t get_control_tick_count(void)
+{
+    return control_tick_count;
+}
+
+
+//Copies the counters and histograms of a task
+void get_control_tick_task_stats(control_tick_task_e task, control_tick_task_stats_t *stats)
+{
+    uint32_t irq_state = hal_irq_disable();
+    *stats = control_tick_slot[task].stats;
+    hal_irq_restore(irq_state);
+}
+
+
+/**
+* @brief  TIM4 interrupt handler. The transmit phase is handled first: if both flags
+*         are pending the interrupt was held off past the end of the period.
+* @param  None
+* @retval None
+*/
+void TIM4_IRQHandler(void)
+{
+    if (hal_timer_compare_flag(HAL_TIMER_CONTROL_TICK))
+    {
+        control_tick_transmit();
+    }
+    if (hal_timer_update_flag(HAL_TIMER_CONTROL_TICK))
+    {
+        control_tick_update();
+    }
+}
+
+
+
+/******************** Private Functions ********************/
+
+/**
+* @brief  Start of a period: every task due this tick sees the same feedback latch
+* @param  None
+* @retval None
+*/
+static void control_tick_update(void)
+{
+    BaseType_t woken = pdFALSE;
+    //Every task is due on the first tick
+    uint32_t period = control_tick_count++;
+
+    control_tick_time = hal_cycle_count();
+    CAN_latch_motor_feedback();
+
+    for (uint8_t i = 0; i < CONTROL_TICK_TASK_NUM; i++)
+    {
+        control_tick_slot_t *slot = &control_tick_slot[i];
+        if (slot->handle == NULL || period % slot->divider != 0)
+        {
+            continue;
+        }
+        slot->running = 1;
+        slot->release_tick = control_tick_count;
+        slot->release_time = control_tick_time;
+        slot->stats.releases++;
+        vTaskNotifyGiveFromISR(slot->handle, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+
+/**
+* @brief  Transmit phase: sends the staged commands and flags tasks that have not
+*         finished, their command goes out one period late
+* @param  None
+* @retval None
+*/
+static void control_tick_transmit(void)
+{
+    for (uint8_t i = 0; i < CONTROL_TICK_TASK_NUM; i++)
+    {
+        control_tick_slot_t *slot = &control_tick_slot[i];
+        if (slot->running && slot->release_tick == control_tick_count)
+        {
+            slot->stats.overruns++;
+            TRACE("control tick %u: task %u overran", control_tick_count, i);
+        }
+        if (slot->staged)
+        {
+            slot->staged = 0;
+            control_tick_tx(slot, &slot->frame);
+        }
+    }
+}
+
+
+static void control_tick_tx(control_tick_slot_t *slot, const hal_can_frame_t *frame)
+{
+    uint32_t now = hal_cycle_count();
+    uint32_t nominal = slot->divider * (HAL_CYCLE_HZ / CONTROL_TICK_HZ);
+
+    CAN_send(slot->can, frame);
+    if (slot->stats.commands_sent > 0)
+    {
+        uint32_t interval = now - slot->last_tx_time;
+        jitter_hist_add(slot->stats.tx_jitter_hist, &slot->stats.max_tx_jitter_cycles,
+                        interval > nominal ? interval - nominal : nominal - interval);
+    }
+    slot->last_tx_time = now;
+    slot->stats.commands_sent++;
+}
+
+
+static void jitter_hist_add(uint32_t hist[CONTROL_TICK_JITTER_BINS], uint32_t *max_cycles, uint32_t cycles)
+{
+    uint8_t bin = 0;
+
+    while (bin < CONTROL_TICK_JITTER_BINS - 1 && cycles >= jitter_edges_us[bin] * HAL_CYCLES_PER_US)
+    {
+        bin++;
+    }
+    hist[bin]++;
+    if (cycles > *max_cycles)
+    {
+        *max_cycles = cycles;
+    }
+}
@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+    * @file    APP/control_tick
+    * @date    16-October-2026
+    * @brief   Hardware timer driven control tick. TIM4 runs at CONTROL_TICK_HZ:
+    *          its update interrupt latches one feedback snapshot of every motor
+    *          and releases the control tasks, its CC1 interrupt transmits the
+    *          CAN commands they staged at CONTROL_TICK_TX_OFFSET_US into the
+    *          period. Commands therefore leave at a fixed phase from the tick
+    *          instead of wherever each task's vTaskDelay happened to expire.
+    * @attention Tasks call control_tick_register_task once and control_tick_wait
+    *          in place of vTaskDelay. With CONTROL_TICK_ENABLE 0 the wait falls
+    *          back to vTaskDelay and commands go out as soon as they are staged,
+    *          the jitter histograms keep recording for comparison.
+  ******************************************************************************
+**/
+
+#ifndef CONTROL_TICK_H
+#define CONTROL_TICK_H
+#include "main.h"
+#include "hal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+#define CONTROL_TICK_ENABLE 1
+
+#define CONTROL_TICK_HZ 1000
+#define CONTROL_TICK_PERIOD_US (1000000 / CONTROL_TICK_HZ)
+//Staged commands are sent this far into the period, tasks must be done by then
+#define CONTROL_TICK_TX_OFFSET_US 800
+
+//Tasks released by the tick, each stages at most one CAN command per run
+typedef enum
+{
+    CONTROL_TICK_GIMBAL = 0,
+    CONTROL_TICK_SHOOT,
+    CONTROL_TICK_CHASSIS,
+    CONTROL_TICK_TASK_NUM,
+} control_tick_task_e;
+
+//Jitter histogram bins, upper edges in microseconds; the last bin counts everything above
+#define CONTROL_TICK_JITTER_BINS 9
+#define CONTROL_TICK_JITTER_EDGES_US {1, 2, 5, 10, 20, 50, 100, 1000}
+
+//Per task counters, times in hal_cycle_count cycles
+typedef struct
+{
+    uint32_t releases;          //times the tick released the task
+    uint32_t overruns;          //releases where the task was still running at the transmit phase
+    uint32_t commands_sent;
+    //|interval between consecutive commands - nominal task period|
+    uint32_t tx_jitter_hist[CONTROL_TICK_JITTER_BINS];
+    uint32_t max_tx_jitter_cycles;
+    //delay from the tick to the task running
+    uint32_t wake_latency_hist[CONTROL_TICK_JITTER_BINS];
+    uint32_t max_wake_latency_cycles;
+} control_tick_task_stats_t;
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Clears the task table and starts the tick timer, call after CAN_receive_init
+extern void control_tick_init(void);
+//Binds a task handle to a slot, released every divider ticks
+extern void control_tick_register_task(control_tick_task_e task, TaskHandle_t handle, uint8_t divider);
+//Blocks until the next release of the task, replaces vTaskDelay in the task loop
+extern void control_tick_wait(control_tick_task_e task);
+//Stages the task's command for the next transmit phase, a later call in the same period replaces it
+extern void control_tick_send(control_tick_task_e task, hal_can_e can, const hal_can_frame_t *frame);
+//Ticks since control_tick_init
+extern uint32_t get_control_tick_count(void);
+//Copies the counters and histograms of a task
+extern void get_control_tick_task_stats(control_tick_task_e task, control_tick_task_stats_t *stats);
+
+#endif
@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+    * @file    APP/mecanum
+    * @date    16-October-2026
+    * @brief   Mecanum wheel kinematics, see mecanum.h.
+    * @attention Wheel i at (x, y) from the chassis centre, roller tangent t and
+    *          motor direction d turns at
+    *            rpm = d * k * (vx + t * vy + (t * x - y) * wz)
+    *          with k the motor rpm per mm/s of rim speed (Lynch & Park, 13.2).
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "mecanum.h"
+#include <stdlib.h>
+
+
+/******************** Private User Declarations ********************/
+
+#define MECANUM_Q_FRAC_BITS 16
+//Q15.16 of a constant expression, rounded to nearest
+#define MECANUM_Q(x) ((int32_t)((x) * (1 << MECANUM_Q_FRAC_BITS) + ((x) < 0 ? -0.5 : 0.5)))
+
+#define MECANUM_PI 3.14159265358979
+//Motor rpm per mm/s of rim speed
+#define MECANUM_K (60.0 * MECANUM_GEAR_RATIO / (2.0 * MECANUM_PI * MECANUM_WHEEL_RADIUS_MM))
+//tan of the roller angle as a [5/4] Pade approximant, a constant expression where
+//tan() is not; within 1e-7 up to 50 degrees
+#define MECANUM_RAD(deg) ((deg) * MECANUM_PI / 180.0)
+#define MECANUM_TAN_PADE(x) \
+    ((x) * (945.0 - 105.0 * (x) * (x) + (x) * (x) * (x) * (x)) / (945.0 - 420.0 * (x) * (x) + 15.0 * (x) * (x) * (x) * (x)))
+#define MECANUM_TAN MECANUM_TAN_PADE(MECANUM_RAD(MECANUM_ROLLER_ANGLE_DEG))
+#define MECANUM_HALF_TRACK (MECANUM_TRACK_MM / 2.0)
+#define MECANUM_HALF_BASE (MECANUM_WHEELBASE_MM / 2.0)
+//|t * x - y| of every wheel, in metres so wz in mrad/s gives mm/s
+#define MECANUM_LEVER_M ((MECANUM_HALF_BASE * MECANUM_TAN + MECANUM_HALF_TRACK) * 1e-3)
+
+//Mixing row: motor rpm per mm/s of vx, per mm/s of vy, per mrad/s of wz
+#define MECANUM_MIX_ROW(x, y, t, d)                                   \
+    {MECANUM_Q((d) * MECANUM_K),                                      \
+     MECANUM_Q((d) * (t) * MECANUM_TAN * MECANUM_K),                  \
+     MECANUM_Q((d) * ((t) * MECANUM_TAN * (x) - (y)) * 1e-3 * MECANUM_K)}
+
+//Inverse column: each mixing entry over the sum of squares of its column
+#define MECANUM_FORWARD_ROW(x, y, t, d)                                                                     \
+    {MECANUM_Q((d) / (MECANUM_WHEEL_NUM * MECANUM_K)),                                                      \
+     MECANUM_Q((d) * (t) / (MECANUM_WHEEL_NUM * MECANUM_TAN * MECANUM_K)),                                  \
+     MECANUM_Q((d) * ((t) * MECANUM_TAN * (x) - (y)) * 1e-3 /                                               \
+               (MECANUM_WHEEL_NUM * MECANUM_LEVER_M * MECANUM_LEVER_M * MECANUM_K))}
+
+//Per wheel: position, roller direction, and motor direction (the right side is mirrored)
+#define MECANUM_FRONT_RIGHT_WHEEL MECANUM_HALF_BASE, -MECANUM_HALF_TRACK, 1, -1
+#define MECANUM_FRONT_LEFT_WHEEL MECANUM_HALF_BASE, MECANUM_HALF_TRACK, -1, 1
+#define MECANUM_BACK_LEFT_WHEEL -MECANUM_HALF_BASE, MECANUM_HALF_TRACK, 1, 1
+#define MECANUM_BACK_RIGHT_WHEEL -MECANUM_HALF_BASE, -MECANUM_HALF_TRACK, -1, -1
+//Expands the wheel list before the row macro takes its four arguments
+#define MECANUM_ROW(row, wheel) row(wheel)
+
+//Body velocity to motor rpm, Q15.16
+static const int32_t mecanum_mix_q[MECANUM_WHEEL_NUM][3] = {
+    MECANUM_ROW(MECANUM_MIX_ROW, MECANUM_FRONT_RIGHT_WHEEL),
+    MECANUM_ROW(MECANUM_MIX_ROW, MECANUM_FRONT_LEFT_WHEEL),
+    MECANUM_ROW(MECANUM_MIX_ROW, MECANUM_BACK_LEFT_WHEEL),
+    MECANUM_ROW(MECANUM_MIX_ROW, MECANUM_BACK_RIGHT_WHEEL),
+};
+
+//Motor rpm to body velocity, stored per wheel, Q15.16
+static const int32_t mecanum_forward_q[MECANUM_WHEEL_NUM][3] = {
+    MECANUM_ROW(MECANUM_FORWARD_ROW, MECANUM_FRONT_RIGHT_WHEEL),
+    MECANUM_ROW(MECANUM_FORWARD_ROW, MECANUM_FRONT_LEFT_WHEEL),
+    MECANUM_ROW(MECANUM_FORWARD_ROW, MECANUM_BACK_LEFT_WHEEL),
+    MECANUM_ROW(MECANUM_FORWARD_ROW, MECANUM_BACK_RIGHT_WHEEL),
+};
+
+//Q15.16 accumulator to whole units, rounded half away from zero
+static int32_t mecanum_round(int64_t acc);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+/**
+* @brief  Inverse kinematics, body velocity to the speed of every motor
+* @param  body: velocity in the body frame
+* @param  wheel_rpm: filled with motor rpm, chassis CAN order
+* @retval None
+*/
+void mecanum_mix(const mecanum_body_t *body, int32_t wheel_rpm[MECANUM_WHEEL_NUM])
+{
+    for (uint8_t i = 0; i < MECANUM_WHEEL_NUM; i++)
+    {
+        int64_t acc = (int64_t)mecanum_mix_q[i][0] * body->vx + (int64_t)mecanum_mix_q[i][1] * body->vy +
+                      (int64_t)mecanum_mix_q[i][2] * body->wz;
+        wheel_rpm[i] = mecanum_round(acc);
+    }
+}
+
+
+/**
+* @brief  Proportional desaturation: when a wheel asks for more than max_rpm, all
+*         four are scaled by the same factor, which keeps the direction of travel
+*         and the ratio of translation to rotation and only slows the robot down
+* @param  wheel_rpm: motor rpm, scaled in place
+* @param  max_rpm: largest allowed magnitude, > 0
+* @retval 1 if the wheels were scaled
+*/
+uint8_t mecanum_desaturate(int32_t wheel_rpm[MECANUM_WHEEL_NUM], int32_t max_rpm)
+{
+    int32_t peak = 0;
+
+    for (uint8_t i = 0; i < MECANUM_WHEEL_NUM; i++)
+    {
+        int32_t magnitude = abs(wheel_rpm[i]);
+        peak = magnitude > peak ? magnitude : peak;
+    }
+    if (peak <= max_rpm)
+    {
+        return 0;
+    }
+    for (uint8_t i = 0; i < MECANUM_WHEEL_NUM; i++)
+    {
+        wheel_rpm[i] = (int32_t)((int64_t)wheel_rpm[i] * max_rpm / peak);
+    }
+    return 1;
+}
+
+
+/**
+* @brief  Forward kinematics, the least squares body velocity that explains the
+*         measured motor speeds. Wheel slip shows up as a residual it averages out
+* @param  wheel_rpm: measured motor rpm, chassis CAN order
+* @param  body: filled with the velocity in the body frame
+* @retval None
+*/
+void mecanum_forward(const int32_t wheel_rpm[MECANUM_WHEEL_NUM], mecanum_body_t *body)
+{
+    int64_t acc[3] = {0, 0, 0};
+
+    for (uint8_t i = 0; i < MECANUM_WHEEL_NUM; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            acc[j] += (int64_t)mecanum_forward_q[i][j] * wheel_rpm[i];
+        }
+    }
+    body->vx = mecanum_round(acc[0]);
+    body->vy = mecanum_round(acc[1]);
+    body->wz = mecanum_round(acc[2]);
+}
+
+
+
+/******************** Private Functions ********************/
+
+static int32_t mecanum_round(int64_t acc)
+{
+    const int64_t half = 1 << (MECANUM_Q_FRAC_BITS - 1);
+    return (int32_t)((acc + (acc < 0 ? -half : half)) / (1 << MECANUM_Q_FRAC_BITS));
+}
@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+    * @file    APP/mecanum
+    * @date    16-October-2026
+    * @brief   Mecanum wheel kinematics. The mixing matrix (body velocity to motor
+    *          rpm) and its inverse (motor rpm to body velocity) are built by the
+    *          compiler from the wheel geometry below, as Q15.16 constants, so
+    *          neither direction touches the FPU at run time.
+    *          Body frame: x forward, y left, z counter clockwise seen from above.
+    * @attention The inverse assumes a rectangular layout with mirrored rollers
+    *          (the X pattern seen from above), which makes the normal matrix
+    *          diagonal. Change the geometry here, not in the tables.
+  ******************************************************************************
+**/
+
+#ifndef MECANUM_H
+#define MECANUM_H
+#include "main.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+//Wheels in chassis CAN order: front right, front left, back left, back right
+#define MECANUM_WHEEL_NUM 4
+
+//Geometry, wheel contact point to contact point
+#define MECANUM_TRACK_MM 400.0          //left to right
+#define MECANUM_WHEELBASE_MM 400.0      //front to back
+#define MECANUM_WHEEL_RADIUS_MM 76.0
+//Angle between the rollers and the wheel axle
+#define MECANUM_ROLLER_ANGLE_DEG 45.0
+//M3508 gearbox, 3591:187
+#define MECANUM_GEAR_RATIO (3591.0 / 187.0)
+
+//Body velocity, whole units so the chassis stays in integer arithmetic
+typedef struct
+{
+    int32_t vx;     //mm/s forward
+    int32_t vy;     //mm/s to the left
+    int32_t wz;     //mrad/s counter clockwise
+} mecanum_body_t;
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Motor rpm of each wheel for a body velocity
+extern void mecanum_mix(const mecanum_body_t *body, int32_t wheel_rpm[MECANUM_WHEEL_NUM]);
+//Scales all wheels by one factor so none is over max_rpm, returns 1 if it had to
+extern uint8_t mecanum_desaturate(int32_t wheel_rpm[MECANUM_WHEEL_NUM], int32_t max_rpm);
+//Least squares body velocity from measured motor rpm
+extern void mecanum_forward(const int32_t wheel_rpm[MECANUM_WHEEL_NUM], mecanum_body_t *body);
+
+#endif
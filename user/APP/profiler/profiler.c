@@ -0,0 +1,186 @@
+/**
+  ******************************************************************************
+    * @file    APP/profiler
+    * @date    16-October-2026
+    * @brief   Loop profiler, see profiler.h.
+    * @attention A loop's stats are only written by its own task. Readers in other
+    *          contexts take them without locking and may be one iteration off.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "profiler.h"
+#include "telemetry.h"
+#include "hal.h"
+
+#include <string.h>
+
+
+/******************** Private User Declarations ********************/
+
+//Watch profiler_loop in the debugger for the raw histograms
+static profiler_loop_t profiler_loop[PROFILER_LOOP_NUM];
+
+//Adds one sample to a histogram
+static void profiler_hist_add(profiler_hist_t *hist, uint32_t cycles);
+//Bin of a duration
+static uint8_t profiler_bin(uint32_t cycles);
+//Summary with p99 taken as the upper edge of the bin holding the 99th percentile
+static void profiler_summarise(const profiler_hist_t *hist, profiler_summary_t *summary);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+/**
+* @brief  Marks the start of an iteration and records the period since the last one
+* @param  loop: loop being timed
+* @retval None
+*/
+void profiler_loop_start(profiler_loop_e loop)
+{
+#if PROFILER_ENABLE
+    profiler_loop_t *profile = &profiler_loop[loop];
+    uint32_t now = hal_cycle_count();
+
+    if (profile->start_cycles != 0)
+    {
+        profiler_hist_add(&profile->period, now - profile->start_cycles);
+    }
+    //0 means no start yet
+    profile->start_cycles = now ? now : 1;
+#endif
+}
+
+
+/**
+* @brief  Marks the end of an iteration, records its execution time and sends the
+*         loop's summary when the telemetry rate allows
+* @param  loop: loop being timed
+* @retval None
+*/
+void profiler_loop_end(profiler_loop_e loop)
+{
+#if PROFILER_ENABLE
+    profiler_loop_t *profile = &profiler_loop[loop];
+
+    profiler_hist_add(&profile->exec, hal_cycle_count() - profile->start_cycles);
+    telemetry_profile(loop);
+#endif
+}
+
+
+//Clears the stats of every loop
+void profiler_reset(void)
+{
+    uint32_t irq_state = hal_irq_disable();
+    memset(profiler_loop, 0, sizeof(profiler_loop));
+    hal_irq_restore(irq_state);
+}
+
+
+/**
+* @brief  Summaries of a loop's execution time and period, in cycles
+* @param  loop: loop to read
+* @param  exec, period: filled in, either may be NULL
+* @retval None
+*/
+void get_profiler_summary(profiler_loop_e loop, profiler_summary_t *exec, profiler_summary_t *period)
+{
+    if (exec != NULL)
+    {
+        profiler_summarise(&profiler_loop[loop].exec, exec);
+    }
+    if (period != NULL)
+    {
+        profiler_summarise(&profiler_loop[loop].period, period);
+    }
+}
+
+
+/**
+* @brief  Upper edge of a histogram bin. Bins below PROFILER_SUB_BINS hold exact
+*         counts, the others 1/PROFILER_SUB_BINS of an octave
+* @param  bin: 0 ~ PROFILER_HIST_BINS - 1
+* @retval first cycle count past the bin, saturated at 0xFFFFFFFF
+*/
+uint32_t profiler_bin_upper_edge(uint8_t bin)
+{
+    uint8_t octave = bin / PROFILER_SUB_BINS;
+    uint8_t sub = bin % PROFILER_SUB_BINS;
+
+    if (octave < PROFILER_SUB_BIN_BITS)
+    {
+        return bin < PROFILER_SUB_BINS ? bin + 1 : PROFILER_SUB_BINS;
+    }
+    uint64_t edge = (uint64_t)(PROFILER_SUB_BINS + sub + 1) << (octave - PROFILER_SUB_BIN_BITS);
+    return edge > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)edge;
+}
+
+
+
+/******************** Private Functions ********************/
+
+static void profiler_hist_add(profiler_hist_t *hist, uint32_t cycles)
+{
+    if (hist->count == 0 || cycles < hist->min_cycles)
+    {
+        hist->min_cycles = cycles;
+    }
+    if (cycles > hist->max_cycles)
+    {
+        hist->max_cycles = cycles;
+    }
+    hist->count++;
+    hist->total_cycles += cycles;
+    hist->hist[profiler_bin(cycles)]++;
+}
+
+static uint8_t profiler_bin(uint32_t cycles)
+{
+    uint8_t octave = 0;
+
+    if (cycles < PROFILER_SUB_BINS)
+    {
+        return cycles;
+    }
+    //floor(log2(cycles)) by binary search
+    for (uint8_t shift = 16; shift > 0; shift >>= 1)
+    {
+        if (cycles >> (octave + shift))
+        {
+            octave += shift;
+        }
+    }
+    //The bits below the leading one pick the sub bin
+    return octave * PROFILER_SUB_BINS + ((cycles >> (octave - PROFILER_SUB_BIN_BITS)) & (PROFILER_SUB_BINS - 1));
+}
+
+static void profiler_summarise(const profiler_hist_t *hist, profiler_summary_t *summary)
+{
+    uint32_t count = hist->count;
+    uint32_t target = count - count / 100;
+    uint32_t seen = 0;
+
+    summary->count = count;
+    summary->min = hist->min_cycles;
+    summary->max = hist->max_cycles;
+    summary->avg = count ? (uint32_t)(hist->total_cycles / count) : 0;
+    summary->p99 = 0;
+    if (count == 0)
+    {
+        return;
+    }
+    for (uint16_t bin = 0; bin < PROFILER_HIST_BINS; bin++)
+    {
+        seen += hist->hist[bin];
+        if (seen >= target)
+        {
+            uint32_t edge = profiler_bin_upper_edge(bin);
+            //The bin edge can overstate it, the maximum cannot
+            summary->p99 = edge < summary->max ? edge : summary->max;
+            break;
+        }
+    }
+}
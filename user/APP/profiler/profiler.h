@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+    * @file    APP/profiler
+    * @date    16-October-2026
+    * @brief   Cycle accurate loop profiler. Each task brackets its loop body with
+    *          profiler_loop_start/profiler_loop_end; the DWT cycle counter gives
+    *          the execution time of every iteration and the period between two
+    *          starts. Both go into min/max/sum counters and a log scale histogram
+    *          with PROFILER_SUB_BINS bins per octave, p99 is read back from it.
+    * @attention Times are wall clock from start to end, preemption by interrupts
+    *          and higher priority tasks included, which is what decides whether a
+    *          loop still fits its period. The stats are in profiler_loop[] for the
+    *          debugger and are sent as TELEMETRY_MSG_PROFILE once per second per loop.
+  ******************************************************************************
+**/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+#include "main.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+//0 turns profiler_loop_start/end into empty calls
+#define PROFILER_ENABLE 1
+
+typedef enum
+{
+    PROFILER_LOOP_INS = 0,
+    PROFILER_LOOP_GIMBAL,
+    PROFILER_LOOP_CHASSIS,
+    PROFILER_LOOP_SHOOT,
+    PROFILER_LOOP_NUM,
+} profiler_loop_e;
+
+//Histogram: bin = PROFILER_SUB_BINS * floor(log2(cycles)) + the bits below the leading one,
+//32 octaves. Durations under PROFILER_SUB_BINS cycles get one bin each
+#define PROFILER_SUB_BIN_BITS 3
+#define PROFILER_SUB_BINS (1 << PROFILER_SUB_BIN_BITS)
+#define PROFILER_HIST_BINS (32 * PROFILER_SUB_BINS)
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t hist[PROFILER_HIST_BINS];
+} profiler_hist_t;
+
+typedef struct
+{
+    profiler_hist_t exec;       //start to end of one iteration
+    profiler_hist_t period;     //start to start of consecutive iterations
+    //Private: cycle count of the running iteration's start, 0 before the first
+    uint32_t start_cycles;
+} profiler_loop_t;
+
+//Summary of one histogram, in cycles
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+} profiler_summary_t;
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Marks the start of an iteration, call right after the task wakes up
+extern void profiler_loop_start(profiler_loop_e loop);
+//Marks the end of an iteration, call before the task blocks again
+extern void profiler_loop_end(profiler_loop_e loop);
+//Clears the stats of every loop
+extern void profiler_reset(void);
+//Copies the execution time and period summaries of a loop
+extern void get_profiler_summary(profiler_loop_e loop, profiler_summary_t *exec, profiler_summary_t *period);
+//Upper edge in cycles of a histogram bin
+extern uint32_t profiler_bin_upper_edge(uint8_t bin);
+
+#endif
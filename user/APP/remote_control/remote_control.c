@@ -17,14 +17,12 @@
   ****************************(C) COPYRIGHT 2016 DJI****************************
   */
 
-#include "Remote_Control.h"
-
-#include "stm32f4xx.h"
+#include "remote_control.h"
 
+#include "hal.h"
 #include "rc.h"
 
-#include "USART_comms.h"
-#include <stdio.h>
+#include "telemetry.h"
 
 // #include "Detect_Task.h" 		// see todo l.134
 //ң
@@ -112,52 +110,18 @@ void slove_data_error(void)
 // buffer, and then struct when all data is received.
 void USART1_IRQHandler(void)
 {
-    if (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET)
-    {
-        USART_ReceiveData(USART1);
-    }
-    else if (USART_GetITStatus(USART1, USART_IT_IDLE) != RESET)
-    {
-        static uint16_t this_time_rx_len = 0;
-        USART_ReceiveData(USART1);
+    uint8_t this_time_rx_buf;
+    uint16_t this_time_rx_len;
 
-        if(DMA_GetCurrentMemoryTarget(DMA2_Stream2) == 0)
-        {
-            //DMA
-            DMA_Cmd(DMA2_Stream2, DISABLE);
-            this_time_rx_len = SBUS_RX_BUF_NUM - DMA_GetCurrDataCounter(DMA2_Stream2);
-            DMA_SetCurrDataCounter(DMA2_Stream2, SBUS_RX_BUF_NUM);
-            DMA2_Stream2->CR |= DMA_SxCR_CT;
-            //DMAжϱ־
-            DMA_ClearFlag(DMA2_Stream2, DMA_FLAG_TCIF2 | DMA_FLAG_HTIF2);
-            DMA_Cmd(DMA2_Stream2, ENABLE);
-            if(this_time_rx_len == RC_FRAME_LENGTH)
-            {
-                //ң
-                SBUS_TO_RC(SBUS_rx_buf[0], &rc_ctrl);
-                //¼ݽʱ
-							  //TODO - need to implement this
-                // DetectHook(DBUSTOE);
-            }
-        }
-        else
+    if (hal_uart_dma_rx_idle(HAL_USART1, SBUS_RX_BUF_NUM, &this_time_rx_buf, &this_time_rx_len))
+    {
+        if(this_time_rx_len == RC_FRAME_LENGTH)
         {
-            //DMA
-            DMA_Cmd(DMA2_Stream2, DISABLE);
-            this_time_rx_len = SBUS_RX_BUF_NUM - DMA_GetCurrDataCounter(DMA2_Stream2);
-            DMA_SetCurrDataCounter(DMA2_Stream2, SBUS_RX_BUF_NUM);
-            DMA2_Stream2->CR &= ~(DMA_SxCR_CT);
-            //DMAжϱ־
-            DMA_ClearFlag(DMA2_Stream2, DMA_FLAG_TCIF2 | DMA_FLAG_HTIF2);
-            DMA_Cmd(DMA2_Stream2, ENABLE);
-            if(this_time_rx_len == RC_FRAME_LENGTH)
-            {
-                //ң
-                SBUS_TO_RC(SBUS_rx_buf[1], &rc_ctrl);
-                //¼ݽʱ
-                // DetectHook(DBUSTOE);
-            }
-
+            //ң
+            SBUS_TO_RC(SBUS_rx_buf[this_time_rx_buf], &rc_ctrl);
+            //¼ݽʱ
+            //TODO - need to implement this
+            // DetectHook(DBUSTOE);
         }
     }
 }
@@ -205,34 +169,7 @@ static void SBUS_TO_RC(volatile const uint8_t *sbus_buf, RC_ctrl_t *rc_ctrl)
     rc_ctrl->rc.ch[4] -= RC_CH_VALUE_OFFSET;
 }
 
+//Sends the remote control state as a telemetry frame
 void test_rc(RC_ctrl_t *rc_ctrl) {
-    volatile char str[32];
-    
-    // channels 0 - 4
-    for (int c = 0; c < 5; ++c) {
-        sprintf((char*) str, "channel %d: %i\n\r", c, rc_ctrl->rc.ch[c]);
-        serial_send_string(str);
-    }
-    
-    // switches 1, 2
-    for (int s = 0; s < 2; ++s) {
-        sprintf((char*) str, "switch %d: %i\n\r", s, rc_ctrl->rc.s[s]);
-        serial_send_string(str);
-    }
-    
-    // mouse
-    sprintf((char*) str, "mouse x: %d\n\r", rc_ctrl->mouse.x);
-    serial_send_string(str);
-
-    sprintf((char*) str, "mouse y: %d\n\r", rc_ctrl->mouse.y);
-    serial_send_string(str);
-    
-    sprintf((char*) str, "mouse z: %d\n\r", rc_ctrl->mouse.z);
-    serial_send_string(str);
-
-    sprintf((char*) str, "mouse l: %u\n\r", rc_ctrl->mouse.press_l);
-    serial_send_string(str);
-    
-    sprintf((char*) str, "mouse r: %u\n\r", rc_ctrl->mouse.press_r);
-    serial_send_string(str);
+    telemetry_rc(rc_ctrl);
 }
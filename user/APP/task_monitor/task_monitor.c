@@ -0,0 +1,177 @@
+/**
+  ******************************************************************************
+    * @file    APP/task_monitor
+    * @date    16-October-2026
+    * @brief   Per task CPU load and stack headroom, see task_monitor.h.
+    * @attention Runs in the timer service task. Each task keeps its slot for as
+    *          long as it exists, so slot numbers in the telemetry stay stable.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "task_monitor.h"
+#include "telemetry.h"
+#include "hal.h"
+
+#include "FreeRTOSConfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include <string.h>
+
+
+/******************** Private User Declarations ********************/
+
+static TimerHandle_t task_monitor_timer;
+//Kernel snapshot, static so the timer task stack does not have to hold it
+static TaskStatus_t task_status[TASK_MONITOR_MAX_TASKS];
+//Latest sample per slot, number 0 marks a free slot (xTaskNumber starts at 1)
+static task_monitor_entry_t task_monitor_entry[TASK_MONITOR_MAX_TASKS];
+static uint32_t task_monitor_last_total;
+static uint16_t cpu_load_permille;
+
+//Timer callback, samples every task and sends the telemetry
+static void task_monitor_sample(TimerHandle_t timer);
+//Slot of a task number, a free slot if it is new, TASK_MONITOR_MAX_TASKS if full
+static uint8_t task_monitor_slot(const task_monitor_entry_t *entries, uint8_t number);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Creates and starts the sampling timer, call once from start_task
+void task_monitor_init(void)
+{
+    task_monitor_timer = xTimerCreate("task_monitor", pdMS_TO_TICKS(TASK_MONITOR_PERIOD_MS), pdTRUE,
+                                      NULL, task_monitor_sample);
+    if (task_monitor_timer != NULL)
+    {
+        xTimerStart(task_monitor_timer, 0);
+    }
+}
+
+
+/**
+* @brief  Copies the latest sample
+* @param  entries: filled with the tracked tasks, free slots skipped
+* @param  max_entries: size of entries
+* @retval number of entries written
+*/
+uint8_t get_task_monitor(task_monitor_entry_t *entries, uint8_t max_entries)
+{
+    uint8_t count = 0;
+    uint32_t irq_state = hal_irq_disable();
+
+    for (uint8_t slot = 0; slot < TASK_MONITOR_MAX_TASKS && count < max_entries; slot++)
+    {
+        if (task_monitor_entry[slot].number != 0)
+        {
+            entries[count++] = task_monitor_entry[slot];
+        }
+    }
+    hal_irq_restore(irq_state);
+    return count;
+}
+
+
+//Load of everything but the idle task over the last period, in permille
+uint16_t get_cpu_load_permille(void)
+{
+    return cpu_load_permille;
+}
+
+
+
+/******************** Private Functions ********************/
+
+static void task_monitor_sample(TimerHandle_t timer)
+{
+    task_monitor_entry_t entries[TASK_MONITOR_MAX_TASKS];
+    uint32_t total_run_time;
+    uint16_t idle_permille = 0;
+
+    (void)timer;
+    //Returns 0 when there are more tasks than slots
+    UBaseType_t task_num = uxTaskGetSystemState(task_status, TASK_MONITOR_MAX_TASKS, &total_run_time);
+    if (task_num == 0)
+    {
+        return;
+    }
+    //Unsigned differences stay right across one counter wrap, TIM2 wraps every 71 minutes
+    uint32_t window = total_run_time - task_monitor_last_total;
+    task_monitor_last_total = total_run_time;
+
+    memset(entries, 0, sizeof(entries));
+    //Tasks from the last sample keep their slot, new ones take the free slots after that
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        for (UBaseType_t i = 0; i < task_num; i++)
+        {
+            const TaskStatus_t *status = &task_status[i];
+            uint8_t number = (uint8_t)status->xTaskNumber;
+            uint8_t slot = task_monitor_slot(task_monitor_entry, number);
+            uint8_t known = slot < TASK_MONITOR_MAX_TASKS && task_monitor_entry[slot].number == number;
+
+            if (known != (pass == 0))
+            {
+                continue;
+            }
+            if (!known)
+            {
+                slot = task_monitor_slot(entries, number);
+                if (slot == TASK_MONITOR_MAX_TASKS)
+                {
+                    continue;
+                }
+            }
+            task_monitor_entry_t *entry = &entries[slot];
+            //A new task ran for its whole run time inside the window
+            uint32_t previous = known ? task_monitor_entry[slot].run_time : 0;
+
+            entry->number = number;
+            strncpy(entry->name, status->pcTaskName, TASK_MONITOR_NAME_LEN);
+            entry->priority = (uint8_t)status->uxCurrentPriority;
+            entry->stack_free_words = status->usStackHighWaterMark;
+            entry->run_time = status->ulRunTimeCounter;
+            entry->cpu_permille = window ? (uint16_t)((uint64_t)(entry->run_time - previous) * 1000 / window) : 0;
+            //Name given by vTaskStartScheduler
+            if (strcmp(status->pcTaskName, "IDLE") == 0)
+            {
+                idle_permille = entry->cpu_permille;
+            }
+        }
+    }
+
+    uint32_t irq_state = hal_irq_disable();
+    memcpy(task_monitor_entry, entries, sizeof(entries));
+    cpu_load_permille = idle_permille < 1000 ? 1000 - idle_permille : 0;
+    hal_irq_restore(irq_state);
+
+    for (uint8_t slot = 0; slot < TASK_MONITOR_MAX_TASKS; slot++)
+    {
+        if (entries[slot].number != 0)
+        {
+            telemetry_task(slot, &entries[slot]);
+        }
+    }
+}
+
+static uint8_t task_monitor_slot(const task_monitor_entry_t *entries, uint8_t number)
+{
+    uint8_t free_slot = TASK_MONITOR_MAX_TASKS;
+
+    for (uint8_t slot = 0; slot < TASK_MONITOR_MAX_TASKS; slot++)
+    {
+        if (entries[slot].number == number)
+        {
+            return slot;
+        }
+        if (entries[slot].number == 0 && free_slot == TASK_MONITOR_MAX_TASKS)
+        {
+            free_slot = slot;
+        }
+    }
+    return free_slot;
+}
@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+    * @file    APP/task_monitor
+    * @date    16-October-2026
+    * @brief   Per task CPU load and stack headroom. A FreeRTOS software timer
+    *          samples uxTaskGetSystemState every TASK_MONITOR_PERIOD_MS, turns
+    *          the run time counters (TIM2 at 1 MHz, see FreeRTOS_middleware.c)
+    *          into the load over that window and sends one TELEMETRY_MSG_TASK
+    *          per task.
+    * @attention uxTaskGetSystemState suspends the scheduler while it walks the
+    *          task lists, a few tens of microseconds once per period. Interrupts
+    *          stay on, the TIM4 control tick is not delayed. The idle task's
+    *          load is the CPU headroom.
+  ******************************************************************************
+**/
+
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+#include "main.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+#define TASK_MONITOR_PERIOD_MS 1000
+//Tasks tracked, the rest are ignored: 5 application tasks, idle and the timer task
+#define TASK_MONITOR_MAX_TASKS 8
+//Characters of the task name kept, also the width of the telemetry field
+#define TASK_MONITOR_NAME_LEN 8
+
+typedef struct
+{
+    uint8_t number;             //xTaskNumber, unique per task created
+    char name[TASK_MONITOR_NAME_LEN];  //truncated, not terminated when it fills the field
+    uint8_t priority;
+    uint16_t cpu_permille;      //share of the last period
+    uint16_t stack_free_words;  //stack high water mark, lowest free stack ever seen
+    uint32_t run_time;          //total run time in run time stats ticks, wraps
+} task_monitor_entry_t;
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Creates and starts the sampling timer, call once from start_task
+extern void task_monitor_init(void);
+//Copies the latest sample, returns the number of entries written
+extern uint8_t get_task_monitor(task_monitor_entry_t *entries, uint8_t max_entries);
+//Load of everything but the idle task over the last period, in permille
+extern uint16_t get_cpu_load_permille(void);
+
+#endif
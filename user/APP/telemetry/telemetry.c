@@ -0,0 +1,429 @@
+/**
+  ******************************************************************************
+    * @file    APP/telemetry
+    * @date    16-October-2026
+    * @brief   Binary telemetry frames on the USART6 log channel, see telemetry.h.
+    * @attention Senders may run in any task. Sequence number, encoding and the ring
+    *          write happen under one short interrupt mask so frames leave in seq order.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "USART_comms.h"
+#include "hal.h"
+
+#include "FreeRTOSConfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <string.h>
+
+
+/******************** Private User Declarations ********************/
+
+#define TELEMETRY_RAW_MAX (TELEMETRY_HEADER_LEN + TELEMETRY_BODY_MAX + TELEMETRY_CRC_LEN)
+
+static uint16_t telemetry_rate_hz[TELEMETRY_MSG_NUM] = {
+    [TELEMETRY_MSG_MOTOR] = TELEMETRY_RATE_MOTOR,
+    [TELEMETRY_MSG_PID] = TELEMETRY_RATE_PID,
+    [TELEMETRY_MSG_IMU] = TELEMETRY_RATE_IMU,
+    [TELEMETRY_MSG_RC] = TELEMETRY_RATE_RC,
+    [TELEMETRY_MSG_LIMITER] = TELEMETRY_RATE_LIMITER,
+    [TELEMETRY_MSG_GIMBAL] = TELEMETRY_RATE_GIMBAL,
+    [TELEMETRY_MSG_PROFILE] = TELEMETRY_RATE_PROFILE,
+    [TELEMETRY_MSG_TASK] = TELEMETRY_RATE_TASK,
+};
+//Tick of the last frame per message type and instance, bit set in telemetry_started once sent
+static TickType_t telemetry_last_tick[TELEMETRY_MSG_NUM][TELEMETRY_INSTANCE_NUM];
+static uint32_t telemetry_started[TELEMETRY_MSG_NUM];
+#if TELEMETRY_INSTANCE_NUM > 32
+#error "telemetry_started holds one bit per instance"
+#endif
+static uint8_t telemetry_seq;
+static telemetry_stats_t telemetry_stats;
+
+//Returns 1 if the instance of a message type is due, and marks it sent
+static uint8_t telemetry_due(telemetry_msg_e msg, uint8_t instance);
+//Builds and sends a TELEMETRY_MSG_PID body
+static void telemetry_pid_send(telemetry_pid_loop_e loop, fp32 set, fp32 fdb, fp32 Pout, fp32 Iout, fp32 Dout,
+                               fp32 out);
+//Little endian field writers, return the next write position
+static uint8_t *put_u8(uint8_t *p, uint8_t value);
+static uint8_t *put_u16(uint8_t *p, uint16_t value);
+static uint8_t *put_u32(uint8_t *p, uint32_t value);
+static uint8_t *put_f32(uint8_t *p, fp32 value);
+static uint8_t *put_q(uint8_t *p, int32_t value, uint8_t frac_bits);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Rate of a message type in Hz, 0 turns it off
+void telemetry_set_rate(telemetry_msg_e msg, uint16_t rate_hz)
+{
+    telemetry_rate_hz[msg] = rate_hz;
+    telemetry_started[msg] = 0;
+}
+
+
+/**
+* @brief  Frames a body and queues it on the log channel, never blocks
+* @param  msg: schema ID
+* @param  body, len: message body, at most TELEMETRY_BODY_MAX bytes
+* @retval 1 if queued, 0 if the body is too long or the log ring is full
+*/
+uint8_t telemetry_send(telemetry_msg_e msg, const uint8_t *body, uint8_t len)
+{
+    uint8_t raw[TELEMETRY_RAW_MAX];
+    uint8_t frame[TELEMETRY_COBS_MAX_LEN(TELEMETRY_RAW_MAX) + 1];
+    uint8_t *p = raw;
+
+    if (len > TELEMETRY_BODY_MAX)
+    {
+        return 0;
+    }
+
+    uint32_t irq_state = hal_irq_disable();
+    p = put_u8(p, msg);
+    p = put_u8(p, telemetry_seq);
+    p = put_u32(p, hal_cycle_count());
+    memcpy(p, body, len);
+    p += len;
+    p = put_u16(p, telemetry_crc16(TELEMETRY_CRC_INIT, raw, p - raw));
+
+    uint16_t frame_len = telemetry_cobs_encode(raw, p - raw, frame);
+    frame[frame_len++] = TELEMETRY_FRAME_DELIMITER;
+
+    uint8_t queued = serial_write(frame, frame_len);
+    if (queued)
+    {
+        //A dropped frame keeps its seq free, so the decoder counts it as lost
+        telemetry_stats.sent++;
+    }
+    else
+    {
+        telemetry_stats.dropped++;
+    }
+    telemetry_seq++;
+    hal_irq_restore(irq_state);
+    return queued;
+}
+
+
+//Motor feedback, id is one of CAN_3508_M1_ID ~ CAN_HOPPER_MOTOR_ID
+void telemetry_motor(can_msg_id_e id, const motor_feedback_t *feedback)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_MOTOR];
+    uint8_t *p = body;
+    uint8_t motor = id - CAN_3508_M1_ID;
+    motor_feedback_t snapshot;
+
+    if (motor >= CAN_MOTOR_NUM || !telemetry_due(TELEMETRY_MSG_MOTOR, motor))
+    {
+        return;
+    }
+    get_motor_feedback_snapshot(feedback, &snapshot);
+    p = put_u8(p, motor);
+    p = put_u16(p, snapshot.ecd);
+    p = put_u16(p, snapshot.speed_rpm);
+    p = put_u16(p, snapshot.current_read);
+    p = put_u8(p, snapshot.temperate);
+    telemetry_send(TELEMETRY_MSG_MOTOR, body, p - body);
+}
+
+
+//Setpoint, feedback and the terms of the last PID_Calc of a loop
+void telemetry_pid(telemetry_pid_loop_e loop, const PidTypeDef *pid)
+{
+    if (!telemetry_due(TELEMETRY_MSG_PID, loop))
+    {
+        return;
+    }
+    telemetry_pid_send(loop, pid->set, pid->fdb, pid->Pout, pid->Iout, pid->Dout, pid->out);
+}
+
+
+//PidFullTypeDef loop, same message as telemetry_pid. Dout carries the feed-forward too
+void telemetry_pid_full(telemetry_pid_loop_e loop, const PidFullTypeDef *pid)
+{
+    if (!telemetry_due(TELEMETRY_MSG_PID, loop))
+    {
+        return;
+    }
+    telemetry_pid_send(loop, pid->set, pid->fdb, pid->Pout, pid->Iout, pid->Dout + pid->Fout, pid->out);
+}
+
+
+//One controller of a PID bank, same message as telemetry_pid
+void telemetry_pid_bank(telemetry_pid_loop_e loop, const PidBankTypeDef *bank, uint8_t index)
+{
+    if (!telemetry_due(TELEMETRY_MSG_PID, loop))
+    {
+        return;
+    }
+    telemetry_pid_send(loop, bank->set[index], bank->fdb[index], bank->Pout[index], bank->Iout[index],
+                       bank->Dout[index], bank->out[index]);
+}
+
+
+//One controller of a fixed point PID bank, same message as telemetry_pid. The
+//floats are built with integer operations so the caller's task stays off the FPU
+void telemetry_pid_bank_q(telemetry_pid_loop_e loop, const PidBankQTypeDef *bank, uint8_t index)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_PID];
+    uint8_t *p = body;
+
+    if (!telemetry_due(TELEMETRY_MSG_PID, loop))
+    {
+        return;
+    }
+    p = put_u8(p, loop);
+    p = put_q(p, bank->set[index], 0);
+    p = put_q(p, bank->fdb[index], 0);
+    p = put_q(p, bank->Pout[index], PID_Q_FRAC_BITS);
+    p = put_q(p, bank->Iout[index], PID_Q_FRAC_BITS);
+    p = put_q(p, bank->Dout[index], PID_Q_FRAC_BITS);
+    p = put_q(p, bank->out[index], PID_Q_FRAC_BITS);
+    telemetry_send(TELEMETRY_MSG_PID, body, p - body);
+}
+
+
+//INS angles, gyro and accelerometer
+void telemetry_imu(const fp32 angle[3], const fp32 gyro[3], const fp32 accel[3])
+{
+    uint8_t body[TELEMETRY_BODY_LEN_IMU];
+    uint8_t *p = body;
+
+    if (!telemetry_due(TELEMETRY_MSG_IMU, 0))
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        p = put_f32(p, angle[i]);
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        p = put_f32(p, gyro[i]);
+    }
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        p = put_f32(p, accel[i]);
+    }
+    telemetry_send(TELEMETRY_MSG_IMU, body, p - body);
+}
+
+
+//Remote control sticks, switches, mouse and keys
+void telemetry_rc(const RC_ctrl_t *rc)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_RC];
+    uint8_t *p = body;
+
+    if (!telemetry_due(TELEMETRY_MSG_RC, 0))
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        p = put_u16(p, rc->rc.ch[i]);
+    }
+    p = put_u8(p, rc->rc.s[0]);
+    p = put_u8(p, rc->rc.s[1]);
+    p = put_u16(p, rc->mouse.x);
+    p = put_u16(p, rc->mouse.y);
+    p = put_u16(p, rc->mouse.z);
+    p = put_u8(p, rc->mouse.press_l);
+    p = put_u8(p, rc->mouse.press_r);
+    p = put_u16(p, rc->key.v);
+    telemetry_send(TELEMETRY_MSG_RC, body, p - body);
+}
+
+
+//Chassis current limiter event
+void telemetry_limiter(uint8_t motor, uint8_t limiter, int16_t current)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_LIMITER];
+    uint8_t *p = body;
+
+    if (!telemetry_due(TELEMETRY_MSG_LIMITER, motor))
+    {
+        return;
+    }
+    p = put_u8(p, motor);
+    p = put_u8(p, limiter);
+    p = put_u16(p, current);
+    telemetry_send(TELEMETRY_MSG_LIMITER, body, p - body);
+}
+
+
+//Gimbal yaw unit vectors and pitch encoder position
+void telemetry_gimbal(const fp32 yaw_position[2], const fp32 yaw_setpoint[2], uint16_t pitch_pos)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_GIMBAL];
+    uint8_t *p = body;
+
+    if (!telemetry_due(TELEMETRY_MSG_GIMBAL, 0))
+    {
+        return;
+    }
+    p = put_f32(p, yaw_position[0]);
+    p = put_f32(p, yaw_position[1]);
+    p = put_f32(p, yaw_setpoint[0]);
+    p = put_f32(p, yaw_setpoint[1]);
+    p = put_u16(p, pitch_pos);
+    telemetry_send(TELEMETRY_MSG_GIMBAL, body, p - body);
+}
+
+
+//Loop profiler summary, the histogram walk only runs when the frame is due
+void telemetry_profile(profiler_loop_e loop)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_PROFILE];
+    uint8_t *p = body;
+    profiler_summary_t exec, period;
+
+    if (!telemetry_due(TELEMETRY_MSG_PROFILE, loop))
+    {
+        return;
+    }
+    get_profiler_summary(loop, &exec, &period);
+    p = put_u8(p, loop);
+    p = put_u32(p, exec.count);
+    p = put_u32(p, exec.min);
+    p = put_u32(p, exec.avg);
+    p = put_u32(p, exec.max);
+    p = put_u32(p, exec.p99);
+    p = put_u32(p, period.min);
+    p = put_u32(p, period.avg);
+    p = put_u32(p, period.max);
+    p = put_u32(p, period.p99);
+    telemetry_send(TELEMETRY_MSG_PROFILE, body, p - body);
+}
+
+
+//Task monitor sample of one task, slot is its stable index
+void telemetry_task(uint8_t slot, const task_monitor_entry_t *entry)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_TASK];
+    uint8_t *p = body;
+
+    if (!telemetry_due(TELEMETRY_MSG_TASK, slot))
+    {
+        return;
+    }
+    p = put_u8(p, slot);
+    p = put_u8(p, entry->number);
+    memcpy(p, entry->name, TASK_MONITOR_NAME_LEN);
+    p += TASK_MONITOR_NAME_LEN;
+    p = put_u8(p, entry->priority);
+    p = put_u16(p, entry->cpu_permille);
+    p = put_u16(p, entry->stack_free_words);
+    p = put_u32(p, entry->run_time);
+    telemetry_send(TELEMETRY_MSG_TASK, body, p - body);
+}
+
+
+//Copies the frame counters
+void get_telemetry_stats(telemetry_stats_t *stats)
+{
+    uint32_t irq_state = hal_irq_disable();
+    *stats = telemetry_stats;
+    hal_irq_restore(irq_state);
+}
+
+
+
+/******************** Private Functions ********************/
+
+static uint8_t telemetry_due(telemetry_msg_e msg, uint8_t instance)
+{
+    uint16_t rate_hz = telemetry_rate_hz[msg];
+    TickType_t now = xTaskGetTickCount();
+    uint8_t due;
+
+    if (rate_hz == 0 || instance >= TELEMETRY_INSTANCE_NUM)
+    {
+        return 0;
+    }
+
+    uint32_t irq_state = hal_irq_disable();
+    due = !(telemetry_started[msg] & (1u << instance)) ||
+          now - telemetry_last_tick[msg][instance] >= configTICK_RATE_HZ / rate_hz;
+    if (due)
+    {
+        telemetry_started[msg] |= 1u << instance;
+        telemetry_last_tick[msg][instance] = now;
+    }
+    else
+    {
+        telemetry_stats.rate_limited++;
+    }
+    hal_irq_restore(irq_state);
+    return due;
+}
+
+static void telemetry_pid_send(telemetry_pid_loop_e loop, fp32 set, fp32 fdb, fp32 Pout, fp32 Iout, fp32 Dout,
+                               fp32 out)
+{
+    uint8_t body[TELEMETRY_BODY_LEN_PID];
+    uint8_t *p = body;
+
+    p = put_u8(p, loop);
+    p = put_f32(p, set);
+    p = put_f32(p, fdb);
+    p = put_f32(p, Pout);
+    p = put_f32(p, Iout);
+    p = put_f32(p, Dout);
+    p = put_f32(p, out);
+    telemetry_send(TELEMETRY_MSG_PID, body, p - body);
+}
+
+static uint8_t *put_u8(uint8_t *p, uint8_t value)
+{
+    *p++ = value;
+    return p;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    *p++ = value;
+    *p++ = value >> 8;
+    return p;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value)
+{
+    p = put_u16(p, value);
+    return put_u16(p, value >> 16);
+}
+
+static uint8_t *put_f32(uint8_t *p, fp32 value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put_u32(p, bits);
+}
+
+//IEEE 754 single of value / 2^frac_bits, mantissa truncated past 24 bits
+static uint8_t *put_q(uint8_t *p, int32_t value, uint8_t frac_bits)
+{
+    uint32_t sign = value < 0 ? 0x80000000u : 0;
+    uint32_t mag = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    uint8_t msb = 31;
+
+    if (mag == 0)
+    {
+        return put_u32(p, 0);
+    }
+    while (!(mag >> msb))
+    {
+        msb--;
+    }
+    uint32_t mantissa = msb > 23 ? mag >> (msb - 23) : mag << (23 - msb);
+    uint32_t exponent = 127 + msb - frac_bits;
+    return put_u32(p, sign | exponent << 23 | (mantissa & 0x7FFFFFu));
+}
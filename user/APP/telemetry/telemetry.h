@@ -0,0 +1,118 @@
+/**
+  ******************************************************************************
+    * @file    APP/telemetry
+    * @date    16-October-2026
+    * @brief   Binary telemetry over the USART6 log channel, replacing the sprintf
+    *          debug strings. Every message is one frame:
+    *              COBS( msg_id u8 | seq u8 | time u32 | body | crc16 ) 0x00
+    *          time is hal_cycle_count() at send, seq counts every frame sent so
+    *          the decoder can spot drops, crc16 covers everything before it.
+    *          Multi-byte fields are little endian, fp32 is IEEE 754 single.
+    *          host/tools/telemetry_decode.c turns a capture into CSV.
+    * @attention Each message type is rate limited on the FreeRTOS tick, set with
+    *          telemetry_set_rate. The defaults fit 115200 baud (~11.5 bytes/ms);
+    *          streaming every message at 1 kHz needs USART6_BAUDRATE around 2M.
+    *          Changing a body layout means a new msg_id, the decoder keys on it.
+  ******************************************************************************
+**/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include "main.h"
+#include "CAN_receive.h"
+#include "pid.h"
+#include "remote_control.h"
+#include "profiler.h"
+#include "task_monitor.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+//Message schema IDs, body layouts in the order the fields are sent
+typedef enum
+{
+    TELEMETRY_MSG_MOTOR = 1,    //motor u8 (ID - 0x201), ecd u16, speed_rpm i16, current i16, temperate u8
+    TELEMETRY_MSG_PID,          //loop u8, set f32, fdb f32, pout f32, iout f32, dout f32, out f32
+    TELEMETRY_MSG_IMU,          //angle f32[3] (yaw, pitch, roll), gyro f32[3], accel f32[3]
+    TELEMETRY_MSG_RC,           //ch i16[5], s u8[2], mouse x/y/z i16, press_l u8, press_r u8, key u16
+    TELEMETRY_MSG_LIMITER,      //motor u8, limiter u8, current i16
+    TELEMETRY_MSG_GIMBAL,       //yaw_position f32[2], yaw_setpoint f32[2], pitch_pos u16
+    TELEMETRY_MSG_PROFILE,      //loop u8, exec count/min/avg/max/p99 u32, period min/avg/max/p99 u32 (cycles)
+    TELEMETRY_MSG_TASK,         //slot u8, number u8, name char[8], priority u8, cpu_permille u16,
+                                //stack_free_words u16, run_time u32 (run time stats ticks, 1 us)
+    TELEMETRY_MSG_NUM,
+} telemetry_msg_e;
+
+//Body sizes, the decoder checks them
+#define TELEMETRY_BODY_LEN_MOTOR 8
+#define TELEMETRY_BODY_LEN_PID 25
+#define TELEMETRY_BODY_LEN_IMU 36
+#define TELEMETRY_BODY_LEN_RC 22
+#define TELEMETRY_BODY_LEN_LIMITER 4
+#define TELEMETRY_BODY_LEN_GIMBAL 18
+#define TELEMETRY_BODY_LEN_PROFILE 37
+#define TELEMETRY_BODY_LEN_TASK 19
+#define TELEMETRY_BODY_MAX 64
+
+//msg_id, seq, time
+#define TELEMETRY_HEADER_LEN 6
+#define TELEMETRY_CRC_LEN 2
+
+//Control loops reported by TELEMETRY_MSG_PID
+typedef enum
+{
+    TELEMETRY_PID_CHASSIS_FR = 0,
+    TELEMETRY_PID_CHASSIS_FL,
+    TELEMETRY_PID_CHASSIS_BL,
+    TELEMETRY_PID_CHASSIS_BR,
+    TELEMETRY_PID_YAW,
+    TELEMETRY_PID_PITCH,
+    TELEMETRY_PID_TRIGGER,
+    TELEMETRY_PID_YAW_RATE,
+    TELEMETRY_PID_PITCH_RATE,
+    TELEMETRY_PID_NUM,
+} telemetry_pid_loop_e;
+
+//Default rates in Hz, 0 turns a message off. Rates apply per instance (motor, loop)
+#define TELEMETRY_RATE_MOTOR 20
+#define TELEMETRY_RATE_PID 10
+#define TELEMETRY_RATE_IMU 50
+#define TELEMETRY_RATE_RC 10
+#define TELEMETRY_RATE_LIMITER 100
+#define TELEMETRY_RATE_GIMBAL 50
+#define TELEMETRY_RATE_PROFILE 1
+#define TELEMETRY_RATE_TASK 1
+//Largest instance index per message type
+#define TELEMETRY_INSTANCE_NUM 10
+
+//Frame counters
+typedef struct
+{
+    uint32_t sent;
+    uint32_t dropped;       //refused by the log ring
+    uint32_t rate_limited;  //skipped by telemetry_set_rate
+} telemetry_stats_t;
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Rate of a message type in Hz, 0 turns it off
+extern void telemetry_set_rate(telemetry_msg_e msg, uint16_t rate_hz);
+//Frames and sends a body as is, returns 1 if it was queued
+extern uint8_t telemetry_send(telemetry_msg_e msg, const uint8_t *body, uint8_t len);
+//Typed senders, each rate limited
+extern void telemetry_motor(can_msg_id_e id, const motor_feedback_t *feedback);
+extern void telemetry_pid(telemetry_pid_loop_e loop, const PidTypeDef *pid);
+extern void telemetry_pid_full(telemetry_pid_loop_e loop, const PidFullTypeDef *pid);
+extern void telemetry_pid_bank(telemetry_pid_loop_e loop, const PidBankTypeDef *bank, uint8_t index);
+extern void telemetry_pid_bank_q(telemetry_pid_loop_e loop, const PidBankQTypeDef *bank, uint8_t index);
+extern void telemetry_imu(const fp32 angle[3], const fp32 gyro[3], const fp32 accel[3]);
+extern void telemetry_rc(const RC_ctrl_t *rc);
+extern void telemetry_limiter(uint8_t motor, uint8_t limiter, int16_t current);
+extern void telemetry_gimbal(const fp32 yaw_position[2], const fp32 yaw_setpoint[2], uint16_t pitch_pos);
+extern void telemetry_profile(profiler_loop_e loop);
+extern void telemetry_task(uint8_t slot, const task_monitor_entry_t *entry);
+//Copies the frame counters
+extern void get_telemetry_stats(telemetry_stats_t *stats);
+
+#endif
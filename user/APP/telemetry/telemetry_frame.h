@@ -0,0 +1,30 @@
+/**
+  ******************************************************************************
+    * @file    APP/telemetry_frame
+    * @date    16-October-2026
+    * @brief   Byte level framing shared by the firmware and the host decoder:
+    *          CRC-16/CCITT-FALSE and COBS (consistent overhead byte stuffing).
+    *          A COBS encoded block contains no 0x00, so 0x00 delimits frames and
+    *          a receiver resynchronises at the next delimiter after a lost byte.
+    * @attention No dependencies beyond main.h, host/tools builds it as is.
+  ******************************************************************************
+**/
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+#include "main.h"
+
+#define TELEMETRY_FRAME_DELIMITER 0x00
+//Worst case COBS output for len input bytes, without the delimiter
+#define TELEMETRY_COBS_MAX_LEN(len) ((len) + (len) / 254 + 1)
+
+//CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, no reflection
+#define TELEMETRY_CRC_INIT 0xFFFF
+extern uint16_t telemetry_crc16(uint16_t crc, const uint8_t *data, uint16_t len);
+//Encodes len bytes into out (TELEMETRY_COBS_MAX_LEN(len) bytes), returns the encoded length
+extern uint16_t telemetry_cobs_encode(const uint8_t *in, uint16_t len, uint8_t *out);
+//Decodes a block without its delimiter into out (at most len bytes), returns the decoded
+//length or 0 if the block is malformed
+extern uint16_t telemetry_cobs_decode(const uint8_t *in, uint16_t len, uint8_t *out);
+
+#endif
@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+    * @file    APP/trace
+    * @date    16-October-2026
+    * @brief   Deferred formatting trace ring, see trace.h.
+    * @attention trace_write runs under a short interrupt mask: a handful of stores,
+    *          so records from interrupts and tasks never interleave.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "trace.h"
+#include "hal.h"
+
+
+/******************** Private User Declarations ********************/
+
+const char trace_fmt_anchor[] TRACE_FMT_SECTION = "trace_fmt_anchor";
+
+static trace_ring_t trace_ring;
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+/**
+* @brief  Fills the ring header the decoder checks. Records are kept across
+*         calls, head keeps counting
+* @param  None
+* @retval None
+*/
+void trace_init(void)
+{
+    trace_ring.magic = TRACE_MAGIC;
+    trace_ring.record_words = TRACE_RECORD_WORDS;
+    trace_ring.record_num = TRACE_RING_RECORDS;
+}
+
+
+/**
+* @brief  Stores one record, overwriting the oldest once the ring is full
+* @param  fmt: format string in the trace_fmt section
+* @param  nargs: argument count, at most TRACE_MAX_ARGS
+* @param  args: argument words
+* @retval None
+*/
+void trace_write(const char *fmt, uint32_t nargs, const uint32_t *args)
+{
+    uint32_t header = (uint32_t)(fmt - trace_fmt_anchor) << 4 | nargs;
+
+    uint32_t irq_state = hal_irq_disable();
+    trace_record_t *record = &trace_ring.records[trace_ring.head & (TRACE_RING_RECORDS - 1)];
+    record->header = header;
+    record->time = hal_cycle_count();
+    for (uint32_t i = 0; i < nargs; i++)
+    {
+        record->args[i] = args[i];
+    }
+    trace_ring.head++;
+    hal_irq_restore(irq_state);
+}
+
+
+//Ring to dump, the records are not copied
+const trace_ring_t *get_trace_ring(void)
+{
+    return &trace_ring;
+}
@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+    * @file    APP/trace
+    * @date    16-October-2026
+    * @brief   Deferred formatting trace log. TRACE("fmt", args...) stores the
+    *          offset of its format string, a cycle timestamp and up to
+    *          TRACE_MAX_ARGS raw argument words in a RAM ring; nothing is
+    *          formatted on the MCU. The format strings live in the trace_fmt
+    *          section of the image and host/tools/trace_decode.c puts the
+    *          messages back together from the ELF (.axf) and a dump of trace_ring.
+    * @attention Arguments are 32 bit words: integers and pointers as is, floats
+    *          through trace_f32 and printed with %f/%e/%g. %s is not supported,
+    *          the string would have to be copied. Format strings must be literals.
+    *          The decoder finds the ring in any RAM dump by its header, e.g. in uVision:
+    *              SAVE trace.hex 0x20000000, 0x2002FFFF
+    *          or a raw binary from openocd dump_image. Safe from tasks and interrupts.
+  ******************************************************************************
+**/
+
+#ifndef TRACE_H
+#define TRACE_H
+#include "main.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+//0 compiles every TRACE out, arguments are not evaluated
+#define TRACE_ENABLE 1
+
+#define TRACE_MAX_ARGS 6
+//Power of two, each record is TRACE_RECORD_WORDS words of RAM
+#define TRACE_RING_RECORDS 128
+
+#define TRACE_MAGIC 0x54524345u   //"TRCE"
+#define TRACE_RECORD_WORDS (2 + TRACE_MAX_ARGS)
+
+//Record layout: word 0 is the format string offset from trace_fmt_anchor shifted
+//left by 4 with the argument count in the low 4 bits, word 1 hal_cycle_count()
+typedef struct
+{
+    uint32_t header;
+    uint32_t time;
+    uint32_t args[TRACE_MAX_ARGS];
+} trace_record_t;
+
+//The whole ring is the dump format: fixed header, then the records
+typedef struct
+{
+    uint32_t magic;
+    uint32_t record_words;
+    uint32_t record_num;
+    volatile uint32_t head;     //records written since boot, slot is head % record_num
+    trace_record_t records[TRACE_RING_RECORDS];
+} trace_ring_t;
+
+#define TRACE_FMT_SECTION __attribute__((section("trace_fmt"), used))
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Format string offsets are taken from this string, the decoder looks it up by name
+extern const char trace_fmt_anchor[];
+//Fills the ring header, call once before the scheduler starts
+extern void trace_init(void);
+//Stores one record, use TRACE rather than calling it directly
+extern void trace_write(const char *fmt, uint32_t nargs, const uint32_t *args);
+//Ring to dump, the records are not copied
+extern const trace_ring_t *get_trace_ring(void);
+
+//Bit pattern of a float argument
+static __inline uint32_t trace_f32(fp32 value)
+{
+    union
+    {
+        fp32 f;
+        uint32_t u;
+    } bits;
+    bits.f = value;
+    return bits.u;
+}
+
+
+/******************** Trace Macros ********************/
+
+#if TRACE_ENABLE
+
+#define TRACE_FMT(fmt) static const char trace_fmt_str[] TRACE_FMT_SECTION = fmt
+
+#define TRACE0(fmt) \
+    do { TRACE_FMT(fmt); trace_write(trace_fmt_str, 0, 0); } while (0)
+#define TRACE1(fmt, a) \
+    do { TRACE_FMT(fmt); uint32_t trace_args[1] = {(uint32_t)(a)}; \
+         trace_write(trace_fmt_str, 1, trace_args); } while (0)
+#define TRACE2(fmt, a, b) \
+    do { TRACE_FMT(fmt); uint32_t trace_args[2] = {(uint32_t)(a), (uint32_t)(b)}; \
+         trace_write(trace_fmt_str, 2, trace_args); } while (0)
+#define TRACE3(fmt, a, b, c) \
+    do { TRACE_FMT(fmt); uint32_t trace_args[3] = {(uint32_t)(a), (uint32_t)(b), (uint32_t)(c)}; \
+         trace_write(trace_fmt_str, 3, trace_args); } while (0)
+#define TRACE4(fmt, a, b, c, d) \
+    do { TRACE_FMT(fmt); uint32_t trace_args[4] = {(uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d)}; \
+         trace_write(trace_fmt_str, 4, trace_args); } while (0)
+#define TRACE5(fmt, a, b, c, d, e) \
+    do { TRACE_FMT(fmt); uint32_t trace_args[5] = {(uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d), \
+                                                   (uint32_t)(e)}; \
+         trace_write(trace_fmt_str, 5, trace_args); } while (0)
+#define TRACE6(fmt, a, b, c, d, e, f) \
+    do { TRACE_FMT(fmt); uint32_t trace_args[6] = {(uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d), \
+                                                   (uint32_t)(e), (uint32_t)(f)}; \
+         trace_write(trace_fmt_str, 6, trace_args); } while (0)
+
+#else
+
+#define TRACE0(fmt) do { } while (0)
+#define TRACE1(fmt, a) do { } while (0)
+#define TRACE2(fmt, a, b) do { } while (0)
+#define TRACE3(fmt, a, b, c) do { } while (0)
+#define TRACE4(fmt, a, b, c, d) do { } while (0)
+#define TRACE5(fmt, a, b, c, d, e) do { } while (0)
+#define TRACE6(fmt, a, b, c, d, e, f) do { } while (0)
+
+#endif
+
+//TRACE("fmt", args...) picks TRACE0 ~ TRACE6 by the number of arguments
+#define TRACE_PICK(_fmt, _1, _2, _3, _4, _5, _6, name, ...) name
+#define TRACE(...) TRACE_PICK(__VA_ARGS__, TRACE6, TRACE5, TRACE4, TRACE3, TRACE2, TRACE1, TRACE0, 0)(__VA_ARGS__)
+
+#endif
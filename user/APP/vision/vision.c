@@ -0,0 +1,248 @@
+/**
+  ******************************************************************************
+    * @file    APP/vision
+    * @date    16-October-2026
+    * @brief   Vision PC receiver, see vision.h.
+    * @attention The interrupt only writes the back slot and swaps it with the
+    *          middle one. get_vision_target_point swaps the middle slot with the
+    *          front one under a short interrupt mask, so the front slot is never
+    *          written while gimbal_task reads it.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "vision.h"
+#include "telemetry_frame.h"
+#include "usart.h"
+#include "hal.h"
+
+#include <string.h>
+
+
+/******************** Private User Declarations ********************/
+
+//One character on the wire: start, 8 data and stop bit
+#define VISION_CHAR_CYCLES (HAL_CYCLE_HZ / (USART6_BAUDRATE / 10u))
+#define VISION_CRC_OFFSET (VISION_FRAME_LEN - 2u)
+
+//DMA double buffer, 2d for the same reason as SBUS_rx_buf
+static uint8_t vision_rx_buf[2][VISION_RX_BUF_NUM];
+
+//Triple buffer: the interrupt fills vision_back, the reader owns vision_front, vision_middle
+//holds the newest complete frame not yet taken when vision_fresh is set
+static vision_target_t vision_target[3];
+static uint8_t vision_back = 0;
+static uint8_t vision_middle = 1;
+static uint8_t vision_front = 2;
+static volatile uint8_t vision_fresh;
+static uint32_t vision_count;
+static uint8_t vision_last_seq;
+
+static vision_stats_t vision_stats;
+
+//Scans one DMA burst and publishes every good frame in it
+static void vision_parse_burst(const uint8_t *buf, uint16_t len, uint32_t rx_cycles);
+static void put_u32(uint8_t *p, uint32_t value);
+static uint32_t get_u32(const uint8_t *p);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Starts the USART6 DMA receiver, after USART_6_INIT
+void vision_init(void)
+{
+    memset(vision_target, 0, sizeof(vision_target));
+    memset(&vision_stats, 0, sizeof(vision_stats));
+    vision_count = 0;
+    vision_fresh = 0;
+    USART_6_RX_DMA_INIT(vision_rx_buf[0], vision_rx_buf[1], VISION_RX_BUF_NUM);
+}
+
+
+/**
+* @brief  Newest frame, read in place. Takes the middle slot if the interrupt has
+*         published since the last call, the previous front slot is then free for it
+* @param  None
+* @retval slot holding the newest frame, count is 0 before the first one
+*/
+const vision_target_t *get_vision_target_point(void)
+{
+    uint32_t irq_state = hal_irq_disable();
+    if (vision_fresh)
+    {
+        uint8_t front = vision_front;
+        vision_front = vision_middle;
+        vision_middle = front;
+        vision_fresh = 0;
+    }
+    hal_irq_restore(irq_state);
+    return &vision_target[vision_front];
+}
+
+
+/**
+* @brief  Checks that the vision PC is still talking
+* @param  target: slot returned by get_vision_target_point
+* @param  timeout_us: oldest acceptable frame
+* @retval 1 if there was no frame yet or the last one is older than timeout_us
+*/
+uint8_t vision_target_is_stale(const vision_target_t *target, uint32_t timeout_us)
+{
+    if (target->count == 0)
+    {
+        return 1;
+    }
+    return (hal_cycle_count() - target->rx_cycles) / HAL_CYCLES_PER_US > timeout_us;
+}
+
+
+//Copies the receive counters
+void get_vision_stats(vision_stats_t *stats)
+{
+    uint32_t irq_state = hal_irq_disable();
+    *stats = vision_stats;
+    hal_irq_restore(irq_state);
+}
+
+
+/**
+* @brief  Writes a frame as the vision PC sends it
+* @param  frame: contents, seq included
+* @param  out: VISION_FRAME_LEN bytes
+* @retval None
+*/
+void vision_frame_pack(const vision_frame_t *frame, uint8_t *out)
+{
+    uint32_t bits;
+
+    out[0] = VISION_FRAME_SOF;
+    out[1] = frame->seq;
+    out[2] = frame->flags;
+    out[3] = 0;
+    put_u32(out + 4, frame->timestamp_us);
+    put_u32(out + 8, frame->latency_us);
+    memcpy(&bits, &frame->yaw, sizeof(bits));
+    put_u32(out + 12, bits);
+    memcpy(&bits, &frame->pitch, sizeof(bits));
+    put_u32(out + 16, bits);
+    memcpy(&bits, &frame->distance, sizeof(bits));
+    put_u32(out + 20, bits);
+
+    uint16_t crc = telemetry_crc16(TELEMETRY_CRC_INIT, out, VISION_CRC_OFFSET);
+    out[VISION_CRC_OFFSET] = (uint8_t)crc;
+    out[VISION_CRC_OFFSET + 1] = (uint8_t)(crc >> 8);
+}
+
+
+/**
+* @brief  Checks and decodes one frame
+* @param  in: VISION_FRAME_LEN bytes starting at the start byte
+* @param  frame: filled in when the frame is good
+* @retval 1 if the start byte and CRC match
+*/
+uint8_t vision_frame_unpack(const uint8_t *in, vision_frame_t *frame)
+{
+    uint32_t bits;
+
+    if (in[0] != VISION_FRAME_SOF ||
+        telemetry_crc16(TELEMETRY_CRC_INIT, in, VISION_CRC_OFFSET) !=
+            (uint16_t)(in[VISION_CRC_OFFSET] | in[VISION_CRC_OFFSET + 1] << 8))
+    {
+        return 0;
+    }
+    frame->seq = in[1];
+    frame->flags = in[2];
+    frame->timestamp_us = get_u32(in + 4);
+    frame->latency_us = get_u32(in + 8);
+    bits = get_u32(in + 12);
+    memcpy(&frame->yaw, &bits, sizeof(bits));
+    bits = get_u32(in + 16);
+    memcpy(&frame->pitch, &bits, sizeof(bits));
+    bits = get_u32(in + 20);
+    memcpy(&frame->distance, &bits, sizeof(bits));
+    return 1;
+}
+
+
+// USART6 interrupt handler. On an IDLE line the DMA moves to the other
+// buffer and the one just filled is parsed here
+void USART6_IRQHandler(void)
+{
+    uint8_t this_time_rx_buf;
+    uint16_t this_time_rx_len;
+
+    if (hal_uart_dma_rx_idle(HAL_USART6, VISION_RX_BUF_NUM, &this_time_rx_buf, &this_time_rx_len))
+    {
+        vision_parse_burst(vision_rx_buf[this_time_rx_buf], this_time_rx_len, hal_cycle_count());
+    }
+}
+
+
+
+/******************** Private Functions ********************/
+
+/**
+* @brief  Publishes the good frames of a burst in order. A byte that does not start a
+*         good frame is skipped, so the scan resynchronises after noise or a cut frame
+* @param  buf, len: bytes received since the last IDLE line
+* @param  rx_cycles: time of the IDLE interrupt, one character after the last byte
+* @retval None
+*/
+static void vision_parse_burst(const uint8_t *buf, uint16_t len, uint32_t rx_cycles)
+{
+    uint16_t i = 0;
+
+    while (i + VISION_FRAME_LEN <= len)
+    {
+        vision_target_t *target = &vision_target[vision_back];
+
+        if (buf[i] != VISION_FRAME_SOF)
+        {
+            vision_stats.junk_bytes++;
+            i++;
+            continue;
+        }
+        if (!vision_frame_unpack(buf + i, &target->frame))
+        {
+            vision_stats.crc_errors++;
+            vision_stats.junk_bytes++;
+            i++;
+            continue;
+        }
+
+        if (vision_count != 0)
+        {
+            vision_stats.seq_gaps += (uint8_t)(target->frame.seq - vision_last_seq - 1);
+        }
+        vision_last_seq = target->frame.seq;
+        //Back from the IDLE event to the frame's first byte, then to the camera
+        uint32_t wire_chars = 1u + (len - i);
+        target->rx_cycles = rx_cycles;
+        target->capture_cycles = rx_cycles - wire_chars * VISION_CHAR_CYCLES
+                                 - target->frame.latency_us * HAL_CYCLES_PER_US;
+        target->count = ++vision_count;
+        vision_stats.frames++;
+
+        uint8_t back = vision_back;
+        vision_back = vision_middle;
+        vision_middle = back;
+        vision_fresh = 1;
+        i += VISION_FRAME_LEN;
+    }
+    vision_stats.junk_bytes += len - i;
+}
+
+static void put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return p[0] | p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
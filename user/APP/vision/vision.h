@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+    * @file    APP/vision
+    * @date    16-October-2026
+    * @brief   Target frames from the vision PC on USART6 RX. The bytes arrive by
+    *          DMA into a double buffer like the SBUS receiver in remote_control;
+    *          on the IDLE line interrupt the filled half is scanned for frames,
+    *          each is CRC checked and decoded into the free slot of a triple
+    *          buffer, then published by swapping indices. gimbal_task reads the
+    *          newest frame in place through get_vision_target_point.
+    * @attention Frame, little endian, VISION_FRAME_LEN bytes:
+    *            0   sof          VISION_FRAME_SOF
+    *            1   seq          incremented by the PC per frame
+    *            2   flags        VISION_FLAG_*
+    *            3   reserved     0
+    *            4   timestamp_us u32, capture time on the PC's clock
+    *            8   latency_us   u32, capture to the first byte on the wire
+    *            12  yaw          f32 rad, target direction relative to the camera,
+    *            16  pitch        f32 rad  counter clockwise from the top / right side
+    *            20  distance     f32 m
+    *            24  crc          u16, telemetry_crc16 of bytes 0 ~ 23
+    *          Frames may be sent back to back. The PC's clock is never compared
+    *          with ours: capture_cycles is the IDLE interrupt's time minus the
+    *          wire time and latency_us.
+  ******************************************************************************
+**/
+
+#ifndef VISION_H
+#define VISION_H
+#include "main.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+#define VISION_FRAME_SOF 0xA5
+#define VISION_FRAME_LEN 26u
+//Room for a few frames sent back to back in one burst
+#define VISION_RX_BUF_NUM (4u * VISION_FRAME_LEN)
+
+//The PC sees a target, yaw/pitch/distance are only meaningful with it set
+#define VISION_FLAG_TARGET (1u << 0)
+
+//Contents of one frame
+typedef struct
+{
+    uint8_t seq;
+    uint8_t flags;
+    uint32_t timestamp_us;
+    uint32_t latency_us;
+    fp32 yaw;
+    fp32 pitch;
+    fp32 distance;
+} vision_frame_t;
+
+//A received frame as published to the gimbal
+typedef struct
+{
+    vision_frame_t frame;
+    uint32_t rx_cycles;         //hal_cycle_count() in the IDLE interrupt that delivered it
+    uint32_t capture_cycles;    //hal_cycle_count() time the camera saw it
+    uint32_t count;             //frames published so far including this one, 0 before the first
+} vision_target_t;
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t crc_errors;
+    uint32_t junk_bytes;        //bytes skipped looking for a start of frame, partial frames included
+    uint32_t seq_gaps;          //frames missing according to seq
+} vision_stats_t;
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Starts the USART6 DMA receiver, after USART_6_INIT
+extern void vision_init(void);
+//Newest frame. The slot is left alone by the interrupt until the next call, so it can be
+//read in place; there is one such slot, so only gimbal_task may call this
+extern const vision_target_t *get_vision_target_point(void);
+//Whether no frame arrived within timeout_us
+extern uint8_t vision_target_is_stale(const vision_target_t *target, uint32_t timeout_us);
+//Copies the receive counters
+extern void get_vision_stats(vision_stats_t *stats);
+//Writes a frame into out (VISION_FRAME_LEN bytes), for the host stand-in of the vision PC
+extern void vision_frame_pack(const vision_frame_t *frame, uint8_t *out);
+//Decodes VISION_FRAME_LEN bytes, returns 0 if the start byte or CRC is wrong
+extern uint8_t vision_frame_unpack(const uint8_t *in, vision_frame_t *frame);
+
+#endif
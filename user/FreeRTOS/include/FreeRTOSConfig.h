@@ -87,6 +87,8 @@
 #if defined(__ICCARM__)   ||  defined(__CC_ARM) ||  defined(__GNUC__)
 	#include <stdint.h>
 	extern uint32_t SystemCoreClock;
+	extern void ConfigureTimeForRunTimeStats(void);
+	extern uint32_t GetRunTimeCounterValue(void);
 #endif
 
 
@@ -129,7 +131,10 @@
 #define configSUPPORT_DYNAMIC_ALLOCATION 1  //ֶ֧̬ڴ
 #define configUSE_TRACE_FACILITY		1   //Ϊ1ÿӻٵ
 
-#define configGENERATE_RUN_TIME_STATS	0   //Ϊ1ʱʱͳƹ
+#define configGENERATE_RUN_TIME_STATS	1   //Ϊ1ʱʱͳƹ
+//Run time stats clock: TIM2 free running at 1 MHz, see FreeRTOS_middleware.c
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() ConfigureTimeForRunTimeStats()
+#define portGET_RUN_TIME_COUNTER_VALUE() GetRunTimeCounterValue()
 
 #define configUSE_STATS_FORMATTING_FUNCTIONS	1       //configUSE_TRACE_FACILITYͬʱΪ1ʱ3
                                                         //prvWriteNameToBuffer(),vTaskList(),
@@ -155,6 +160,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTaskGetCurrentTaskHandle	1
 
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
@@ -22,6 +22,7 @@
 #include "mpu6500driver_middleware.h"
 
 #include "AHRS.h"
+#include "hal.h"
 
 //#include "calibrate_Task.h"
 //#include "pid.h"
@@ -29,8 +30,8 @@
 #include "FreeRTOSConfig.h"
 #include "FreeRTOS.h"
 #include "task.h"
-#include "USART_comms.h"
-#include <stdio.h>
+#include "telemetry.h"
+#include "profiler.h"
 #include "gimbal_task.h"
 #include "start_task.h"
 
@@ -39,7 +40,7 @@
 #define IMUWarnBuzzerOFF() buzzer_off() //У׼ر
 
 #define MPU6500_TEMPERATURE_PWM_INIT() TIM3_Init(MPU6500_TEMP_PWM_MAX, 1) //¶ȿPWMʼ
-#define IMUTempPWM(pwm) TIM_SetCompare2(TIM3, (pwm))                      //pwm
+#define IMUTempPWM(pwm) hal_pwm_set(HAL_PWM_IMU_HEAT, (pwm))              //pwm
 #define INS_GET_CONTROL_TEMPERATURE() get_control_temperate()             //ȡ¶ȵĿֵ
 
 #if defined(MPU6500_USE_DATA_READY_EXIT)
@@ -175,6 +176,16 @@ const fp32 *get_INS_angle_point(void)
     return INS_Angle;
 }
 
+/**
+ * @brief  Returns a pointer to the attitude quaternion the angles are taken from
+ * @param  None
+ * @retval w, x, y, z, rotates the board's axes into the navigation frame
+ */
+const fp32 *get_INS_quat_point(void)
+{
+    return INS_quat;
+}
+
 
 /**
  * @brief  Returns a pointer to a vector of current gyro reading
@@ -265,6 +276,8 @@ void INS_task(void *pvParameters)
 
 #endif
 
+        profiler_loop_start(PROFILER_LOOP_INS);
+
 //ʹSPIķʹͨSPIͨŵķ
 #ifndef MPU6500_USE_SPI_DMA
         mpu6500_read_muli_reg(MPU_INT_STATUS, mpu6500_spi_rxbuf, DMA_RX_NUM);
@@ -363,6 +376,8 @@ void INS_task(void *pvParameters)
 
         //IMU_temp_Control(mpu6500_real_data.temp);
 
+        profiler_loop_end(PROFILER_LOOP_INS);
+
 #if INCLUDE_uxTaskGetStackHighWaterMark
         INSTaskStack = uxTaskGetStackHighWaterMark(NULL);
 #endif
@@ -374,14 +389,13 @@ void INS_task(void *pvParameters)
 extern Gimbal_t gimbal;
 extern Gimbal_Motor_t gimbal_pitch_motor;
 
-static char message[32];
-
 /**
- * @brief  Reading angle, gyro, and accelerometer data and printing to serial
- * @param  angle: displays angle offset from start (zero) if TRUE
- * @param  gyro: displays gyroscope data if TRUE
- * @param  acce: displays accelerometer data if TRUE
+ * @brief  Reading angle, gyro, and accelerometer data and sending them as a telemetry frame
+ * @param  angle: sends the frame if TRUE, angle offset from start (zero)
+ * @param  gyro: sends the frame if TRUE
+ * @param  acce: sends the frame if TRUE
  * @retval None
+ * @note   The IMU frame always carries all three vectors, the flags only gate it
  */
 void test_imu_readings(uint8_t angle, uint8_t gyro, uint8_t accel){
     //Link pointers
@@ -389,37 +403,8 @@ void test_imu_readings(uint8_t angle, uint8_t gyro, uint8_t accel){
     gimbal.gyro_update = get_MPU6500_Gyro_Data_Point();
 	gimbal.accel_update = get_MPU6500_Accel_Data_Point();
     
-    if (angle == TRUE) {        
-        //Sending angle data via UART
-        sprintf(message, "Angle yaw: %f\n\r", gimbal.angle_update[INS_YAW_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        sprintf(message, "Angle pitch: %f\n\r", gimbal.angle_update[INS_PITCH_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        sprintf(message, "Angle roll: %f\n\r", gimbal.angle_update[INS_ROLL_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        serial_send_string("\n");
-    }
-    
-    if (gyro == TRUE) {
-        //Sending gyro data via UART
-        sprintf(message, "Gyro X: %f\n\r", gimbal.gyro_update[INS_GYRO_X_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        sprintf(message, "Gyro Y: %f\n\r", gimbal.gyro_update[INS_GYRO_Y_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        sprintf(message, "Gyro Z: %f\n\r", gimbal.gyro_update[INS_GYRO_Z_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        serial_send_string("\n");
-    }
- 
-    if (accel == TRUE) {        
-        //Sending accelerometer data via UART
-        sprintf(message, "Acce X: %f\n\r", gimbal.accel_update[INS_ACCEL_X_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        sprintf(message, "Acce Y: %f\n\r", gimbal.accel_update[INS_ACCEL_Y_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        sprintf(message, "Acce Z: %f\n\r", gimbal.accel_update[INS_ACCEL_Z_ADDRESS_OFFSET]);
-        serial_send_string(message);
-        serial_send_string("\n");
+    if (angle == TRUE || gyro == TRUE || accel == TRUE) {
+        telemetry_imu(gimbal.angle_update, gimbal.gyro_update, gimbal.accel_update);
     }
 }
 
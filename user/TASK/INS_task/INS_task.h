@@ -79,6 +79,8 @@ extern void INS_cali_gyro(fp32 cali_scale[3], fp32 cali_offset[3], uint16_t *tim
 extern void INS_set_cali_gyro(fp32 cali_scale[3], fp32 cali_offset[3]);
 //Returns a pointer to a vector defining the current robot position
 extern const fp32 *get_INS_angle_point(void);
+//Returns a pointer to the attitude quaternion, w x y z
+extern const fp32 *get_INS_quat_point(void);
 //Returns a pointer to a vector of current gyro reading
 extern const fp32 *get_MPU6500_Gyro_Data_Point(void);
 //Returns a pointer to a vector of current accelerometer reading
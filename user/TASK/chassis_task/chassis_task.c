@@ -3,23 +3,25 @@
     * @file    TASK/chassis_task
     * @date    03-February/2020
     * @brief   This file contains tasks and functions to control the chassis.
-    *          Raw control mode maps the motor output to wheel speed, no interaction with gimbal.
+    *          Raw control mode drives the chassis frame from the sticks, follow gimbal
+    *          and spin modes drive the gimbal frame and turn the chassis under it.
     * @attention PID tuning required.
   ******************************************************************************
 **/
 
 #include "chassis_task.h"
 #include "main.h"
-#include "stm32f4xx.h"
-#include <stdio.h>
 #include "FreeRTOSConfig.h"
 #include "FreeRTOS.h"
 #include "task.h"
 
 
 /******************** User Includes ********************/
-#include "CAN_Receive.h"
-#include "USART_comms.h"
+#include "CAN_receive.h"
+#include "control_tick.h"
+#include "profiler.h"
+#include "telemetry.h"
+#include "trace.h"
 #include "remote_control.h"
 #include "INS_task.h"
 #include "pid.h"
@@ -35,15 +37,18 @@ static void increment_PID(Chassis_t *chassis_pid);
 static void send_feedback_over_uart(Chassis_t *chassis);
 static void check_allowed_current(Chassis_t *chassis_feedback);
 static void limit_current(Chassis_Motor_t *motor);
+static void rotate_to_chassis_frame(mecanum_body_t *body, int32_t vx, int32_t vy, int16_t offset_ecd);
+static int32_t follow_gimbal_rate(int16_t offset_ecd);
 
 static Chassis_t chassis;
-    
-    
-    
-static char message[64] = {0};
-static int counter = 0;
-    
-#define DEBUG 0
+
+//Telemetry loop of each wheel, indexed by FRONT_RIGHT ~ BACK_RIGHT
+static const telemetry_pid_loop_e chassis_pid_loop[4] = {
+    [FRONT_RIGHT] = TELEMETRY_PID_CHASSIS_FR,
+    [FRONT_LEFT] = TELEMETRY_PID_CHASSIS_FL,
+    [BACK_LEFT] = TELEMETRY_PID_CHASSIS_BL,
+    [BACK_RIGHT] = TELEMETRY_PID_CHASSIS_BR,
+};
 
 /******************** Main Task/Functions Called from Outside ********************/
 
@@ -58,29 +63,49 @@ void chassis_task(void *pvParameters){
     vTaskDelay(CHASSIS_INIT_DELAY);
     //Initializes chassis with pointers to RC commands and CAN feedback messages
     
-    chassis_init(&chassis);
+    chassis_task_init();
+    control_tick_register_task(CONTROL_TICK_CHASSIS, xTaskGetCurrentTaskHandle(), CHASSIS_TASK_DELAY);
     
 	while(1) {
-        
-        get_new_data(&chassis); //updates RC commands and CAN motor feedback
-        set_control_mode(&chassis); //Note: currently not implemented
-        calculate_chassis_motion_setpoints(&chassis);
-        calculate_motor_setpoints(&chassis);
-        increment_PID(&chassis);
-        check_allowed_current(&chassis);
-        send_feedback_over_uart(&chassis);
-        //output
-        CAN_CMD_CHASSIS(chassis.motor[FRONT_RIGHT].current_out, 
-                        chassis.motor[FRONT_LEFT].current_out, 
-                        chassis.motor[BACK_LEFT].current_out, 
-                        chassis.motor[BACK_RIGHT].current_out);
-        
-        vTaskDelay(CHASSIS_TASK_DELAY);
-    
+        control_tick_wait(CONTROL_TICK_CHASSIS);
+        profiler_loop_start(PROFILER_LOOP_CHASSIS);
+        chassis_task_loop();
+        profiler_loop_end(PROFILER_LOOP_CHASSIS);
     }
 }
 
 
+/**
+ * @brief Initializes the chassis struct, split out of chassis_task so it can run without FreeRTOS
+ * @param None
+ * @retval None
+ */
+void chassis_task_init(void){
+    chassis_init(&chassis);
+}
+
+
+/**
+ * @brief One chassis control iteration: read feedback, compute setpoints and PID, send the CAN command
+ * @param None
+ * @retval None
+ */
+void chassis_task_loop(void){
+    get_new_data(&chassis); //updates RC commands and CAN motor feedback
+    set_control_mode(&chassis);
+    calculate_chassis_motion_setpoints(&chassis);
+    calculate_motor_setpoints(&chassis);
+    increment_PID(&chassis);
+    check_allowed_current(&chassis);
+    send_feedback_over_uart(&chassis);
+    //output
+    CAN_CMD_CHASSIS(chassis.motor[FRONT_RIGHT].current_out, 
+                    chassis.motor[FRONT_LEFT].current_out, 
+                    chassis.motor[BACK_LEFT].current_out, 
+                    chassis.motor[BACK_RIGHT].current_out);
+}
+
+
 /**
  * @brief Util, returns a pointer to the main chassis struct
  * @param None
@@ -100,7 +125,11 @@ Chassis_t* get_chassis_point(void) {
  */
 static void chassis_init(Chassis_t *chassis_init){    
     //Init PID constants
+#if PID_FIXED_POINT
+    static const int32_t def_pid_constants[3] = {PID_Q_CONST(M3508_KP), PID_Q_CONST(M3508_KI), PID_Q_CONST(M3508_KD)};
+#else
     fp32 def_pid_constants[3]  = {M3508_KP, M3508_KI, M3508_KD};
+#endif
     
     //Link pointers with CAN motors
     for (int i = 0; i < 4; i++) {
@@ -111,8 +140,12 @@ static void chassis_init(Chassis_t *chassis_init){
 			
         chassis_init->motor[i].limiter = FULL_CURRENT;
         chassis_init->motor[i].limiter_counter = 0;
-		PID_Init(&chassis_init->motor[i].pid_controller, PID_POSITION, def_pid_constants, M3508_MAX_OUT, M3508_MIN_OUT);
     }
+#if PID_FIXED_POINT
+    PID_bank_q_init(&chassis_init->wheel_pid, 4, def_pid_constants, PID_Q_CONST(M3508_MAX_OUT), PID_Q_CONST(M3508_MIN_OUT));
+#else
+    PID_bank_init(&chassis_init->wheel_pid, 4, def_pid_constants, M3508_MAX_OUT, M3508_MIN_OUT);
+#endif
     
     //Init yaw and front vector
     chassis_init->vec_raw = get_INS_angle_point();
@@ -120,6 +153,10 @@ static void chassis_init(Chassis_t *chassis_init){
 		
     //Pointer remote
     chassis_init->rc_update = get_remote_control_point();
+    
+    //Gimbal yaw, for the gimbal frame modes
+    chassis_init->yaw_feedback = get_yaw_gimbal_motor_feedback_pointer();
+    chassis_init->mode = CHASSIS_STOP;
 }
 
 
@@ -129,24 +166,52 @@ static void chassis_init(Chassis_t *chassis_init){
  * @retval None
  */
 static void get_new_data(Chassis_t *chassis_update){
+		motor_feedback_t feedback;
+		int32_t wheel_rpm[MECANUM_WHEEL_NUM];
 		for (int i = 0; i < 4; i++) {
-            chassis_update->motor[i].speed_read = chassis_update->motor[i].motor_feedback->speed_rpm;
-            chassis_update->motor[i].pos_read = chassis_update->motor[i].motor_feedback->ecd;
-            chassis_update->motor[i].current_read = chassis_update->motor[i].motor_feedback->current_read;
+            //Latched at the control tick, speed, position and current all come from the same CAN frame
+            get_motor_feedback_latched(chassis_update->motor[i].motor_feedback, &feedback);
+            chassis_update->motor[i].speed_read = feedback.speed_rpm;
+            chassis_update->motor[i].pos_read = feedback.ecd;
+            chassis_update->motor[i].current_read = feedback.current_read;
+            wheel_rpm[i] = feedback.speed_rpm;
 		}
+		mecanum_forward(wheel_rpm, &chassis_update->body_read);
+		
+		//Gimbal angle from the chassis front, wrapped to half a turn either way
+		get_motor_feedback_latched(chassis_update->yaw_feedback, &feedback);
+		chassis_update->gimbal_offset_ecd = (int16_t)((uint16_t)(feedback.ecd - CHASSIS_YAW_ECD_FORWARD + TRIG_LUT_ECD_RANGE / 2)
+		                                              & (TRIG_LUT_ECD_RANGE - 1)) - TRIG_LUT_ECD_RANGE / 2;
+		chassis_update->gimbal_offset_valid = !motor_feedback_is_stale(chassis_update->yaw_feedback, CHASSIS_FEEDBACK_TIMEOUT_US);
 }
 
 
 /**
- * @brief Based on the mode of operation, remote control data is processed. 
- *      Currently blank as raw control is implemented
+ * @brief Picks the driving mode from the right switch: down drives the chassis frame,
+ *      mid follows the gimbal yaw, or spins while the dial is turned, up stops.
+ *      The gimbal frame modes stop the chassis when the yaw encoder goes quiet
  * @param None
  * @retval None
  */
 
 static void set_control_mode(Chassis_t *chassis){
-	//Don't do anything
-    //Implement chassis_follow_gimbal_yaw mode in the future
+    const RC_ctrl_t *rc = chassis->rc_update;
+    chassis_user_mode_e previous_mode = chassis->mode;
+    
+    if(switch_is_down(rc->rc.s[RC_SWITCH_RIGHT])){
+        chassis->mode = CHASSIS_VECTOR_RAW;
+    }else if(switch_is_mid(rc->rc.s[RC_SWITCH_RIGHT])){
+        chassis->mode = abs(rc->rc.ch[RC_DIAL]) > CHASSIS_SPIN_DIAL_THRESHOLD ? CHASSIS_SPIN : CHASSIS_FOLLOW_GIMBAL_YAW;
+        if(!chassis->gimbal_offset_valid){
+            chassis->mode = CHASSIS_STOP;
+        }
+    }else{
+        chassis->mode = CHASSIS_STOP;
+    }
+    
+    if(chassis->mode != previous_mode){
+        TRACE("chassis mode %u -> %u, gimbal offset %d ecd", previous_mode, chassis->mode, chassis->gimbal_offset_ecd);
+    }
 }
 
 
@@ -158,108 +223,138 @@ static void set_control_mode(Chassis_t *chassis){
  */
 
 static void calculate_chassis_motion_setpoints(Chassis_t *chassis_set){
-    //Get remote control data and put into x_speed_read etc
-    //process based on mode (which is currently none) and put into x_speed_set
-    //Debug print out current 
-    
-    // get rc data and put into chassis struct
+    //Get remote control data, scale it to a body velocity and put it into body_set
+    //The sticks push right and turn clockwise, the body frame is left and counter clockwise
+    const int16_t *ch = chassis_set->rc_update->rc.ch;
+    int32_t vx = ch[RC_Y] * CHASSIS_RC_TO_MM_S;
+    int32_t vy = -ch[RC_X] * CHASSIS_RC_TO_MM_S;
 	
-	//Switch Chassis Only
-	if(switch_is_down(chassis_set->rc_update->rc.s[0])){
-        chassis_set->x_speed_read = chassis_set->rc_update->rc.ch[RC_X];
-        chassis_set->y_speed_read = chassis_set->rc_update->rc.ch[RC_Y];
-        chassis_set->z_speed_read = chassis_set->rc_update->rc.ch[RC_Z];
-    }else if(switch_is_mid(chassis_set->rc_update->rc.s[0])){
-        chassis_set->x_speed_read = 0;
-        chassis_set->y_speed_read = chassis_set->rc_update->rc.ch[RC_Y];
-        chassis_set->z_speed_read = chassis_set->rc_update->rc.ch[RC_Z];
-    }else if(switch_is_up(chassis_set->rc_update->rc.s[0])){
-        chassis_set->x_speed_read = 0;
-        chassis_set->y_speed_read = 0;
-        chassis_set->z_speed_read = 0;
+    switch(chassis_set->mode){
+        case CHASSIS_VECTOR_RAW:
+            chassis_set->body_set.vx = vx;
+            chassis_set->body_set.vy = vy;
+            chassis_set->body_set.wz = -ch[RC_Z] * CHASSIS_RC_TO_MRAD_S;
+            break;
+        case CHASSIS_FOLLOW_GIMBAL_YAW:
+            //The rotation stick turns the gimbal, the chassis turns after it
+            rotate_to_chassis_frame(&chassis_set->body_set, vx, vy, chassis_set->gimbal_offset_ecd);
+            chassis_set->body_set.wz = follow_gimbal_rate(chassis_set->gimbal_offset_ecd);
+            break;
+        case CHASSIS_SPIN:
+            //The gimbal turns back by the spin during the tick, rotate by the angle halfway through it
+            rotate_to_chassis_frame(&chassis_set->body_set, vx, vy, chassis_set->gimbal_offset_ecd - CHASSIS_SPIN_LEAD_ECD);
+            chassis_set->body_set.wz = CHASSIS_SPIN_MRAD_S;
+            break;
+        case CHASSIS_INDIVIDUAL_CONTROL:
+        case CHASSIS_STOP:
+        default:
+            chassis_set->body_set.vx = 0;
+            chassis_set->body_set.vy = 0;
+            chassis_set->body_set.wz = 0;
+            break;
     }
+}
+
+
+/**
+ * @brief Turns a velocity in the gimbal frame into the chassis frame
+ * @param body: filled with vx and vy, wz is left alone
+ * @param vx, vy: velocity in the gimbal frame, mm/s
+ * @param offset_ecd: gimbal angle from the chassis front, counter clockwise
+ * @retval None
+ */
+static void rotate_to_chassis_frame(mecanum_body_t *body, int32_t vx, int32_t vy, int16_t offset_ecd){
+    int32_t cos_q15 = trig_lut_cos_ecd((uint16_t)offset_ecd);
+    int32_t sin_q15 = trig_lut_sin_ecd((uint16_t)offset_ecd);
     
-    // process raw sppeds based on modes (for now they are just the same)
-    chassis_set->x_speed_set = chassis_set->x_speed_read;
-    chassis_set->y_speed_set = chassis_set->y_speed_read;
-    chassis_set->z_speed_set = chassis_set->z_speed_read;
+    //Q15 products back to whole units
+    body->vx = (cos_q15 * vx - sin_q15 * vy) / (TRIG_LUT_ONE + 1);
+    body->vy = (sin_q15 * vx + cos_q15 * vy) / (TRIG_LUT_ONE + 1);
 }
 
 
 /**
- * @brief Handles the data from remote controller. Converts xyz axis into mecanum wheel current values.
+ * @brief Proportional rotation that turns the chassis front towards the gimbal
+ * @param offset_ecd: gimbal angle from the chassis front, counter clockwise
+ * @retval wz in mrad/s, counter clockwise
+ */
+static int32_t follow_gimbal_rate(int16_t offset_ecd){
+    int32_t wz;
+    
+    if(abs(offset_ecd) <= CHASSIS_FOLLOW_DEADBAND_ECD){
+        return 0;
+    }
+    wz = offset_ecd * CHASSIS_FOLLOW_MRAD_S_PER_ECD;
+    wz = wz > CHASSIS_FOLLOW_MAX_MRAD_S ? CHASSIS_FOLLOW_MAX_MRAD_S : wz;
+    return wz < -CHASSIS_FOLLOW_MAX_MRAD_S ? -CHASSIS_FOLLOW_MAX_MRAD_S : wz;
+}
+
+
+/**
+ * @brief Converts the body velocity setpoint into mecanum wheel speeds, scaled down
+ *        together when one of them would pass CHASSIS_MAX_WHEEL_RPM
  * @param None
  * @retval None
  */
 static void calculate_motor_setpoints(Chassis_t *chassis_motors){
-	//Take x_speed_set etc and handle mechanum wheels
-    //Put results into Chassis_Motor_t speed_set (and/or pos_set)
-    chassis_motors->motor[FRONT_LEFT].speed_set = SETPOINT_SENSITIVITY * (chassis_motors->y_speed_set + chassis_motors->z_speed_set + chassis_motors->x_speed_set);
-    chassis_motors->motor[BACK_LEFT].speed_set = SETPOINT_SENSITIVITY * (chassis_motors->y_speed_set + chassis_motors->z_speed_set - chassis_motors->x_speed_set);
-    chassis_motors->motor[FRONT_RIGHT].speed_set = SETPOINT_SENSITIVITY * (-chassis_motors->y_speed_set + chassis_motors->z_speed_set + chassis_motors->x_speed_set);
-    chassis_motors->motor[BACK_RIGHT].speed_set = SETPOINT_SENSITIVITY * (-chassis_motors->y_speed_set + chassis_motors->z_speed_set - chassis_motors->x_speed_set);
+    int32_t wheel_rpm[MECANUM_WHEEL_NUM];
+    uint8_t was_desaturated = chassis_motors->desaturated;
+    
+    mecanum_mix(&chassis_motors->body_set, wheel_rpm);
+    chassis_motors->desaturated = mecanum_desaturate(wheel_rpm, CHASSIS_MAX_WHEEL_RPM);
+    for(int i = 0; i < 4; i++){
+        chassis_motors->motor[i].speed_set = wheel_rpm[i];
+    }
+    
+    if(chassis_motors->desaturated != was_desaturated){
+        TRACE("chassis desaturation %u, set vx %d vy %d wz %d", chassis_motors->desaturated,
+              chassis_motors->body_set.vx, chassis_motors->body_set.vy, chassis_motors->body_set.wz);
+    }
 }
 
 
-//Buffer used to store data for PID debugging
-char pid_out[64];
-
-
 /**
  * @brief PID calculations for motors, ensures that the motors run at a given speed
  * @param None
  * @retval None
  */
 static void increment_PID(Chassis_t *chassis_pid){
+#if PID_FIXED_POINT
+    int32_t speed_read[4], speed_set[4];
+#else
+    fp32 speed_read[4], speed_set[4];
+#endif
+    
+    for(int i = 0; i < 4; i++){
+        speed_read[i] = chassis_pid->motor[i].speed_read;
+        speed_set[i] = chassis_pid->motor[i].speed_set;
+    }
+    //All four wheels in one pass, the outputs are a correction on top of the setpoint
+#if PID_FIXED_POINT
+    PID_bank_q_calc(&chassis_pid->wheel_pid, speed_read, speed_set);
+    for(int i = 0; i < 4; i++){
+        chassis_pid->motor[i].current_out = PID_Q_TO_INT(PID_Q_FROM_INT(speed_set[i]) + chassis_pid->wheel_pid.out[i]);
+    }
+#else
+    PID_bank_calc(&chassis_pid->wheel_pid, speed_read, speed_set);
     for(int i = 0; i < 4; i++){
-        chassis_pid->motor[i].current_out = chassis_pid->motor[i].speed_set;
+        chassis_pid->motor[i].current_out = speed_set[i] + chassis_pid->wheel_pid.out[i];
     }
+#endif
     
-	chassis_pid->motor[FRONT_RIGHT].current_out += 
-        PID_Calc(&chassis_pid->motor[FRONT_RIGHT].pid_controller, 
-        chassis_pid->motor[FRONT_RIGHT].speed_read,
-        chassis_pid->motor[FRONT_RIGHT].speed_set);
-	
-	chassis_pid->motor[BACK_RIGHT].current_out += 
-        PID_Calc(&chassis_pid->motor[BACK_RIGHT].pid_controller, 
-        chassis_pid->motor[BACK_RIGHT].speed_read, 
-        chassis_pid->motor[BACK_RIGHT].speed_set);
-	
-	chassis_pid->motor[FRONT_LEFT].current_out += 
-        PID_Calc(&chassis_pid->motor[FRONT_LEFT].pid_controller, 
-        chassis_pid->motor[FRONT_LEFT].speed_read, 
-        chassis_pid->motor[FRONT_LEFT].speed_set);
-	
-	chassis_pid->motor[BACK_LEFT].current_out += 
-        PID_Calc(&chassis_pid->motor[BACK_LEFT].pid_controller, 
-        chassis_pid->motor[BACK_LEFT].speed_read, 
-        chassis_pid->motor[BACK_LEFT].speed_set);
+    //Stop driving a wheel that stopped reporting
+    for(int i = 0; i < 4; i++){
+        if(motor_feedback_is_stale(chassis_pid->motor[i].motor_feedback, CHASSIS_FEEDBACK_TIMEOUT_US)){
+            chassis_pid->motor[i].current_out = 0;
+        }
+    }
 	
-    if (DEBUG == 1) {
-        sprintf(pid_out, "Front Right - target: %d, sensor: %d, output: %d \n\r", 
-        chassis_pid->motor[FRONT_RIGHT].speed_set, 
-        chassis_pid->motor[FRONT_RIGHT].speed_read, 
-        chassis_pid->motor[FRONT_RIGHT].current_out);
-        serial_send_string(pid_out);
-        
-        sprintf(pid_out, "Back Right - target: %d, sensor: %d, output: %d \n\r", 
-        chassis_pid->motor[BACK_RIGHT].speed_set, 
-        chassis_pid->motor[BACK_RIGHT].speed_read, 
-        chassis_pid->motor[BACK_RIGHT].current_out);
-        serial_send_string(pid_out);
-        
-        sprintf(pid_out, "Front Left - target: %d, sensor: %d, output: %d \n\r", 
-        chassis_pid->motor[FRONT_LEFT].speed_set, 
-        chassis_pid->motor[FRONT_LEFT].speed_read, 
-        chassis_pid->motor[FRONT_LEFT].current_out);
-        serial_send_string(pid_out);
-        
-        sprintf(pid_out, "Back Left - target: %d, sensor: %d, output: %d \n\r", 
-        chassis_pid->motor[BACK_LEFT].speed_set, 
-        chassis_pid->motor[BACK_LEFT].speed_read, 
-        chassis_pid->motor[BACK_LEFT].current_out);
-        serial_send_string(pid_out);
-        
+    for(int i = 0; i < 4; i++){
+#if PID_FIXED_POINT
+        telemetry_pid_bank_q(chassis_pid_loop[i], &chassis_pid->wheel_pid, i);
+#else
+        telemetry_pid_bank(chassis_pid_loop[i], &chassis_pid->wheel_pid, i);
+#endif
     }
 }
 
@@ -277,9 +372,9 @@ static void increment_PID(Chassis_t *chassis_pid){
 
 static void check_allowed_current(Chassis_t *chassis_feedback){
     for(int i = 0; i < 4; i++){
+        current_limiter_state_e previous_limiter = chassis_feedback->motor[i].limiter;
        if(abs(chassis_feedback->motor[i].motor_feedback->current_read) > CURRENT_LIMIT){
-           sprintf(message, "current limit reached, limiter state is %d", chassis_feedback->motor[i].limiter);
-           serial_send_string(message);
+           telemetry_limiter(i, chassis_feedback->motor[i].limiter, chassis_feedback->motor[i].motor_feedback->current_read);
             if(chassis_feedback->motor[i].limiter == FULL_CURRENT){
                 chassis_feedback->motor[i].limiter = HALF_CURRENT;
             }
@@ -304,21 +399,26 @@ static void check_allowed_current(Chassis_t *chassis_feedback){
             }
         }
         
+        //Transitions are rare, cheap enough to keep in competition builds
+        if(chassis_feedback->motor[i].limiter != previous_limiter){
+            TRACE("chassis motor %u limiter %u -> %u, current %d", i, previous_limiter,
+                  chassis_feedback->motor[i].limiter, chassis_feedback->motor[i].motor_feedback->current_read);
+        }
         limit_current(&chassis_feedback->motor[i]);
     }
 }
 
     
+//Integer division truncates toward zero like the float scaling it replaced, without touching the FPU
 static void limit_current(Chassis_Motor_t *motor){
-    sprintf(message, "limiter state is changing from %d", motor->limiter);
     switch(motor->limiter){
         case FULL_CURRENT:
             break;
         case HALF_CURRENT:
-            motor->current_out *= 0.5f;
+            motor->current_out /= 2;
             break;
         case QUARTER_CURRENT:
-            motor->current_out *= 0.25f;
+            motor->current_out /= 4;
             break;
         case NO_CURRENT:
         default:
@@ -329,14 +429,7 @@ static void limit_current(Chassis_Motor_t *motor){
 }
 
 static void send_feedback_over_uart(Chassis_t *chassis){
-    if(counter == 0){
-        sprintf(message, "chassis rpm is: %i \n\r", chassis->motor[0].motor_feedback->speed_rpm);
-        serial_send_string(message);
-        sprintf(message, "chassis torque current is: %i \n\r", chassis->motor[0].motor_feedback->current_read);
-        serial_send_string(message);
-        sprintf(message, "chassis limiter state: %d", chassis->motor[0].limiter);
-        serial_send_string(message);
+    for(int i = 0; i < 4; i++){
+        telemetry_motor((can_msg_id_e)(CAN_3508_M1_ID + i), chassis->motor[i].motor_feedback);
     }
-    
-    counter = (counter + 1) % 1000;
 }
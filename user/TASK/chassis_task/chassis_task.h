@@ -15,6 +15,8 @@
 #include "main.h"
 #include "remote_control.h"
 #include "pid.h"
+#include "mecanum.h"
+#include "trig_lut.h"
 
 /******************************* Task Delays *********************************/
 #define CHASSIS_TASK_DELAY 5
@@ -28,7 +30,24 @@
 #define BACK_LEFT 2
 #define BACK_RIGHT 3
 
-#define SETPOINT_SENSITIVITY 5
+//Body velocity at full stick deflection (660): about 1.3 m/s and 3.3 rad/s
+#define CHASSIS_RC_TO_MM_S 2
+#define CHASSIS_RC_TO_MRAD_S 5
+//speed_set doubles as the current feed forward, so the wheels are desaturated to the output limit
+#define CHASSIS_MAX_WHEEL_RPM M3508_MAX_OUT
+
+//Yaw motor encoder reading with the gimbal facing the chassis front, the count
+//grows counter clockwise
+#define CHASSIS_YAW_ECD_FORWARD 6144
+//Follow gimbal: rotation per ecd of gimbal offset, its limit, and an offset left alone
+#define CHASSIS_FOLLOW_MRAD_S_PER_ECD 2
+#define CHASSIS_FOLLOW_MAX_MRAD_S 4000
+#define CHASSIS_FOLLOW_DEADBAND_ECD 20
+//Spin: dial (ch4) deflection that starts it, and its rotation rate
+#define CHASSIS_SPIN_DIAL_THRESHOLD 330
+#define CHASSIS_SPIN_MRAD_S 4000
+//Encoder counts the chassis turns in half a chassis tick while spinning
+#define CHASSIS_SPIN_LEAD_ECD (CHASSIS_SPIN_MRAD_S * CHASSIS_TASK_DELAY * TRIG_LUT_ECD_RANGE / (2 * 6283185))
 
 // RC channels -- this indicated strafe drive
 // left stick: rotation
@@ -36,6 +55,7 @@
 #define RC_X 0 
 #define RC_Y 1
 #define RC_Z 2
+#define RC_DIAL 4
 // For 
 
 //M3508 motors max and min CAN output
@@ -49,6 +69,8 @@
 // Current Limiting Constants
 #define HYSTERESIS_PERIOD 5
 #define CURRENT_LIMIT 25000
+// Motors whose last CAN frame is older than this are not driven
+#define CHASSIS_FEEDBACK_TIMEOUT_US 20000
 
 typedef enum{
     FULL_CURRENT,  
@@ -61,6 +83,8 @@ typedef enum{
     CHASSIS_VECTOR_RAW,
     CHASSIS_FOLLOW_GIMBAL_YAW,
     CHASSIS_INDIVIDUAL_CONTROL,
+    CHASSIS_SPIN,               //constant rotation, translation in the gimbal frame
+    CHASSIS_STOP,
 } chassis_user_mode_e;
 
 
@@ -82,9 +106,6 @@ typedef struct
     // Current limiting parameters
     int8_t limiter_counter;
     current_limiter_state_e limiter;
-	
-    //Control
-    PidTypeDef pid_controller;
 } Chassis_Motor_t;
 
 
@@ -93,22 +114,33 @@ typedef struct
     Chassis_Motor_t motor[4];
     chassis_user_mode_e mode;
     
+    //Speed PID of the four wheels, indexed by FRONT_RIGHT ~ BACK_RIGHT
+#if PID_FIXED_POINT
+    PidBankQTypeDef wheel_pid;
+#else
+    PidBankTypeDef wheel_pid;
+#endif
+    
     //Raw remote control data
     const RC_ctrl_t *rc_update;
     
+    //Gimbal yaw motor, and the gimbal angle from the chassis front in ecd,
+    //-TRIG_LUT_ECD_RANGE / 2 ~ TRIG_LUT_ECD_RANGE / 2 - 1, counter clockwise
+    const motor_feedback_t *yaw_feedback;
+    int16_t gimbal_offset_ecd;
+    uint8_t gimbal_offset_valid;
+    
     //Current front vector
     const fp32 *vec_raw;
     const fp32 *yaw_pos_raw;
     
-    //Current speed, vector combination of the speed read from motors
-    int16_t x_speed_read;
-    int16_t y_speed_read;
-    int16_t z_speed_read;
+    //Current body velocity, from the speed read from motors through mecanum_forward
+    mecanum_body_t body_read;
     
-    //Speed set by user/remote control
-    int16_t x_speed_set;
-    int16_t y_speed_set;
-    int16_t z_speed_set;
+    //Body velocity set by user/remote control
+    mecanum_body_t body_set;
+    //1 while the wheel setpoints are scaled down to CHASSIS_MAX_WHEEL_RPM
+    uint8_t desaturated;
 } Chassis_t;
 
 
@@ -119,6 +151,8 @@ typedef struct
 /******************** Main Task/Functions Called from Outside ********************/
 
 extern void chassis_task(void *pvParameters);
+extern void chassis_task_init(void);
+extern void chassis_task_loop(void);
 extern Chassis_t* get_chassis_point(void);
 
 #endif
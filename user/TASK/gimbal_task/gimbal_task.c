@@ -14,7 +14,6 @@
 
 
 #include "gimbal_task.h"
-#include "stm32f4xx.h"
 #include "FreeRTOSConfig.h"
 #include "FreeRTOS.h"
 #include "task.h"
@@ -22,34 +21,43 @@
 #include "arm_math.h"
 
 /******************** User Includes ********************/
-#include "CAN_Receive.h"
+#include "CAN_receive.h"
+#include "control_tick.h"
+#include "hal.h"
+#include "profiler.h"
 #include "user_lib.h"
+#include "trig_lut.h"
 #include "remote_control.h"
-#include "USART_comms.h"
-#include <stdio.h>
+#include "telemetry.h"
+#include "trace.h"
 #include "pid.h"
 #include "shoot_task.h"
 #include <math.h>
 
 #define DEADBAND 1
+// Loop periods, the gimbal is released by the control tick every GIMBAL_TASK_DELAY ticks
+#define GIMBAL_RATE_LOOP_DT (GIMBAL_TASK_DELAY * CONTROL_TICK_PERIOD_US * 0.000001f)
+#define GIMBAL_ANGLE_LOOP_DT (GIMBAL_ANGLE_LOOP_DIVIDER * GIMBAL_RATE_LOOP_DT)
+// Yaw encoder angle in the same units as the complex yaw position, full turn = MOTOR_ECD_RANGE
+#define GIMBAL_YAW_ECD_TO_RAD (2.0f * PI / MOTOR_ECD_RANGE)
             
 
 // This is accessbile globally and some data is loaded from INS_task
 Gimbal_t gimbal;
 
-static int loop_counter = 0;
-
 /******************** Functions ********************/
 static void initialization(Gimbal_t *gimbal);
 static void get_new_data(Gimbal_t *gimbal);
 static void update_setpoints(Gimbal_t *gimbal);
 static void increment_PID(Gimbal_t *gimbal);
+static void update_frame_estimate(gimbal_frame_estimate_t *frame, uint16_t ecd, int32_t output_ecd, fp32 ecd_to_rad,
+                                  fp32 imu_angle, fp32 imu_rate);
+static void set_frame_mode(Gimbal_t *gimbal, gimbal_frame_e mode);
 static void fill_complex_equivalent(fp32 position[2], uint16_t ecd_value);
 static void multiply_complex_a_by_b(fp32 a[2], fp32 b[2]);
 static void make_unit_length(fp32 n[2]);
 static fp32 a_dot_b(fp32 a[2], fp32 b[2]);
 static fp32 length_of_a_cross_b(fp32 a[2], fp32 b[2]);
-static int16_t get_error_sign(fp32 actual_position[2], fp32 set_position[2]);
 
 /**
  * @brief Initializes PID and fetches Gimbal motor data to ensure 
@@ -60,31 +68,46 @@ static int16_t get_error_sign(fp32 actual_position[2], fp32 set_position[2]);
 void gimbal_task(void* parameters){
 
     vTaskDelay(GIMBAL_INIT_DELAY);
-	initialization(&gimbal);
+	gimbal_task_init();
+    control_tick_register_task(CONTROL_TICK_GIMBAL, xTaskGetCurrentTaskHandle(), GIMBAL_TASK_DELAY);
     
     while(1){	
-        //send_to_uart(&gimbal);
-        
-        /* For now using strictly encoder feedback for position */
-        
-        get_new_data(&gimbal);
-        //send_to_uart(&gimbal);
-        update_setpoints(&gimbal);
-        //send_to_uart(&gimbal);
-        increment_PID(&gimbal);
-        //send_to_uart(&gimbal);
-        // Turn gimbal motor
-        CAN_CMD_GIMBAL( (int16_t) gimbal.yaw_motor.voltage_out, 
-                        (int16_t) gimbal.pitch_motor.voltage_out,
-                        (int16_t) gimbal.launcher->trigger_motor.speed_set, 
-                        (int16_t) gimbal.launcher->hopper_motor.speed_set);
-        
-        //Sending data via UART
-        vTaskDelay(GIMBAL_TASK_DELAY);
-        //send_to_uart(&gimbal);
+        control_tick_wait(CONTROL_TICK_GIMBAL);
+        profiler_loop_start(PROFILER_LOOP_GIMBAL);
+        gimbal_task_loop();
+        profiler_loop_end(PROFILER_LOOP_GIMBAL);
 	}
 }
 
+/**
+ * @brief  Initializes the gimbal struct, split out of gimbal_task so it can run without FreeRTOS
+ * @param  None
+ * @retval None
+ */
+void gimbal_task_init(void){
+    initialization(&gimbal);
+}
+
+/**
+ * @brief  One gimbal control iteration: read encoders, update setpoints, run PID and send the CAN command
+ * @param  None
+ * @retval None
+ */
+void gimbal_task_loop(void){
+    /* For now using strictly encoder feedback for position */
+    
+    get_new_data(&gimbal);
+    update_setpoints(&gimbal);
+    increment_PID(&gimbal);
+    //Sending data via UART, rate limited by the telemetry module
+    send_to_uart(&gimbal);
+    // Turn gimbal motor
+    CAN_CMD_GIMBAL( (int16_t) gimbal.yaw_motor.voltage_out, 
+                    (int16_t) gimbal.pitch_motor.voltage_out,
+                    (int16_t) gimbal.launcher->trigger_motor.speed_set, 
+                    (int16_t) gimbal.launcher->hopper_motor.speed_set);
+}
+
 /** 
  * @brief  Initializes gimbal struct and loads pointers for RC and motor feedback
  * @param  None
@@ -94,38 +117,92 @@ static void initialization(Gimbal_t *gimbal_ptr){
     gimbal_ptr->pitch_motor.motor_feedback = get_pitch_motor_feedback_pointer();
     gimbal_ptr->yaw_motor.motor_feedback = get_yaw_gimbal_motor_feedback_pointer(); 
     gimbal_ptr->launcher = get_launcher_pointer();
-    fp32 pid_constants_yaw[3] = {pid_kp_yaw, pid_ki_yaw, pid_kd_yaw};
-    fp32 pid_constants_pitch[3] = {pid_kp_pitch, pid_ki_pitch, pid_kd_pitch};
+    // Angle loops take the RC setpoint rate as velocity feed-forward
+    PidFullConfigTypeDef yaw_angle = {.Kp = pid_kp_yaw_angle, .Ki = pid_ki_yaw_angle, .Kd = pid_kd_yaw_angle,
+                                      .Kff_vel = 1.0f, .anti_windup = PID_AW_CLAMP,
+                                      .max_out = max_rate_yaw, .max_iout = max_i_term_rate_yaw};
+    PidFullConfigTypeDef yaw_rate = {.Kp = pid_kp_yaw_rate, .Ki = pid_ki_yaw_rate, .Kd = pid_kd_yaw_rate,
+                                     .anti_windup = PID_AW_CLAMP,
+                                     .max_out = max_out_yaw, .max_iout = max_i_term_out_yaw};
+    PidFullConfigTypeDef pitch_angle = {.Kp = pid_kp_pitch_angle, .Ki = pid_ki_pitch_angle, .Kd = pid_kd_pitch_angle,
+                                        .anti_windup = PID_AW_CLAMP,
+                                        .max_out = max_rate_pitch, .max_iout = max_i_term_rate_pitch};
+    PidFullConfigTypeDef pitch_rate = {.Kp = pid_kp_pitch_rate, .Ki = pid_ki_pitch_rate, .Kd = pid_kd_pitch_rate,
+                                       .anti_windup = PID_AW_CLAMP,
+                                       .max_out = max_out_pitch, .max_iout = max_i_term_out_pitch};
     
+    gimbal_ptr->frame_mode = GIMBAL_FRAME_ENCODER;
+    gimbal_ptr->yaw_world_setpoint[0] = 0.0;
+    gimbal_ptr->yaw_world_setpoint[1] = -1.0;
     gimbal_ptr->yaw_setpoint[0] = 0.0;
     gimbal_ptr->yaw_setpoint[1] = -1.0;
     gimbal_ptr->yaw_position[0] = 0.0;
     gimbal_ptr->yaw_position[1] = -1.0;
     gimbal_ptr->yaw_error = 0.0;
+    gimbal_ptr->yaw_set_rate = 0.0;
+    gimbal_ptr->angle_loop_count = 0;
     
-    PID_Init(&(gimbal_ptr->pitch_motor.pid_controller), PID_POSITION, pid_constants_pitch, max_out_pitch, max_i_term_out_pitch);
-    PID_Init(&(gimbal_ptr->yaw_motor.pid_controller), PID_POSITION, pid_constants_yaw, max_out_yaw, max_i_term_out_yaw);
+    PID_full_init(&gimbal_ptr->yaw_motor.angle_pid, &yaw_angle);
+    PID_full_init(&gimbal_ptr->yaw_motor.rate_pid, &yaw_rate);
+    PID_full_init(&gimbal_ptr->pitch_motor.angle_pid, &pitch_angle);
+    PID_full_init(&gimbal_ptr->pitch_motor.rate_pid, &pitch_rate);
+    gimbal_ptr->yaw_motor.rate_set = 0.0f;
+    gimbal_ptr->pitch_motor.rate_set = 0.0f;
+    gimbal_ptr->yaw_motor.frame.valid = 0;
+    gimbal_ptr->pitch_motor.frame.valid = 0;
     
     gimbal_ptr->rc_update = get_remote_control_point();
+    gimbal_ptr->angle_update = get_INS_angle_point();
+    gimbal_ptr->gyro_update = get_MPU6500_Gyro_Data_Point();
+    gimbal_ptr->quat_update = get_INS_quat_point();
+    gimbal_ptr->vision_target = get_vision_target_point();
+    aim_init(&gimbal_ptr->aim, GIMBAL_AIM_MODEL);
+    gimbal_ptr->aiming = 0;
     
     gimbal_ptr->pitch_motor.pos_set = GIMBAL_PITCH_INITIAL_POSITION;
 }
 
 /** 
- * @brief  Update encoder positions
+ * @brief  Update encoder positions, gyro rates and the frame estimates
  * @param  None
  * @retval None
  */
 static void get_new_data(Gimbal_t *gimbal_data){  
+    motor_feedback_t feedback;
+    int32_t pitch_output_ecd, yaw_output_ecd;
      
-    // Get CAN received data 
-    gimbal_data->pitch_motor.pos_read = gimbal_data->pitch_motor.motor_feedback->ecd;
-    gimbal_data->pitch_motor.speed_read = gimbal_data->pitch_motor.motor_feedback->speed_rpm;
+    // Get CAN data latched at the control tick, position and speed come from the same frame
+    get_motor_feedback_latched(gimbal_data->pitch_motor.motor_feedback, &feedback);
+    gimbal_data->pitch_motor.pos_read = feedback.ecd;
+    gimbal_data->pitch_motor.speed_read = feedback.speed_rpm;
+    pitch_output_ecd = get_motor_output_ecd(&feedback);
 
-    gimbal_data->yaw_motor.pos_read = gimbal_data->yaw_motor.motor_feedback->ecd;
-    gimbal_data->yaw_motor.speed_read = gimbal_data->yaw_motor.motor_feedback->speed_rpm;
+    get_motor_feedback_latched(gimbal_data->yaw_motor.motor_feedback, &feedback);
+    gimbal_data->yaw_motor.pos_read = feedback.ecd;
+    gimbal_data->yaw_motor.speed_read = feedback.speed_rpm;
+    yaw_output_ecd = get_motor_output_ecd(&feedback);
+    
+    // Attitude history first, so a frame captured up to now can be re-projected
+    uint32_t now = hal_cycle_count();
+    aim_attitude_push(&gimbal_data->aim, now, gimbal_data->quat_update);
+    // Swaps in the vision PC's newest frame, if one came since the last iteration
+    gimbal_data->vision_target = get_vision_target_point();
+    aim_measure(&gimbal_data->aim, gimbal_data->vision_target);
+    aim_solve(&gimbal_data->aim, now, &gimbal_data->aim_solution);
+    
+    // Rate loop feedback from the gyro, updated by INS_task at the same 1 kHz
+    gimbal_data->yaw_motor.rate_read = GIMBAL_YAW_GYRO_SIGN * gimbal_data->gyro_update[GIMBAL_YAW_GYRO_AXIS];
+    gimbal_data->pitch_motor.rate_read = GIMBAL_PITCH_GYRO_SIGN * gimbal_data->gyro_update[GIMBAL_PITCH_GYRO_AXIS];
     
     fill_complex_equivalent(gimbal_data->yaw_position, gimbal_data->yaw_motor.pos_read);
+
+    // Kept up to date in both modes so switching to the world frame starts from a settled estimate
+    update_frame_estimate(&gimbal_data->yaw_motor.frame, gimbal_data->yaw_motor.pos_read, yaw_output_ecd,
+                          GIMBAL_YAW_ECD_TO_RAD, GIMBAL_YAW_IMU_SIGN * gimbal_data->angle_update[GIMBAL_YAW_IMU_AXIS],
+                          gimbal_data->yaw_motor.rate_read);
+    update_frame_estimate(&gimbal_data->pitch_motor.frame, gimbal_data->pitch_motor.pos_read, pitch_output_ecd,
+                          MOTOR_ECD_TO_RAD, GIMBAL_PITCH_IMU_SIGN * gimbal_data->angle_update[GIMBAL_PITCH_IMU_AXIS],
+                          gimbal_data->pitch_motor.rate_read);
 }
 
 /** 
@@ -134,51 +211,179 @@ static void get_new_data(Gimbal_t *gimbal_data){
  * @retval None
  */
 static void update_setpoints(Gimbal_t *gimbal_set){
+    uint8_t world = gimbal_set->rc_update->rc.s[RC_SWITCH_RIGHT] == GIMBAL_WORLD_FRAME_SWITCH;
+    fp32 *yaw_setpoint = world ? gimbal_set->yaw_world_setpoint : gimbal_set->yaw_setpoint;
+    fp32 pitch_delta = 0.0f;
     
-    if(gimbal_set->rc_update->rc.s[RC_SWITCH_RIGHT] == RC_SW_MID || gimbal_set->rc_update->rc.s[RC_SWITCH_RIGHT] == RC_SW_UP){
+    uint8_t aiming = world && gimbal_set->rc_update->mouse.press_r && gimbal_set->aim_solution.valid;
+    
+    set_frame_mode(gimbal_set, world ? GIMBAL_FRAME_WORLD : GIMBAL_FRAME_ENCODER);
+    if (aiming != gimbal_set->aiming) {
+        TRACE("gimbal aiming %u, target at %f m", aiming, trace_f32(gimbal_set->aim_solution.distance));
+        gimbal_set->aiming = aiming;
+    }
+    gimbal_set->yaw_set_rate = 0.0f;
+    if (aiming) {
+        // The predictor's lead point replaces the sticks, the world yaw rate is the feed-forward
+        const aim_solution_t *aim = &gimbal_set->aim_solution;
+        trig_lut_sin_cos(GIMBAL_YAW_IMU_SIGN * aim->yaw, &gimbal_set->yaw_world_setpoint[1],
+                         &gimbal_set->yaw_world_setpoint[0]);
+        gimbal_set->yaw_set_rate = GIMBAL_YAW_IMU_SIGN * aim->yaw_rate;
+        gimbal_set->pitch_motor.world_set = GIMBAL_PITCH_IMU_SIGN * aim->pitch;
+    } else if(gimbal_set->rc_update->rc.s[RC_SWITCH_RIGHT] == RC_SW_MID || gimbal_set->rc_update->rc.s[RC_SWITCH_RIGHT] == RC_SW_UP){
         fp32 theta = -1 * int16_deadzone(gimbal_set->rc_update->rc.ch[2], -DEADBAND, DEADBAND)
                 * MOTOR_ECD_TO_RAD / 80.0f;
         
-        fp32 yaw_delta_rotation[2] = {arm_cos_f32(theta), arm_sin_f32(theta)};
-        multiply_complex_a_by_b(gimbal_set->yaw_setpoint, yaw_delta_rotation);
-        make_unit_length(gimbal_set->yaw_setpoint);
+        fp32 yaw_delta_rotation[2];
+        trig_lut_sin_cos(theta, &yaw_delta_rotation[1], &yaw_delta_rotation[0]);
+        multiply_complex_a_by_b(yaw_setpoint, yaw_delta_rotation);
+        make_unit_length(yaw_setpoint);
+        gimbal_set->yaw_set_rate = theta / GIMBAL_RATE_LOOP_DT;
 
-        gimbal_set->pitch_motor.pos_set += int16_deadzone(gimbal_set->rc_update->rc.ch[3], -DEADBAND, DEADBAND) / 80.0f;
+        pitch_delta = int16_deadzone(gimbal_set->rc_update->rc.ch[3], -DEADBAND, DEADBAND) / 80.0f;
+    }
+    
+    if (!world) {
+        // The rate loop runs on the gyro, the setpoint turns with the chassis
+        gimbal_set->yaw_set_rate += gimbal_set->yaw_motor.frame.rate;
+        gimbal_set->pitch_motor.pos_set += pitch_delta;
+        gimbal_set->pitch_motor.pos_set = int16_constrain(gimbal_set->pitch_motor.pos_set, PITCH_MIN, PITCH_MAX);
+        return;
     }
     
-    gimbal_set->pitch_motor.pos_set = int16_constrain(gimbal_set->pitch_motor.pos_set, PITCH_MIN, PITCH_MAX);
+    // World setpoints seen from the chassis: rotate the yaw back by the chassis heading
+    fp32 heading[2];
+    trig_lut_sin_cos(-gimbal_set->yaw_motor.frame.angle, &heading[1], &heading[0]);
+    gimbal_set->yaw_setpoint[0] = gimbal_set->yaw_world_setpoint[0];
+    gimbal_set->yaw_setpoint[1] = gimbal_set->yaw_world_setpoint[1];
+    multiply_complex_a_by_b(gimbal_set->yaw_setpoint, heading);
+    
+    // Pitch target on the turn of the encoder closest to where the motor is, inside the
+    // travel; the world setpoint is pulled back with it so it never winds up at a limit
+    Gimbal_Motor_t *pitch = &gimbal_set->pitch_motor;
+    fp32 pos_read_rad = pitch->pos_read * MOTOR_ECD_TO_RAD;
+    pitch->world_set = rad_format(pitch->world_set + pitch_delta * MOTOR_ECD_TO_RAD);
+    fp32 pos_set = (pos_read_rad + rad_format(pitch->world_set - pitch->frame.angle - pos_read_rad)) / MOTOR_ECD_TO_RAD;
+    pos_set = fp32_constrain(pos_set, PITCH_MIN, PITCH_MAX);
+    pitch->world_set = rad_format(pos_set * MOTOR_ECD_TO_RAD + pitch->frame.angle);
+    pitch->pos_set = (int16_t)(pos_set + 0.5f);
 }  
 
 /** 
- * @brief  Increments PID loop based on latest setpoints and latest positions
+ * @brief  Switches between encoder and world frame setpoints without moving the gimbal:
+ *         the new frame's setpoints are taken from where the old ones point now
+ * @param  gimbal_mode: gimbal struct
+ * @param  mode: frame the setpoints should be kept in from now on
+ * @retval None
+ */
+static void set_frame_mode(Gimbal_t *gimbal_mode, gimbal_frame_e mode){
+    if (mode == gimbal_mode->frame_mode) {
+        return;
+    }
+    if (mode == GIMBAL_FRAME_WORLD) {
+        fp32 heading[2];
+        trig_lut_sin_cos(gimbal_mode->yaw_motor.frame.angle, &heading[1], &heading[0]);
+        gimbal_mode->yaw_world_setpoint[0] = gimbal_mode->yaw_setpoint[0];
+        gimbal_mode->yaw_world_setpoint[1] = gimbal_mode->yaw_setpoint[1];
+        multiply_complex_a_by_b(gimbal_mode->yaw_world_setpoint, heading);
+        gimbal_mode->pitch_motor.world_set = rad_format(gimbal_mode->pitch_motor.pos_set * MOTOR_ECD_TO_RAD
+                                                        + gimbal_mode->pitch_motor.frame.angle);
+    }
+    // Back to encoder: yaw_setpoint and pos_set already hold the chassis relative targets
+    TRACE("gimbal frame %u -> %u, chassis heading %f rad", gimbal_mode->frame_mode, mode,
+          trace_f32(gimbal_mode->yaw_motor.frame.angle));
+    gimbal_mode->frame_mode = mode;
+}
+
+/** 
+ * @brief  Tracks the orientation of the frame a motor is mounted on. Over one iteration the
+ *         frame turns by what the gyro saw minus what the encoder saw, the step of the
+ *         multi-turn encoder needs no unwrapping and the gyro step is the trapezoid of its
+ *         two rates. The sum drifts with the gyro bias, so the angle is also pulled towards
+ *         IMU minus encoder, slowly enough to keep the AHRS noise out.
+ * @param  frame: estimate to update, seeded from the IMU on its first call
+ * @param  ecd: encoder position of the motor, 0 ~ 8191
+ * @param  output_ecd: the same, multi-turn from get_motor_output_ecd
+ * @param  ecd_to_rad: scale of the motor's encoder angle
+ * @param  imu_angle, imu_rate: gimbal in the IMU frame, rad and rad/s
+ * @retval None
+ */
+static void update_frame_estimate(gimbal_frame_estimate_t *frame, uint16_t ecd, int32_t output_ecd, fp32 ecd_to_rad,
+                                  fp32 imu_angle, fp32 imu_rate){
+    fp32 measured = rad_format(imu_angle - ecd * ecd_to_rad);
+    
+    if (!frame->valid) {
+        frame->angle = measured;
+        frame->rate = 0.0f;
+        frame->valid = 1;
+    } else {
+        fp32 step = (frame->last_imu_rate + imu_rate) * 0.5f * GIMBAL_RATE_LOOP_DT
+                    - (fp32)(output_ecd - frame->last_ecd) * ecd_to_rad;
+        frame->rate += (step / GIMBAL_RATE_LOOP_DT - frame->rate) * (GIMBAL_RATE_LOOP_DT / GIMBAL_FRAME_RATE_TAU);
+        frame->angle = rad_format(frame->angle + step
+                                  + rad_format(measured - frame->angle) * (GIMBAL_RATE_LOOP_DT / GIMBAL_FRAME_ANGLE_TAU));
+    }
+    frame->last_ecd = output_ecd;
+    frame->last_imu_rate = imu_rate;
+}
+
+/** 
+ * @brief  Runs the cascade: the angle loops every GIMBAL_ANGLE_LOOP_DIVIDER calls,
+ *         the rate loops on every call
  * @param  None
  * @retval None
  */
 static void increment_PID(Gimbal_t *gimbal_pid){
-    // error magnitude 1 * ERROR_MULTIPLIER corresponds to gimbal being 90 degrees out of place --> jump action observed by pedram
-    // TODO: consider revising PID to eliminate the ERROR_MULTIPLIER constant
-    
-    fp32 error = get_error_sign(gimbal_pid->yaw_position, gimbal_pid->yaw_setpoint) 
-                    * (1 - a_dot_b(gimbal_pid->yaw_position,gimbal_pid->yaw_setpoint))
-                    * ERROR_MULTIPLIER;
-    
-    // TODO: Consider how this isn't quite a linear error (dot product)
-    gimbal_pid->yaw_motor.voltage_out = PID_Calc(&gimbal_pid->yaw_motor.pid_controller, 0.0f, error);
+    if (gimbal_pid->angle_loop_count == 0) {
+        // Signed angle between position and setpoint, linear in the error unlike 1 - cos
+        gimbal_pid->yaw_error = atan2f(length_of_a_cross_b(gimbal_pid->yaw_position, gimbal_pid->yaw_setpoint),
+                                       a_dot_b(gimbal_pid->yaw_position, gimbal_pid->yaw_setpoint));
+        gimbal_pid->yaw_motor.rate_set = PID_full_calc(&gimbal_pid->yaw_motor.angle_pid, 0.0f, gimbal_pid->yaw_error,
+                                                       gimbal_pid->yaw_set_rate, 0.0f, GIMBAL_ANGLE_LOOP_DT);
+        
+        gimbal_pid->pitch_motor.rate_set = PID_full_calc(&gimbal_pid->pitch_motor.angle_pid,
+                                                         gimbal_pid->pitch_motor.pos_read * MOTOR_ECD_TO_RAD,
+                                                         gimbal_pid->pitch_motor.pos_set * MOTOR_ECD_TO_RAD,
+                                                         0.0f, 0.0f, GIMBAL_ANGLE_LOOP_DT);
+    }
+    gimbal_pid->angle_loop_count = (gimbal_pid->angle_loop_count + 1) % GIMBAL_ANGLE_LOOP_DIVIDER;
     
-    gimbal_pid->pitch_motor.voltage_out = PID_Calc(&gimbal_pid->pitch_motor.pid_controller, gimbal_pid->pitch_motor.pos_read, gimbal_pid->pitch_motor.pos_set);
+    gimbal_pid->yaw_motor.voltage_out = PID_full_calc(&gimbal_pid->yaw_motor.rate_pid, gimbal_pid->yaw_motor.rate_read,
+                                                      gimbal_pid->yaw_motor.rate_set, 0.0f, 0.0f, GIMBAL_RATE_LOOP_DT);
+    gimbal_pid->pitch_motor.voltage_out = PID_full_calc(&gimbal_pid->pitch_motor.rate_pid, gimbal_pid->pitch_motor.rate_read,
+                                                        gimbal_pid->pitch_motor.rate_set, 0.0f, 0.0f, GIMBAL_RATE_LOOP_DT);
     
+    // Go limp on a motor that stopped reporting instead of chasing a stale position,
+    // and start its loops from rest when it comes back
+    if (motor_feedback_is_stale(gimbal_pid->yaw_motor.motor_feedback, GIMBAL_FEEDBACK_TIMEOUT_US)) {
+        gimbal_pid->yaw_motor.voltage_out = 0;
+        PID_full_clear(&gimbal_pid->yaw_motor.angle_pid);
+        PID_full_clear(&gimbal_pid->yaw_motor.rate_pid);
+    }
+    if (motor_feedback_is_stale(gimbal_pid->pitch_motor.motor_feedback, GIMBAL_FEEDBACK_TIMEOUT_US)) {
+        gimbal_pid->pitch_motor.voltage_out = 0;
+        PID_full_clear(&gimbal_pid->pitch_motor.angle_pid);
+        PID_full_clear(&gimbal_pid->pitch_motor.rate_pid);
+    }
 }
 
 /** 
- * @brief  Reads vision instruction from UART and cap to certin values
+ * @brief  Yaw encoder position pointing at the newest vision target, as seen when the
+ *         frame was captured. The gimbal's own motion since then is not accounted for
  * @param  None
- * @retval Vision signal in range of 0 and 8191
+ * @retval Vision signal in range of 0 and 8191, the current position without a live target
  */
 int get_vision_signal(void) {
-    int vision_signal = 5700;  // TODO: Get real values from vision
+    const vision_target_t *target = gimbal.vision_target;
+    int vision_signal = gimbal.yaw_motor.pos_read;
+    
+    if (target != NULL && !vision_target_is_stale(target, GIMBAL_VISION_TIMEOUT_US)
+        && (target->frame.flags & VISION_FLAG_TARGET)) {
+        vision_signal += (int)(target->frame.yaw / GIMBAL_YAW_ECD_TO_RAD);
+    }
         
     while (vision_signal > 8191) {
-        vision_signal -= 8191;
+        vision_signal -= 8192;
     }
     while (vision_signal < 0) {
         vision_signal+= 8192;
@@ -187,36 +392,27 @@ int get_vision_signal(void) {
 }
 
 /** 
- * @brief Updates Uart with position information on the yaw motor and the PID settings
- * This will block for several milliseconds
- * @param gimbal_yaw_motor struct containing information about the gimbal yaw motor
- * @param pid struct containing pid coefficients
- * @param pitch_signal signal to pitch motor
+ * @brief Sends the yaw position and setpoint, the gimbal PID loops and the remote
+ * control state as binary telemetry. Never blocks, each message is rate limited
+ * @param gimbal_msg gimbal struct to report
  * @retval None
  */
 void send_to_uart(Gimbal_t *gimbal_msg) 	
 {
-    static char debug_message[64] = {0};
-    
-    if(loop_counter == 0){
-        sprintf(debug_message, "yaw position re: %.2f im: %.2f \n\r", gimbal_msg->yaw_position[0], gimbal_msg->yaw_position[1]);
-        serial_send_string(debug_message);
-        sprintf(debug_message, "yaw setpoint re: %.2f im: %.2f \n\r", gimbal_msg->yaw_setpoint[0], gimbal_msg->yaw_setpoint[1]);
-        serial_send_string(debug_message);
-        sprintf(debug_message, "--- \n\r");
-        serial_send_string(debug_message);
-        sprintf(debug_message, "pitch: %i", gimbal_msg->pitch_motor.pos_read);
-        serial_send_string(debug_message);
-        
-        // can add a lot more here if you want to
-    }
-    loop_counter = (loop_counter + 1) % 1000;
+    telemetry_gimbal(gimbal_msg->yaw_position, gimbal_msg->yaw_setpoint, gimbal_msg->pitch_motor.pos_read);
+    telemetry_pid_full(TELEMETRY_PID_YAW, &gimbal_msg->yaw_motor.angle_pid);
+    telemetry_pid_full(TELEMETRY_PID_PITCH, &gimbal_msg->pitch_motor.angle_pid);
+    telemetry_pid_full(TELEMETRY_PID_YAW_RATE, &gimbal_msg->yaw_motor.rate_pid);
+    telemetry_pid_full(TELEMETRY_PID_PITCH_RATE, &gimbal_msg->pitch_motor.rate_pid);
+    telemetry_motor(CAN_YAW_MOTOR_ID, gimbal_msg->yaw_motor.motor_feedback);
+    telemetry_motor(CAN_PIT_MOTOR_ID, gimbal_msg->pitch_motor.motor_feedback);
+    telemetry_rc(gimbal_msg->rc_update);
 }
 
+//One table read per component, every encoder state has its own entry
 static void fill_complex_equivalent(fp32 position[2], uint16_t ecd_value){
-    fp32 theta = ecd_value * MOTOR_ECD_TO_RAD;
-    position[0] = cos(theta);
-    position[1] = sin(theta);
+    position[0] = trig_lut_cos_ecd(ecd_value) * TRIG_LUT_Q15_TO_F32;
+    position[1] = trig_lut_sin_ecd(ecd_value) * TRIG_LUT_Q15_TO_F32;
 }
 
 static void multiply_complex_a_by_b(fp32 a[2], fp32 b[2]){
@@ -239,7 +435,3 @@ static fp32 a_dot_b(fp32 a[2], fp32 b[2]){
 static fp32 length_of_a_cross_b(fp32 a[2], fp32 b[2]){
     return a[0] * b[1] - a[1] * b[0];
 }
-
-static int16_t get_error_sign(fp32 actual_position[2], fp32 set_position[2]){
-    return length_of_a_cross_b(actual_position, set_position) >= 0 ? 1 : -1;
-}
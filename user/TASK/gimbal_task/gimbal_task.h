@@ -10,6 +10,9 @@
 #include "pid.h"
 #include "shoot_task.h"
 #include "remote_control.h"
+#include "INS_task.h"
+#include "vision.h"
+#include "aim.h"
 
 /******************************* Task Delays *********************************/
 #define GIMBAL_TASK_DELAY 1
@@ -23,17 +26,64 @@
 
 
 /****************************** PID Constants ********************************/
-#define pid_kp_yaw 250.0f
-#define pid_ki_yaw 0.0f
-#define pid_kd_yaw 250.0f
+// Cascaded control: the angle loop turns the angle error (rad) into a rate setpoint (rad/s),
+// the rate loop turns the rate error, measured by the INS gyro, into a GM6020 voltage.
+// The rate loop runs every gimbal iteration (the 1 kHz IMU rate), the angle loop every
+// GIMBAL_ANGLE_LOOP_DIVIDER iterations
+#define GIMBAL_ANGLE_LOOP_DIVIDER 4
+
+#define pid_kp_yaw_angle 30.0f
+#define pid_ki_yaw_angle 0.0f
+#define pid_kd_yaw_angle 0.0f
+#define max_rate_yaw 12.0f
+#define max_i_term_rate_yaw 2.0f
+
+#define pid_kp_yaw_rate 9000.0f
+#define pid_ki_yaw_rate 90000.0f
+#define pid_kd_yaw_rate 0.0f
 #define max_out_yaw 15000.0f
-#define max_i_term_out_yaw 1000.0f
+#define max_i_term_out_yaw 5000.0f
 
-#define pid_kp_pitch 40.0f
-#define pid_ki_pitch 0.0f
-#define pid_kd_pitch 0.0f
+#define pid_kp_pitch_angle 30.0f
+#define pid_ki_pitch_angle 0.0f
+#define pid_kd_pitch_angle 0.0f
+#define max_rate_pitch 8.0f
+#define max_i_term_rate_pitch 2.0f
+
+#define pid_kp_pitch_rate 3500.0f
+#define pid_ki_pitch_rate 35000.0f
+#define pid_kd_pitch_rate 0.0f
 #define max_out_pitch 5000.0f
-#define max_i_term_out_pitch 1000.0f
+#define max_i_term_out_pitch 3000.0f
+
+// Rate loop feedback: INS gyro axis of each motor, the board sits on the pitch stage.
+// Flip a sign if a positive motor voltage turns the gimbal against the gyro axis
+#define GIMBAL_YAW_GYRO_AXIS INS_GYRO_Z_ADDRESS_OFFSET
+#define GIMBAL_YAW_GYRO_SIGN 1.0f
+#define GIMBAL_PITCH_GYRO_AXIS INS_GYRO_Y_ADDRESS_OFFSET
+#define GIMBAL_PITCH_GYRO_SIGN 1.0f
+
+// World frame hold: with the right switch at GIMBAL_WORLD_FRAME_SWITCH the setpoints are
+// kept in the IMU frame and mapped into encoder coordinates through an estimate of the
+// orientation of the frame each motor sits on (the chassis for yaw). The encoder gives the
+// short term relative angle, the IMU the absolute heading: each iteration the frame turns
+// by the gyro's step minus the encoder's step, and is pulled to the IMU angle minus the
+// encoder angle over GIMBAL_FRAME_ANGLE_TAU to cancel gyro drift. Its rate, the chassis
+// feed-forward of the encoder frame, is the same difference low passed over GIMBAL_FRAME_RATE_TAU
+#define GIMBAL_WORLD_FRAME_SWITCH RC_SW_MID
+#define GIMBAL_FRAME_RATE_TAU 0.02f
+#define GIMBAL_FRAME_ANGLE_TAU 0.5f
+// Flip a sign if an INS angle grows against the encoder of its motor
+#define GIMBAL_YAW_IMU_AXIS INS_YAW_ADDRESS_OFFSET
+#define GIMBAL_YAW_IMU_SIGN 1.0f
+#define GIMBAL_PITCH_IMU_AXIS INS_PITCH_ADDRESS_OFFSET
+#define GIMBAL_PITCH_IMU_SIGN 1.0f
+
+// Vision aiming: in the world frame, holding the right mouse button hands both setpoints
+// to the target predictor (APP/aim) while it has a track. The predictor's aim and yaw rate
+// are in INS angles, mapped through the IMU signs above. Constant acceleration follows
+// strafing robots through the lead time better, see host/sim/aim_replay.c
+#define GIMBAL_AIM_MODEL AIM_MODEL_CA
 
 /***************************** Gimbal Constants *****************************/
 #define GIMBAL_TASK_INIT_TIME 300
@@ -44,11 +94,32 @@
 #define ENCODER_MAX 8191
 #define PITCH_MIN 2020
 #define PITCH_MAX 3000
-#define ERROR_MULTIPLIER 2048
 #define GIMBAL_PITCH_INITIAL_POSITION 3000
+//Motors whose last CAN frame is older than this are not driven
+#define GIMBAL_FEEDBACK_TIMEOUT_US 20000
+//Vision targets older than this are ignored
+#define GIMBAL_VISION_TIMEOUT_US 100000
 
 
 /************************** Gimbal Data Structures ***************************/
+typedef enum
+{
+    GIMBAL_FRAME_ENCODER = 0,   // setpoints relative to the chassis
+    GIMBAL_FRAME_WORLD,         // setpoints in the IMU frame
+} gimbal_frame_e;
+
+// Orientation of the frame a gimbal motor is mounted on, seen from the IMU:
+// IMU angle = encoder angle + angle
+typedef struct
+{
+    fp32 angle;     // rad, -PI ~ PI
+    fp32 rate;      // rad/s
+    uint8_t valid;  // 0 until the first update
+    // Previous multi-turn encoder position and gyro rate
+    int32_t last_ecd;
+    fp32 last_imu_rate;
+} gimbal_frame_estimate_t;
+
 typedef struct 
 {
 	const motor_feedback_t *motor_feedback;
@@ -59,7 +130,16 @@ typedef struct
     int16_t pos_set;
     int16_t voltage_out;
 
-    PidTypeDef pid_controller;
+    // Rate loop input, rad/s from the INS gyro, and the angle loop's output
+    fp32 rate_read;
+    fp32 rate_set;
+
+    PidFullTypeDef angle_pid;
+    PidFullTypeDef rate_pid;
+
+    // Frame the motor sits on, and the world frame setpoint (rad) of the pitch motor
+    gimbal_frame_estimate_t frame;
+    fp32 world_set;
 } Gimbal_Motor_t;
 
 typedef struct 
@@ -70,11 +150,22 @@ typedef struct
     const fp32 *angle_update;
 	const fp32 *gyro_update;
 	const fp32 *accel_update;
+    const fp32 *quat_update;
+    // Newest vision frame, read in place from the receiver's triple buffer
+    const vision_target_t *vision_target;
+    // Target track in the world frame and where it says to point this iteration
+    aim_predictor_t aim;
+    aim_solution_t aim_solution;
+    uint8_t aiming;
     // TODO: Add gimbal angles when we care about orientation of robot in 3-d space
     
-    fp32 yaw_setpoint[2]; // {real, imaj}
+    gimbal_frame_e frame_mode;
+    fp32 yaw_world_setpoint[2]; // {real, imaj}, IMU frame, followed in GIMBAL_FRAME_WORLD
+    fp32 yaw_setpoint[2]; // {real, imaj}, encoder frame, what the angle loop tracks
     fp32 yaw_position[2]; // {real, imaj}
-    fp32 yaw_error;
+    fp32 yaw_error;     // rad, setpoint minus position
+    fp32 yaw_set_rate;  // rad/s the RC moves the setpoint at, angle loop feed-forward
+    uint8_t angle_loop_count;
     
     Shoot_t *launcher;
 } Gimbal_t;
@@ -83,6 +174,8 @@ typedef struct
 /******************************* Function Declarations ***********************/
 int get_vision_signal(void);
 extern void gimbal_task(void *pvParameters);
+extern void gimbal_task_init(void);
+extern void gimbal_task_loop(void);
 extern void send_to_uart(Gimbal_t *gimbal); 
 
 
@@ -15,7 +15,6 @@
 
 #include "shoot_task.h"
 #include "main.h"
-#include "stm32f4xx.h"
 
 #include "FreeRTOSConfig.h"
 #include "FreeRTOS.h"
@@ -25,11 +24,13 @@
 /******************** User Includes ********************/
 
 #include "remote_control.h"
-#include "CAN_Receive.h"
+#include "CAN_receive.h"
+#include "control_tick.h"
+#include "profiler.h"
 #include "user_lib.h"
 #include "fric.h"
-#include "USART_comms.h"
-#include "PID.h"
+#include "telemetry.h"
+#include "pid.h"
 
 Shoot_t shoot;
 
@@ -44,7 +45,12 @@ static void get_new_data(void);
 // user defines
 static uint16_t pwm_target = Fric_OFF;
 static uint16_t pwm_output = Fric_OFF;
-static PidTypeDef trigger_motor_pid;   
+#if PID_FIXED_POINT
+//Bank of one, the fixed point controller only comes as a bank
+static PidBankQTypeDef trigger_motor_pid;
+#else
+static PidTypeDef trigger_motor_pid;
+#endif   
 
 static uint16_t shoot_count = 0;
 #define SHOOT_COUNT_MAX 1250
@@ -58,31 +64,62 @@ static uint16_t shoot_count = 0;
  * @retval None
  */
 void shoot_task(void *pvParameters) {
-    shoot_init(&shoot);
+    shoot_task_init();
     vTaskDelay(SHOOT_INIT_DELAY);
+    control_tick_register_task(CONTROL_TICK_SHOOT, xTaskGetCurrentTaskHandle(), SHOOT_TASK_DELAY);
     while(1) {
-        get_new_data();
-        set_control_mode();
-        //Handle trigger motor
-        shoot.hopper_motor.speed_out = shoot.hopper_motor.speed_set;
-        shoot.trigger_motor.speed_out = PID_Calc(&trigger_motor_pid, shoot.trigger_motor.speed_raw, shoot.trigger_motor.speed_set);
-
-        //Ramping...
-        if (pwm_output < pwm_target) {
-            pwm_output += 1;
-        } else if (pwm_output > pwm_target) {
-            pwm_output -= 1;
-        }
-        
-        //Set pwm field to the ramp results
-        shoot.fric1_pwm = pwm_output;
-        shoot.fric2_pwm = pwm_output;
-        
-        //Set flywheels
-        fric1_on(shoot.fric1_pwm);
-        fric2_on(shoot.fric2_pwm);  
-        vTaskDelay(SHOOT_TASK_DELAY);
+        control_tick_wait(CONTROL_TICK_SHOOT);
+        profiler_loop_start(PROFILER_LOOP_SHOOT);
+        shoot_task_loop();
+        profiler_loop_end(PROFILER_LOOP_SHOOT);
+    }
+}
+
+
+/**
+ * @brief Initializes the launcher, split out of shoot_task so it can run without FreeRTOS
+ * @param None
+ * @retval None
+ */
+void shoot_task_init(void) {
+    shoot_init(&shoot);
+}
+
+
+/**
+ * @brief One launcher iteration: set the mode from RC, run the trigger PID and ramp the flywheels
+ * @param None
+ * @retval None
+ */
+void shoot_task_loop(void) {
+    get_new_data();
+    set_control_mode();
+    //Handle trigger motor
+    shoot.hopper_motor.speed_out = shoot.hopper_motor.speed_set;
+#if PID_FIXED_POINT
+    int32_t trigger_ref = shoot.trigger_motor.speed_raw, trigger_set = shoot.trigger_motor.speed_set;
+    PID_bank_q_calc(&trigger_motor_pid, &trigger_ref, &trigger_set);
+    shoot.trigger_motor.speed_out = PID_Q_TO_INT(trigger_motor_pid.out[0]);
+    telemetry_pid_bank_q(TELEMETRY_PID_TRIGGER, &trigger_motor_pid, 0);
+#else
+    shoot.trigger_motor.speed_out = PID_Calc(&trigger_motor_pid, shoot.trigger_motor.speed_raw, shoot.trigger_motor.speed_set);
+    telemetry_pid(TELEMETRY_PID_TRIGGER, &trigger_motor_pid);
+#endif
+
+    //Ramping...
+    if (pwm_output < pwm_target) {
+        pwm_output += 1;
+    } else if (pwm_output > pwm_target) {
+        pwm_output -= 1;
     }
+    
+    //Set pwm field to the ramp results
+    shoot.fric1_pwm = pwm_output;
+    shoot.fric2_pwm = pwm_output;
+    
+    //Set flywheels
+    fric1_on(shoot.fric1_pwm);
+    fric2_on(shoot.fric2_pwm);  
 }
 
 
@@ -101,6 +138,8 @@ Shoot_t* get_launcher_pointer(void) {
 static void shoot_init(Shoot_t *shoot_init) {
     // Get RC pointers
     shoot_init->rc = get_remote_control_point();
+    shoot_init->trigger_motor.shoot_motor_raw = get_trigger_motor_feedback_pointer();
+    shoot_init->hopper_motor.shoot_motor_raw = get_hopper_motor_feedback_pointer();
 
     // Deal with weird starting of the motors
     shoot_init->fric1_pwm = Fric_INIT;
@@ -110,8 +149,14 @@ static void shoot_init(Shoot_t *shoot_init) {
     fric2_on(shoot.fric2_pwm);
     
     //Init PID for hopper and trigger motors
+#if PID_FIXED_POINT
+    static const int32_t Trigger_speed_pid[3] = {PID_Q_CONST(TRIGGER_ANGLE_PID_KP), PID_Q_CONST(TRIGGER_ANGLE_PID_KI),
+                                                 PID_Q_CONST(TRIGGER_ANGLE_PID_KD)};
+    PID_bank_q_init(&trigger_motor_pid, 1, Trigger_speed_pid, PID_Q_CONST(TRIGGER_MAX_OUT), PID_Q_CONST(TRIGGER_MAX_IOUT));
+#else
     static const fp32 Trigger_speed_pid[3] = {TRIGGER_ANGLE_PID_KP, TRIGGER_ANGLE_PID_KI, TRIGGER_ANGLE_PID_KD};
     PID_Init(&trigger_motor_pid, PID_POSITION, Trigger_speed_pid, TRIGGER_MAX_OUT, TRIGGER_MAX_IOUT);
+#endif
 }
 
 
@@ -158,35 +203,24 @@ static void set_control_mode(void) {
 
 
 /**
- * @brief Update data in the shoot struct. Handles the 36:1 gear ratio in p36. 
- *   This function is commented out temporarily because it's not tested and not high priority before MT video
+ * @brief Update data in the shoot struct from the feedback latched at this tick. The 36:1
+ *   gearbox of the P36 is unwrapped by CAN_receive, geared_down_pos_raw is the trigger shaft.
  * @param None
  * @retval None
  */
 static void get_new_data(void) {
-    /*
-    //Accounts for gear box inside P19 
-    if (shoot.trigger_motor.pos_raw - shoot.trigger_motor.last_pos_raw > HALF_ECD_RANGE)
-    {
-        //Encoder reading went from 0 to 8192, finished one circle counterclockwise
-        shoot.trigger_motor.ecd_count--;
-    }
-    else if (shoot.trigger_motor.pos_raw - shoot.trigger_motor.last_pos_raw < -HALF_ECD_RANGE)
-    {
-        //Encoder reading went from 8192 to 0, finished one circle clockwise
-        shoot.trigger_motor.ecd_count++;
-    }
-    //Gear ratio of 36:1
-    if (shoot.trigger_motor.ecd_count == HALF_TRIGGER_RATIO)
-    {
-        shoot.trigger_motor.ecd_count = -(HALF_TRIGGER_RATIO - 1);
-    }
-    else if (shoot.trigger_motor.ecd_count == -HALF_TRIGGER_RATIO)
-    {
-        shoot.trigger_motor.ecd_count = HALF_TRIGGER_RATIO - 1;
-    }
-    shoot.trigger_motor.geared_down_pos_raw = (shoot.trigger_motor.ecd_count * FULL_ECD_RANGE + shoot.trigger_motor.pos_raw) / FULL_TRIGGER_RATIO;
-    */
+    motor_feedback_t feedback;
+
+    get_motor_feedback_latched(shoot.trigger_motor.shoot_motor_raw, &feedback);
+    shoot.trigger_motor.last_pos_raw = shoot.trigger_motor.pos_raw;
+    shoot.trigger_motor.pos_raw = feedback.ecd;
+    shoot.trigger_motor.speed_raw = feedback.speed_filtered_rpm;
+    shoot.trigger_motor.geared_down_pos_raw = get_motor_output_ecd(&feedback);
+
+    get_motor_feedback_latched(shoot.hopper_motor.shoot_motor_raw, &feedback);
+    shoot.hopper_motor.last_pos_raw = shoot.hopper_motor.pos_raw;
+    shoot.hopper_motor.pos_raw = feedback.ecd;
+    shoot.hopper_motor.speed_raw = feedback.speed_filtered_rpm;
 }
 
 /**
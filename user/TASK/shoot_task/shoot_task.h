@@ -8,7 +8,6 @@
 **/
 
 #include "main.h"
-#include "stm32f4xx.h"
 #include "remote_control.h"
 #include "fric.h"
 #include "user_lib.h"
@@ -44,10 +43,6 @@
 
 //Trigger motor
 #define TRIGGER_90_DEGS 2048
-#define HALF_ECD_RANGE 4096
-#define FULL_ECD_RANGE 8192
-#define HALF_TRIGGER_RATIO 18
-#define FULL_TRIGGER_RATIO 36
 #define TRIGGER_REACHED_POS_RANGE 500
 #define TRIGGER_SPEED -400
 #define TRIGGER_OFF 0
@@ -64,9 +59,9 @@ typedef struct
     int16_t speed_out;
     
     //Variables used by the trigger motor only
-    int8_t ecd_count;
-    uint16_t geared_down_pos_raw;
-    uint16_t geared_down_pos_set;
+    //Multi-turn output shaft position after the P36 gearbox, MOTOR_ECD_RANGE per turn
+    int32_t geared_down_pos_raw;
+    int32_t geared_down_pos_set;
     uint8_t move_flag;
     uint16_t cmd_time;
 }Shoot_Motor_t;
@@ -94,6 +89,8 @@ typedef struct
 
 }Shoot_t;
 extern void shoot_task(void *pvParameters);
+extern void shoot_task_init(void);
+extern void shoot_task_loop(void);
 extern Shoot_t* get_launcher_pointer(void);
 #endif
 
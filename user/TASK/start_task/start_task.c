@@ -11,6 +11,8 @@
 #include "INS_task.h"
 #include "chassis_task.h"
 #include "gimbal_task.h"
+#include "vision_task.h"
+#include "task_monitor.h"
 
 
 #define START_TASK_PRIO 1
@@ -31,11 +33,10 @@ static TaskHandle_t shoot_task_handler;
 #define GIMBAL_TASK_PRIO 4
 #define GIMBAL_STK_SIZE 512
 static TaskHandle_t gimbal_task_handler;
-/*
-#define VISION_TASK_PRIO 5
-#define VISION_STK_SIZE 512
+#define VISION_TASK_PRIO 2
+#define VISION_STK_SIZE 128
 static TaskHandle_t vision_task_handler;
-*/
+
 void start_task(void *pvParameters)
 {
     taskENTER_CRITICAL();
@@ -67,6 +68,15 @@ void start_task(void *pvParameters)
             (void *)NULL,
             (UBaseType_t)GIMBAL_TASK_PRIO,
             (TaskHandle_t *)&gimbal_task_handler);
+
+    xTaskCreate((TaskFunction_t) vision_task,
+            (const char *)"vision_task",
+            (uint16_t) VISION_STK_SIZE,
+            (void *)NULL,
+            (UBaseType_t)VISION_TASK_PRIO,
+            (TaskHandle_t *)&vision_task_handler);
+
+    task_monitor_init();
             
 
     vTaskDelete(start_task_handler); //Delete start task
@@ -1,7 +1,15 @@
+/**
+  ******************************************************************************
+    * @file    TASK/vision_task
+    * @date    16-October-2026
+    * @brief   Watches the vision PC link. Frames are received and published by the
+    *          USART6 interrupt in APP/vision, this only logs the link coming and
+    *          going with the receive counters, so a bad cable or baud rate shows
+    *          up in the trace.
+  ******************************************************************************
+**/
+
 #include "vision_task.h"
-#include "main.h"
-#include "stm32f4xx.h"
-#include <stdio.h>
 
 #include "FreeRTOSConfig.h"
 #include "FreeRTOS.h"
@@ -9,23 +17,25 @@
 
 
 /******************** User Includes ********************/
-#include "CAN_Receive.h"
-#include "delay.h"
-#include "USART_comms.h"
-#include "pid.h"
-
+#include "vision.h"
+#include "trace.h"
 
-//The following three things are declared as extern variables because:
-//If you declare the same varaible name, the program will not compile.
-//I am too lazy to rename everything. 
-//But of course you want a new mailbox and a new gimbal "object", at least to test on
-//TLDR: rename these variables
 
 /******************** Task/Functions Called Outside ********************/
 
 void vision_task(void *pvParameters){
-	  while(1) {
-          vTaskDelay(200);
-        // todo
-      }
+    vision_stats_t stats;
+    uint32_t last_frames = 0;
+    uint8_t link_up = 0;
+
+    while(1) {
+        vTaskDelay(VISION_TASK_DELAY);
+        get_vision_stats(&stats);
+        if ((stats.frames != last_frames) != link_up) {
+            link_up = !link_up;
+            TRACE("vision link up %u: %u frames, %u crc errors, %u junk bytes, %u lost by seq",
+                  link_up, stats.frames, stats.crc_errors, stats.junk_bytes, stats.seq_gaps);
+        }
+        last_frames = stats.frames;
+    }
 }
@@ -1,5 +1,9 @@
 #ifndef VISION_TASK_H
 #define VISION_TASK_H
+#include "main.h"
+
+//Link check period, the vision PC counts as gone after a whole period without a good frame
+#define VISION_TASK_DELAY 200
 
 extern void vision_task(void *pvParameters);
 
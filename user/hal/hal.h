@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+    * @file    hal/hal
+    * @date    16-October-2026
+    * @brief   Thin hardware abstraction layer between the APP/TASK code and the
+    *          peripherals. Only the runtime operations used by the control loops
+    *          live here (CAN frames, UART bytes, PWM compare values, SPI bytes,
+    *          timer update flags); peripheral configuration stays in hardware/.
+    * @attention hal_stm32f4.c is the target backend built on FWLIB. The host
+    *          (Linux) build links host/hal_host.c instead, so nothing above this
+    *          layer may include stm32f4xx.h.
+  ******************************************************************************
+**/
+
+#ifndef HAL_H
+#define HAL_H
+#include "main.h"
+
+
+/******************** Memory ordering ********************/
+
+//Keeps the compiler and the core from reordering memory accesses across this point.
+//Used by the lock-free structures shared between interrupts and tasks
+#if defined(HOST_BUILD)
+#define hal_memory_barrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define hal_memory_barrier() __dmb(0xF)
+#endif
+
+//Masks every maskable interrupt and returns the previous mask for hal_irq_restore. Unlike
+//taskENTER_CRITICAL this also holds off the CAN interrupts, which sit above
+//configMAX_SYSCALL_INTERRUPT_PRIORITY. Safe to nest and to call from interrupts
+extern uint32_t hal_irq_disable(void);
+extern void hal_irq_restore(uint32_t state);
+
+
+/******************** CAN ********************/
+
+typedef enum
+{
+    HAL_CAN1 = 0,
+    HAL_CAN2,
+    HAL_CAN_NUM,
+} hal_can_e;
+
+//Receive FIFOs, each with its own interrupt
+typedef enum
+{
+    HAL_CAN_FIFO0 = 0,
+    HAL_CAN_FIFO1,
+    HAL_CAN_FIFO_NUM,
+} hal_can_fifo_e;
+
+//Standard-ID data frame, the only kind of frame the RM motors use
+typedef struct
+{
+    uint32_t std_id;
+    uint8_t dlc;
+    uint8_t data[8];
+} hal_can_frame_t;
+
+//Returned by hal_can_transmit when every TX mailbox is busy
+#define HAL_CAN_NO_MAILBOX 0x04
+
+//Queues a frame into a free TX mailbox, returns the mailbox number or HAL_CAN_NO_MAILBOX
+extern uint8_t hal_can_transmit(hal_can_e can, const hal_can_frame_t *frame);
+//Enables or disables the TX mailbox empty interrupt
+extern void hal_can_tx_irq_enable(hal_can_e can, uint8_t enable);
+//Called from the TX interrupt, clears the request completed flags of every mailbox
+extern void hal_can_tx_irq_ack(hal_can_e can);
+//Called from the RX0/RX1 interrupt, returns 1 and fills frame if a message was pending in the FIFO
+extern uint8_t hal_can_receive(hal_can_e can, hal_can_fifo_e fifo, hal_can_frame_t *frame);
+//Returns 1 and clears the flag if the FIFO overran (a frame was lost) since the last call
+extern uint8_t hal_can_fifo_overrun(hal_can_e can, hal_can_fifo_e fifo);
+
+//Filter banks per bus, CAN1 owns banks 0 ~ 13 and CAN2 banks 14 ~ 27
+#define HAL_CAN_FILTER_BANKS 14
+
+//One bxCAN filter bank in 16-bit scale, reg[] holds filter register halves (STDID << 5 | RTR | IDE):
+//list mode: four IDs; mask mode: two pairs {reg[0] id, reg[1] mask} and {reg[2] id, reg[3] mask}
+typedef struct
+{
+    uint8_t mask_mode;
+    uint8_t fifo;       //0 or 1
+    uint16_t reg[4];
+} hal_can_filter_bank_t;
+
+//Replaces every filter bank of a bus, banks past bank_num are disabled. Stalls reception while it runs
+extern void hal_can_set_filters(hal_can_e can, const hal_can_filter_bank_t *banks, uint8_t bank_num);
+
+
+/******************** UART ********************/
+
+typedef enum
+{
+    HAL_USART1 = 0,     //DBUS remote control, RX only
+    HAL_USART6,         //Debug/vision serial port
+    HAL_UART_NUM,
+} hal_uart_e;
+
+//Blocks until the previous byte has left the shift register, then sends one byte
+extern void hal_uart_send_byte(hal_uart_e uart, uint8_t byte);
+//Starts a DMA transfer of len bytes from buf, returns 0 if the previous transfer is still
+//running. buf must stay untouched until hal_uart_dma_tx_done reports the end of the transfer
+extern uint8_t hal_uart_dma_tx(hal_uart_e uart, const uint8_t *buf, uint16_t len);
+//Called from the TX DMA stream interrupt, returns 1 and clears the flag if the transfer completed
+extern uint8_t hal_uart_dma_tx_done(hal_uart_e uart);
+//Called from the TX DMA stream interrupt, returns 1 and clears the flag if the transfer stopped
+//on a bus error. The stream has disabled itself, so a new transfer can be started right away
+extern uint8_t hal_uart_dma_tx_error(hal_uart_e uart);
+//Called from the UART interrupt of a double buffered DMA receiver. On an IDLE line event,
+//swaps the DMA target buffer and returns 1 with the index of the buffer just filled and its length
+extern uint8_t hal_uart_dma_rx_idle(hal_uart_e uart, uint16_t dma_buf_num, uint8_t *buf_index, uint16_t *rx_len);
+
+
+/******************** PWM ********************/
+
+typedef enum
+{
+    HAL_PWM_FRIC1 = 0,  //TIM1 CH1, PA8
+    HAL_PWM_FRIC2,      //TIM1 CH4, PE14
+    HAL_PWM_IMU_HEAT,   //TIM3 CH2, PB5
+    HAL_PWM_NUM,
+} hal_pwm_e;
+
+extern void hal_pwm_set(hal_pwm_e channel, uint16_t compare);
+
+
+/******************** SPI ********************/
+
+typedef enum
+{
+    HAL_SPI5 = 0,       //MPU6500 + IST8310
+    HAL_SPI_NUM,
+} hal_spi_e;
+
+//Full duplex single byte exchange, returns 0 on timeout
+extern uint8_t hal_spi_read_write_byte(hal_spi_e spi, uint8_t tx_data);
+
+
+/******************** Timers ********************/
+
+typedef enum
+{
+    HAL_TIMER_CAN_DELAY = 0,    //TIM6, delayed gimbal CAN send
+    HAL_TIMER_CONTROL_TICK,     //TIM4, control tick (update) and command transmit phase (CC1)
+    HAL_TIMER_NUM,
+} hal_timer_e;
+
+//Restarts the timer from 0 with a new auto-reload value
+extern void hal_timer_start(hal_timer_e timer, uint32_t period);
+extern void hal_timer_stop(hal_timer_e timer);
+//Called from the timer interrupt, returns 1 and clears the flag if an update event is pending
+extern uint8_t hal_timer_update_flag(hal_timer_e timer);
+//Sets the channel 1 compare value, only for timers with capture/compare channels
+extern void hal_timer_set_compare(hal_timer_e timer, uint32_t compare);
+//Called from the timer interrupt, returns 1 and clears the flag if channel 1 matched
+extern uint8_t hal_timer_compare_flag(hal_timer_e timer);
+
+
+/******************** Cycle counter ********************/
+
+//Core clock, the rate hal_cycle_count runs at. The count wraps every ~23.8 s
+#define HAL_CYCLE_HZ 180000000u
+#define HAL_CYCLES_PER_US (HAL_CYCLE_HZ / 1000000u)
+
+//Starts the free running cycle counter (DWT->CYCCNT on target), call once before the scheduler
+extern void hal_cycle_counter_init(void);
+extern uint32_t hal_cycle_count(void);
+
+#endif
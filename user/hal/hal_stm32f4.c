@@ -0,0 +1,331 @@
+/**
+  ******************************************************************************
+    * @file    hal/hal_stm32f4
+    * @date    16-October-2026
+    * @brief   STM32F427 backend of the hardware abstraction layer, built on FWLIB.
+    * @attention The peripherals must already be configured by the init functions
+    *          in hardware/ (CAN1_mode_init, RC_Init, fric_PWM_configuration, ...).
+  ******************************************************************************
+**/
+
+#include "hal.h"
+#include "stm32f4xx.h"
+
+//Peripheral lookup tables, indexed by the HAL enums
+static CAN_TypeDef *const can_periph[HAL_CAN_NUM] = {CAN1, CAN2};
+static const uint8_t can_fifo[HAL_CAN_FIFO_NUM] = {CAN_FIFO0, CAN_FIFO1};
+static const uint32_t can_fifo_overrun_flag[HAL_CAN_FIFO_NUM] = {CAN_FLAG_FOV0, CAN_FLAG_FOV1};
+static USART_TypeDef *const uart_periph[HAL_UART_NUM] = {USART1, USART6};
+static DMA_Stream_TypeDef *const uart_rx_dma_stream[HAL_UART_NUM] = {DMA2_Stream2, DMA2_Stream1};
+static const uint32_t uart_rx_dma_flags[HAL_UART_NUM] = {DMA_FLAG_TCIF2 | DMA_FLAG_HTIF2, DMA_FLAG_TCIF1 | DMA_FLAG_HTIF1};
+static DMA_Stream_TypeDef *const uart_tx_dma_stream[HAL_UART_NUM] = {NULL, DMA2_Stream6};
+static const uint32_t uart_tx_dma_flags[HAL_UART_NUM] = {0, DMA_FLAG_TCIF6 | DMA_FLAG_HTIF6 | DMA_FLAG_TEIF6 | DMA_FLAG_DMEIF6 | DMA_FLAG_FEIF6};
+static const uint32_t uart_tx_dma_tc_it[HAL_UART_NUM] = {0, DMA_IT_TCIF6};
+static const uint32_t uart_tx_dma_te_it[HAL_UART_NUM] = {0, DMA_IT_TEIF6};
+static SPI_TypeDef *const spi_periph[HAL_SPI_NUM] = {SPI5};
+static TIM_TypeDef *const timer_periph[HAL_TIMER_NUM] = {TIM6, TIM4};
+
+
+/******************** Interrupt masking ********************/
+
+uint32_t hal_irq_disable(void)
+{
+    uint32_t state = __get_PRIMASK();
+    __disable_irq();
+    return state;
+}
+
+void hal_irq_restore(uint32_t state)
+{
+    __set_PRIMASK(state);
+}
+
+
+/******************** CAN ********************/
+
+uint8_t hal_can_transmit(hal_can_e can, const hal_can_frame_t *frame)
+{
+    CanTxMsg tx_message;
+    tx_message.StdId = frame->std_id;
+    tx_message.IDE = CAN_ID_STD;
+    tx_message.RTR = CAN_RTR_DATA;
+    tx_message.DLC = frame->dlc;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        tx_message.Data[i] = frame->data[i];
+    }
+
+    uint8_t mailbox = CAN_Transmit(can_periph[can], &tx_message);
+    return mailbox == CAN_TxStatus_NoMailBox ? HAL_CAN_NO_MAILBOX : mailbox;
+}
+
+void hal_can_tx_irq_enable(hal_can_e can, uint8_t enable)
+{
+    CAN_ITConfig(can_periph[can], CAN_IT_TME, enable ? ENABLE : DISABLE);
+}
+
+void hal_can_tx_irq_ack(hal_can_e can)
+{
+    //Clears RQCP0 ~ RQCP2
+    CAN_ClearITPendingBit(can_periph[can], CAN_IT_TME);
+}
+
+uint8_t hal_can_receive(hal_can_e can, hal_can_fifo_e fifo, hal_can_frame_t *frame)
+{
+    CanRxMsg rx_message;
+
+    //FMP counts the pending frames, CAN_Receive releases the one it reads
+    if (CAN_MessagePending(can_periph[can], can_fifo[fifo]) == 0)
+    {
+        return 0;
+    }
+
+    CAN_Receive(can_periph[can], can_fifo[fifo], &rx_message);
+
+    frame->std_id = rx_message.StdId;
+    frame->dlc = rx_message.DLC;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        frame->data[i] = rx_message.Data[i];
+    }
+    return 1;
+}
+
+uint8_t hal_can_fifo_overrun(hal_can_e can, hal_can_fifo_e fifo)
+{
+    if (CAN_GetFlagStatus(can_periph[can], can_fifo_overrun_flag[fifo]) == RESET)
+    {
+        return 0;
+    }
+    CAN_ClearFlag(can_periph[can], can_fifo_overrun_flag[fifo]);
+    return 1;
+}
+
+
+void hal_can_set_filters(hal_can_e can, const hal_can_filter_bank_t *banks, uint8_t bank_num)
+{
+    CAN_FilterInitTypeDef filter;
+    uint8_t first_bank = can == HAL_CAN1 ? 0 : HAL_CAN_FILTER_BANKS;
+
+    CAN_SlaveStartBank(HAL_CAN_FILTER_BANKS);
+    for (uint8_t i = 0; i < HAL_CAN_FILTER_BANKS; i++)
+    {
+        filter.CAN_FilterNumber = first_bank + i;
+        filter.CAN_FilterScale = CAN_FilterScale_16bit;
+        if (i < bank_num)
+        {
+            //FR1 = {reg[1], reg[0]}, FR2 = {reg[3], reg[2]}
+            filter.CAN_FilterMode = banks[i].mask_mode ? CAN_FilterMode_IdMask : CAN_FilterMode_IdList;
+            filter.CAN_FilterIdLow = banks[i].reg[0];
+            filter.CAN_FilterMaskIdLow = banks[i].reg[1];
+            filter.CAN_FilterIdHigh = banks[i].reg[2];
+            filter.CAN_FilterMaskIdHigh = banks[i].reg[3];
+            filter.CAN_FilterFIFOAssignment = banks[i].fifo ? CAN_Filter_FIFO1 : CAN_Filter_FIFO0;
+            filter.CAN_FilterActivation = ENABLE;
+        }
+        else
+        {
+            filter.CAN_FilterMode = CAN_FilterMode_IdList;
+            filter.CAN_FilterIdLow = 0;
+            filter.CAN_FilterMaskIdLow = 0;
+            filter.CAN_FilterIdHigh = 0;
+            filter.CAN_FilterMaskIdHigh = 0;
+            filter.CAN_FilterFIFOAssignment = CAN_Filter_FIFO0;
+            filter.CAN_FilterActivation = DISABLE;
+        }
+        CAN_FilterInit(&filter);
+    }
+}
+
+
+/******************** UART ********************/
+
+void hal_uart_send_byte(hal_uart_e uart, uint8_t byte)
+{
+    while (USART_GetFlagStatus(uart_periph[uart], USART_FLAG_TC) == RESET);
+    USART_SendData(uart_periph[uart], byte);
+}
+
+uint8_t hal_uart_dma_tx(hal_uart_e uart, const uint8_t *buf, uint16_t len)
+{
+    DMA_Stream_TypeDef *stream = uart_tx_dma_stream[uart];
+
+    //The stream disables itself at the end of a normal mode transfer
+    if (stream == NULL || DMA_GetCmdStatus(stream) == ENABLE)
+    {
+        return 0;
+    }
+    DMA_ClearFlag(stream, uart_tx_dma_flags[uart]);
+    stream->M0AR = (uint32_t)buf;
+    DMA_SetCurrDataCounter(stream, len);
+    DMA_Cmd(stream, ENABLE);
+    return 1;
+}
+
+uint8_t hal_uart_dma_tx_done(hal_uart_e uart)
+{
+    DMA_Stream_TypeDef *stream = uart_tx_dma_stream[uart];
+
+    if (stream == NULL || DMA_GetITStatus(stream, uart_tx_dma_tc_it[uart]) == RESET)
+    {
+        return 0;
+    }
+    DMA_ClearITPendingBit(stream, uart_tx_dma_tc_it[uart]);
+    return 1;
+}
+
+uint8_t hal_uart_dma_tx_error(hal_uart_e uart)
+{
+    DMA_Stream_TypeDef *stream = uart_tx_dma_stream[uart];
+
+    if (stream == NULL || DMA_GetITStatus(stream, uart_tx_dma_te_it[uart]) == RESET)
+    {
+        return 0;
+    }
+    DMA_ClearITPendingBit(stream, uart_tx_dma_te_it[uart]);
+    return 1;
+}
+
+uint8_t hal_uart_dma_rx_idle(hal_uart_e uart, uint16_t dma_buf_num, uint8_t *buf_index, uint16_t *rx_len)
+{
+    USART_TypeDef *usart = uart_periph[uart];
+    DMA_Stream_TypeDef *stream = uart_rx_dma_stream[uart];
+
+    if (USART_GetITStatus(usart, USART_IT_RXNE) != RESET)
+    {
+        USART_ReceiveData(usart);
+        return 0;
+    }
+    if (stream == NULL || USART_GetITStatus(usart, USART_IT_IDLE) == RESET)
+    {
+        return 0;
+    }
+
+    //Reading DR after SR clears the IDLE flag
+    USART_ReceiveData(usart);
+
+    //Stop the stream, then point it at the other buffer so the one just filled can be parsed
+    DMA_Cmd(stream, DISABLE);
+    *rx_len = dma_buf_num - DMA_GetCurrDataCounter(stream);
+    DMA_SetCurrDataCounter(stream, dma_buf_num);
+    if (DMA_GetCurrentMemoryTarget(stream) == 0)
+    {
+        *buf_index = 0;
+        stream->CR |= DMA_SxCR_CT;
+    }
+    else
+    {
+        *buf_index = 1;
+        stream->CR &= ~(DMA_SxCR_CT);
+    }
+    DMA_ClearFlag(stream, uart_rx_dma_flags[uart]);
+    DMA_Cmd(stream, ENABLE);
+    return 1;
+}
+
+
+/******************** PWM ********************/
+
+void hal_pwm_set(hal_pwm_e channel, uint16_t compare)
+{
+    switch (channel)
+    {
+    case HAL_PWM_FRIC1:
+        TIM_SetCompare1(TIM1, compare);
+        break;
+    case HAL_PWM_FRIC2:
+        TIM_SetCompare4(TIM1, compare);
+        break;
+    case HAL_PWM_IMU_HEAT:
+        TIM_SetCompare2(TIM3, compare);
+        break;
+    default:
+        break;
+    }
+}
+
+
+/******************** SPI ********************/
+
+uint8_t hal_spi_read_write_byte(hal_spi_e spi, uint8_t tx_data)
+{
+    SPI_TypeDef *spix = spi_periph[spi];
+    uint8_t retry = 0;
+    while (SPI_I2S_GetFlagStatus(spix, SPI_I2S_FLAG_TXE) == RESET)
+    {
+        retry++;
+        if (retry > 200)
+        {
+            return 0;
+        }
+    }
+
+    SPI_I2S_SendData(spix, tx_data);
+
+    retry = 0;
+    while (SPI_I2S_GetFlagStatus(spix, SPI_I2S_FLAG_RXNE) == RESET)
+    {
+        retry++;
+        if (retry > 200)
+        {
+            return 0;
+        }
+    }
+
+    return SPI_I2S_ReceiveData(spix);
+}
+
+
+/******************** Timers ********************/
+
+void hal_timer_start(hal_timer_e timer, uint32_t period)
+{
+    timer_periph[timer]->CNT = 0;
+    timer_periph[timer]->ARR = period;
+    TIM_Cmd(timer_periph[timer], ENABLE);
+}
+
+void hal_timer_stop(hal_timer_e timer)
+{
+    TIM_Cmd(timer_periph[timer], DISABLE);
+}
+
+uint8_t hal_timer_update_flag(hal_timer_e timer)
+{
+    if (TIM_GetITStatus(timer_periph[timer], TIM_IT_Update) == RESET)
+    {
+        return 0;
+    }
+    TIM_ClearFlag(timer_periph[timer], TIM_IT_Update);
+    return 1;
+}
+
+void hal_timer_set_compare(hal_timer_e timer, uint32_t compare)
+{
+    TIM_SetCompare1(timer_periph[timer], compare);
+}
+
+uint8_t hal_timer_compare_flag(hal_timer_e timer)
+{
+    if (TIM_GetITStatus(timer_periph[timer], TIM_IT_CC1) == RESET)
+    {
+        return 0;
+    }
+    TIM_ClearITPendingBit(timer_periph[timer], TIM_IT_CC1);
+    return 1;
+}
+
+
+/******************** Cycle counter ********************/
+
+void hal_cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t hal_cycle_count(void)
+{
+    return DWT->CYCCNT;
+}
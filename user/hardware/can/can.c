@@ -49,13 +49,21 @@ uint8_t CAN1_mode_init(uint8_t tsjw, uint8_t tbs2, uint8_t tbs1, uint16_t brp, u
     CAN_FilterInitStructure.CAN_FilterActivation = ENABLE;
     CAN_FilterInit(&CAN_FilterInitStructure);
 
-    CAN_ITConfig(CAN1, CAN_IT_FMP0, ENABLE);
+    //FIFO0 carries motor feedback, FIFO1 everything else. Overruns raise the same interrupts so they get counted
+    CAN_ITConfig(CAN1, CAN_IT_FMP0 | CAN_IT_FOV0 | CAN_IT_FMP1 | CAN_IT_FOV1, ENABLE);
 
     NVIC_InitStructure.NVIC_IRQChannel = CAN1_RX0_IRQn;
     NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = CAN1_NVIC;
     NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = CAN1_RX1_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    //TX mailbox empty interrupt, CAN_IT_TME is enabled by CAN_send only while frames are queued
+    NVIC_InitStructure.NVIC_IRQChannel = CAN1_TX_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
     return 0;
 }
 uint8_t CAN2_mode_init(uint8_t tsjw, uint8_t tbs2, uint8_t tbs1, uint16_t brp, uint8_t mode)
@@ -106,7 +114,8 @@ uint8_t CAN2_mode_init(uint8_t tsjw, uint8_t tbs2, uint8_t tbs1, uint16_t brp, u
     CAN_FilterInitStructure.CAN_FilterActivation = ENABLE;
     CAN_FilterInit(&CAN_FilterInitStructure);
 
-    CAN_ITConfig(CAN2, CAN_IT_FMP0, ENABLE);
+    //FIFO0 carries motor feedback, FIFO1 everything else. Overruns raise the same interrupts so they get counted
+    CAN_ITConfig(CAN2, CAN_IT_FMP0 | CAN_IT_FOV0 | CAN_IT_FMP1 | CAN_IT_FOV1, ENABLE);
 
     NVIC_InitStructure.NVIC_IRQChannel = CAN2_RX0_IRQn;
     NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = CAN2_NVIC;
@@ -114,5 +123,12 @@ uint8_t CAN2_mode_init(uint8_t tsjw, uint8_t tbs2, uint8_t tbs1, uint16_t brp, u
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
 
+    NVIC_InitStructure.NVIC_IRQChannel = CAN2_RX1_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    //TX mailbox empty interrupt, CAN_IT_TME is enabled by CAN_send only while frames are queued
+    NVIC_InitStructure.NVIC_IRQChannel = CAN2_TX_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
     return 0;
 }
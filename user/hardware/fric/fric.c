@@ -1,6 +1,7 @@
 #include "fric.h"
 
 #include "stm32f4xx.h"
+#include "hal.h"
 
 void fric_PWM_configuration(void) //
 {
@@ -73,14 +74,14 @@ void fric_PWM_configuration(void) //
 
 void fric_off(void)
 {
-    TIM_SetCompare1(TIM1, Fric_OFF);
-    TIM_SetCompare4(TIM1, Fric_OFF);
+    hal_pwm_set(HAL_PWM_FRIC1, Fric_OFF);
+    hal_pwm_set(HAL_PWM_FRIC2, Fric_OFF);
 }
 void fric1_on(uint16_t cmd)
 {
-    TIM_SetCompare1(TIM1, cmd);
+    hal_pwm_set(HAL_PWM_FRIC1, cmd);
 }
 void fric2_on(uint16_t cmd)
 {
-    TIM_SetCompare4(TIM1, cmd);
+    hal_pwm_set(HAL_PWM_FRIC2, cmd);
 }
@@ -58,11 +58,12 @@ void TIM1_Init(uint16_t arr, uint16_t psc)
     TIM_Cmd(TIM1, ENABLE);
 }
 
+//IMU heater PWM on PB5. No update interrupt: it used to count run time stats ticks,
+//which now come from TIM2
 void TIM3_Init(uint16_t arr, uint16_t psc)
 {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
     GPIO_InitTypeDef GPIO_InitStructure;
-    NVIC_InitTypeDef NVIC_InitStructure;
     TIM_OCInitTypeDef TIM_OCInitStructure;
 
     RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
@@ -73,19 +74,11 @@ void TIM3_Init(uint16_t arr, uint16_t psc)
     RCC_APB1PeriphResetCmd(RCC_APB1Periph_TIM3, ENABLE);
     RCC_APB1PeriphResetCmd(RCC_APB1Periph_TIM3, DISABLE);
 
-    NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = TIM3_NVIC;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x00;
-    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-    NVIC_Init(&NVIC_InitStructure);
-
     TIM_TimeBaseInitStructure.TIM_Period = arr - 1;
     TIM_TimeBaseInitStructure.TIM_Prescaler = psc - 1;
     TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
     TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
 
-    TIM_ITConfig(TIM3, TIM_IT_Update, ENABLE);
-
     TIM_TimeBaseInit(TIM3, &TIM_TimeBaseInitStructure);
 
     /* TIM3 */
@@ -108,6 +101,26 @@ void TIM3_Init(uint16_t arr, uint16_t psc)
     TIM_Cmd(TIM3, ENABLE);
 }
 
+//Free running 32 bit counter, no interrupt. Clocked at 90 MHz / psc
+void TIM2_Init(uint16_t psc)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+    RCC_APB1PeriphResetCmd(RCC_APB1Periph_TIM2, ENABLE);
+    RCC_APB1PeriphResetCmd(RCC_APB1Periph_TIM2, DISABLE);
+
+    TIM_TimeBaseInitStructure.TIM_Period = 0xFFFFFFFF;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = psc - 1;
+    TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+
+    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseInitStructure);
+
+    TIM_Cmd(TIM2, ENABLE);
+}
+
 void TIM6_Init(uint16_t arr, uint16_t psc)
 {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
@@ -136,6 +149,44 @@ void TIM6_Init(uint16_t arr, uint16_t psc)
     TIM_Cmd(TIM6, ENABLE); //ʹ�ܶ�ʱ��6
 }
 
+//Control tick: update interrupt every period, CC1 interrupt at the command transmit phase.
+//Left stopped, control_tick_init sets the phase and starts it
+void TIM4_Init(uint16_t arr, uint16_t psc)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM4, ENABLE);
+
+    RCC_APB1PeriphResetCmd(RCC_APB1Periph_TIM4, ENABLE);
+    RCC_APB1PeriphResetCmd(RCC_APB1Periph_TIM4, DISABLE);
+
+    TIM_TimeBaseInitStructure.TIM_Period = arr - 1;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = psc - 1;
+    TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+
+    TIM_TimeBaseInit(TIM4, &TIM_TimeBaseInitStructure);
+
+    //Output compare without a pin, only the CC1 flag is used
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;
+    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OCInitStructure.TIM_Pulse = 0;
+    TIM_OC1Init(TIM4, &TIM_OCInitStructure);
+    TIM_OC1PreloadConfig(TIM4, TIM_OCPreload_Disable);
+
+    TIM_ClearITPendingBit(TIM4, TIM_IT_Update | TIM_IT_CC1);
+    TIM_ITConfig(TIM4, TIM_IT_Update | TIM_IT_CC1, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = TIM4_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = TIM4_NVIC;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x00;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
 void TIM12_Init(uint16_t arr, uint16_t psc)
 {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
@@ -3,7 +3,9 @@
 #include "main.h"
 
 extern void TIM1_Init(uint16_t arr, uint16_t psc);
+extern void TIM2_Init(uint16_t psc);
 extern void TIM3_Init(uint16_t arr, uint16_t psc);
+extern void TIM4_Init(uint16_t arr, uint16_t psc);
 extern void TIM6_Init(uint16_t arr, uint16_t psc);
 extern void TIM12_Init(uint16_t arr, uint16_t psc);
 #endif
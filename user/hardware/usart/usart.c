@@ -32,7 +32,7 @@ void USART_6_INIT(void)
 	USART_DeInit(USART6);
 
 	// Configure UART - this all needs to match the config on the Pi
-	USART_InitStructure.USART_BaudRate = 115200;
+	USART_InitStructure.USART_BaudRate = USART6_BAUDRATE;
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;			// These are the default settings
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;					// All set by USART_StructInit()
 	USART_InitStructure.USART_Parity = USART_Parity_No;					// These details are here for clarity
@@ -43,17 +43,82 @@ void USART_6_INIT(void)
 	// USART_StructInit(&USART_InitStructure); 	// all the settings above are the default settings, this sets them all
 	USART_Init(USART6, &USART_InitStructure);
 
-	// enable interrupts
-	USART_ITConfig(USART6, USART_IT_RXNE, ENABLE);
-
-	// enable USART6 peripheral
+	// enable USART6 peripheral, received bytes go to the DMA set up by USART_6_RX_DMA_INIT
 	USART_Cmd(USART6, ENABLE);
 
-	// configure NVIC for interrupts - only on Rx
-	NVIC_InitStructure.NVIC_IRQChannel = USART6_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;		// set priority group to highest priority achieveable by sw (hw can go negative)
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;					// set priority highest in subgroup
+	// TX DMA: DMA2 stream6 ch5, one normal mode transfer per chunk of the log ring.
+	// Buffer address and length are set per transfer by hal_uart_dma_tx
+	DMA_InitTypeDef DMA_InitStructure;
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+	DMA_DeInit(DMA2_Stream6);
+	while (DMA_GetCmdStatus(DMA2_Stream6) != DISABLE);
+
+	DMA_InitStructure.DMA_Channel = DMA_Channel_5;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) & (USART6->DR);
+	DMA_InitStructure.DMA_Memory0BaseAddr = 0;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+	DMA_InitStructure.DMA_BufferSize = 0;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_Init(DMA2_Stream6, &DMA_InitStructure);
+	// TE too: a transfer error disables the stream without a TC, the log would stall waiting for it
+	DMA_ITConfig(DMA2_Stream6, DMA_IT_TC | DMA_IT_TE, ENABLE);
+	USART_DMACmd(USART6, USART_DMAReq_Tx, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DMA2_Stream6_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = USART6_TX_DMA_NVIC;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
 
 }
+
+void USART_6_RX_DMA_INIT(uint8_t *rx1_buf, uint8_t *rx2_buf, uint16_t dma_buf_num)
+{
+	NVIC_InitTypeDef NVIC_InitStructure;
+	DMA_InitTypeDef DMA_InitStructure;
+
+	// RX DMA: DMA2 stream1 ch5 (stream2 is taken by the USART1 receiver), circular into
+	// two buffers; the IDLE interrupt swaps them, see hal_uart_dma_rx_idle
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+	DMA_DeInit(DMA2_Stream1);
+
+	DMA_InitStructure.DMA_Channel = DMA_Channel_5;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) & (USART6->DR);
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)rx1_buf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+	DMA_InitStructure.DMA_BufferSize = dma_buf_num;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_Init(DMA2_Stream1, &DMA_InitStructure);
+	DMA_DoubleBufferModeConfig(DMA2_Stream1, (uint32_t)rx2_buf, DMA_Memory_0);
+	DMA_DoubleBufferModeCmd(DMA2_Stream1, ENABLE);
+	DMA_Cmd(DMA2_Stream1, DISABLE);
+	DMA_Cmd(DMA2_Stream1, ENABLE);
+
+	USART_DMACmd(USART6, USART_DMAReq_Rx, ENABLE);
+	USART_ClearFlag(USART6, USART_FLAG_IDLE);
+	USART_ITConfig(USART6, USART_IT_IDLE, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = USART6_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = USART6_RX_NVIC;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+}
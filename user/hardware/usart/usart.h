@@ -1,6 +1,12 @@
 #ifndef USART_H
 #define USART_H
+#include "main.h"
+
+//Shared with the Pi and the telemetry decoder, see APP/telemetry for the bandwidth budget
+#define USART6_BAUDRATE 115200
 
 extern void USART_6_INIT(void);
+//RX DMA into a double buffer with an IDLE line interrupt, call after USART_6_INIT
+extern void USART_6_RX_DMA_INIT(uint8_t *rx1_buf, uint8_t *rx2_buf, uint16_t dma_buf_num);
 
 #endif
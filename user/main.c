@@ -42,6 +42,12 @@
 
 #include "start_task.h"
 #include "remote_control.h"
+#include "vision.h"
+#include "hal.h"
+#include "CAN_receive.h"
+#include "control_tick.h"
+#include "trace.h"
+#include "trig_lut.h"
 
 void BSP_init(void);
 
@@ -66,6 +72,11 @@ void BSP_init(void)
     NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
     //Clock init
     delay_init(configTICK_RATE_HZ);
+    //Cycle counter, used to timestamp CAN feedback and trace records
+    hal_cycle_counter_init();
+    trace_init();
+    //Sin/cos table, before any task looks it up
+    trig_lut_init();
     //LEDs
     led_configuration();
     //stm32 onboard temperature sensor
@@ -84,11 +95,21 @@ void BSP_init(void)
     laser_configuration();
     //timer 6 init
     TIM6_Init(60000, 90);
+    //control tick timer, 1 MHz count
+    TIM4_Init(CONTROL_TICK_PERIOD_US, 90);
+    //CAN receive tables, before the mode inits enable the receive interrupts
+    CAN_receive_init();
     //CAN peripherals init
     CAN1_mode_init(CAN_SJW_1tq, CAN_BS2_2tq, CAN_BS1_6tq, 5, CAN_Mode_Normal);
     CAN2_mode_init(CAN_SJW_1tq, CAN_BS2_2tq, CAN_BS1_6tq, 5, CAN_Mode_Normal);
+    //filter banks built from the tables, after CAN1 reset clears the banks
+    CAN_update_filters();
+    //control tick, starts latching feedback and sending staged commands
+    control_tick_init();
 		
     USART_6_INIT();
+    //vision PC target frames on USART6 RX
+    vision_init();
     remote_control_init();
 
     //24v power output on
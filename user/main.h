@@ -17,6 +17,10 @@
 #ifndef MAIN_H
 #define MAIN_H
 
+#if defined(HOST_BUILD)
+//Host (Linux) build: take the fixed width types from the C library, long is 64-bit there
+#include <stdint.h>
+#else
 typedef signed char int8_t;
 typedef signed short int int16_t;
 typedef signed int int32_t;
@@ -27,6 +31,7 @@ typedef unsigned char uint8_t;
 typedef unsigned short int uint16_t;
 typedef unsigned int uint32_t;
 typedef unsigned long long uint64_t;
+#endif
 typedef unsigned char bool_t;
 typedef float fp32;
 typedef double fp64;
@@ -40,9 +45,12 @@ typedef double fp64;
 
 #define CAN1_NVIC 4
 #define CAN2_NVIC 4
-#define TIM3_NVIC 5
 #define TIM6_NVIC 4
+//Releases the control tasks, so it must not be above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+#define TIM4_NVIC 5
 #define SPI5_RX_NVIC 5
+#define USART6_TX_DMA_NVIC 6
+#define USART6_RX_NVIC 5
 #define MPU_INT_NVIC 5
 
 #define Latitude_At_ShenZhen 22.57025f
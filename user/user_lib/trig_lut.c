@@ -0,0 +1,134 @@
+/**
+  ******************************************************************************
+    * @file    user_lib/trig_lut
+    * @date    16-October-2026
+    * @brief   Sine and cosine lookup by encoder count, see trig_lut.h.
+  ******************************************************************************
+**/
+
+
+/******************** User Includes ********************/
+#include "trig_lut.h"
+#include <string.h>
+
+
+/******************** Private User Declarations ********************/
+
+//Table positions per radian
+#define TRIG_LUT_PER_RAD (TRIG_LUT_ECD_RANGE / 6.28318530717959f)
+
+#if TRIG_LUT_IN_CCM
+static int16_t trig_lut_ccm_sin[TRIG_LUT_QUARTER + 1] TRIG_LUT_CCM_ATTR;
+#define TRIG_LUT_TABLE trig_lut_ccm_sin
+#else
+#define TRIG_LUT_TABLE trig_lut_quarter_sin
+#endif
+
+//Table position of an angle, split into the entry below it and the fraction past it
+static uint16_t trig_lut_position(fp32 rad, fp32 *frac);
+
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Copies the table into CCM RAM when TRIG_LUT_IN_CCM is set, call before the scheduler starts
+void trig_lut_init(void)
+{
+#if TRIG_LUT_IN_CCM
+    memcpy(trig_lut_ccm_sin, trig_lut_quarter_sin, sizeof(trig_lut_ccm_sin));
+#endif
+}
+
+
+/**
+* @brief  Sine of an encoder angle from the quarter wave table, mirrored and
+*         negated for the other three quarters
+* @param  ecd: encoder count, only the low TRIG_LUT_ECD_BITS are used
+* @retval sine in Q15, -TRIG_LUT_ONE ~ TRIG_LUT_ONE
+*/
+int16_t trig_lut_sin_ecd(uint16_t ecd)
+{
+    uint16_t index = ecd & (TRIG_LUT_ECD_RANGE - 1);
+    uint16_t offset = index & (TRIG_LUT_QUARTER - 1);
+
+    switch (index / TRIG_LUT_QUARTER)
+    {
+    case 0:
+        return TRIG_LUT_TABLE[offset];
+    case 1:
+        return TRIG_LUT_TABLE[TRIG_LUT_QUARTER - offset];
+    case 2:
+        return -TRIG_LUT_TABLE[offset];
+    default:
+        return -TRIG_LUT_TABLE[TRIG_LUT_QUARTER - offset];
+    }
+}
+
+
+/**
+* @brief  Cosine of an encoder angle, the sine a quarter turn ahead
+* @param  ecd: encoder count, only the low TRIG_LUT_ECD_BITS are used
+* @retval cosine in Q15, -TRIG_LUT_ONE ~ TRIG_LUT_ONE
+*/
+int16_t trig_lut_cos_ecd(uint16_t ecd)
+{
+    return trig_lut_sin_ecd(ecd + TRIG_LUT_QUARTER);
+}
+
+
+//Interpolated sine of an angle in radians
+fp32 trig_lut_sin(fp32 rad)
+{
+    fp32 frac;
+    uint16_t ecd = trig_lut_position(rad, &frac);
+    fp32 low = trig_lut_sin_ecd(ecd);
+
+    return (low + frac * (trig_lut_sin_ecd(ecd + 1) - low)) * TRIG_LUT_Q15_TO_F32;
+}
+
+
+//Interpolated cosine of an angle in radians
+fp32 trig_lut_cos(fp32 rad)
+{
+    fp32 frac;
+    uint16_t ecd = trig_lut_position(rad, &frac);
+    fp32 low = trig_lut_cos_ecd(ecd);
+
+    return (low + frac * (trig_lut_cos_ecd(ecd + 1) - low)) * TRIG_LUT_Q15_TO_F32;
+}
+
+
+/**
+* @brief  Interpolated sine and cosine of one angle, sharing the table position
+* @param  rad: angle in radians, |rad| < 1e6
+* @param  sin_out, cos_out: filled with the results
+* @retval None
+*/
+void trig_lut_sin_cos(fp32 rad, fp32 *sin_out, fp32 *cos_out)
+{
+    fp32 frac;
+    uint16_t ecd = trig_lut_position(rad, &frac);
+    fp32 sin_low = trig_lut_sin_ecd(ecd);
+    fp32 cos_low = trig_lut_cos_ecd(ecd);
+
+    *sin_out = (sin_low + frac * (trig_lut_sin_ecd(ecd + 1) - sin_low)) * TRIG_LUT_Q15_TO_F32;
+    *cos_out = (cos_low + frac * (trig_lut_cos_ecd(ecd + 1) - cos_low)) * TRIG_LUT_Q15_TO_F32;
+}
+
+
+
+/******************** Private Functions ********************/
+
+static uint16_t trig_lut_position(fp32 rad, fp32 *frac)
+{
+    fp32 position = rad * TRIG_LUT_PER_RAD;
+    int32_t whole = (int32_t)position;
+
+    //Truncation rounds negative positions up, step back to the entry below
+    if (position < whole)
+    {
+        whole--;
+    }
+    *frac = position - whole;
+    return (uint16_t)(whole & (TRIG_LUT_ECD_RANGE - 1));
+}
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+    * @file    user_lib/trig_lut
+    * @date    16-October-2026
+    * @brief   Sine and cosine lookup indexed directly by motor encoder count.
+    *          The GM6020/M3508 encoders have TRIG_LUT_ECD_RANGE states per turn,
+    *          so a quarter wave of TRIG_LUT_QUARTER + 1 Q15 entries covers every
+    *          reading exactly, with no interpolation and no FPU.
+    *          trig_lut_sin/cos/sin_cos take fp32 radians and interpolate
+    *          linearly between two entries of the same table; the error is the
+    *          Q15 rounding, 1.5e-5, the interpolation adds under 1e-7.
+    * @attention The table is generated by host/tools/trig_lut_gen into
+    *          trig_lut_table.c, regenerate it rather than editing it. It is read
+    *          from flash unless TRIG_LUT_IN_CCM copies it into CCM RAM, which
+    *          has no wait states and no DMA traffic; trig_lut_init must then run
+    *          before the first lookup.
+  ******************************************************************************
+**/
+
+#ifndef TRIG_LUT_H
+#define TRIG_LUT_H
+#include "main.h"
+
+
+/******************** Public Definitions & Structs ********************/
+
+//Encoder states per turn, a power of two
+#define TRIG_LUT_ECD_BITS 13
+#define TRIG_LUT_ECD_RANGE (1 << TRIG_LUT_ECD_BITS)
+#define TRIG_LUT_QUARTER (TRIG_LUT_ECD_RANGE / 4)
+//Q15 full scale, sin of a quarter turn
+#define TRIG_LUT_ONE 32767
+//Q15 to fp32
+#define TRIG_LUT_Q15_TO_F32 (1.0f / TRIG_LUT_ONE)
+
+//1 looks up a copy in CCM RAM (IRAM2, 0x10000000) instead of flash
+#ifndef TRIG_LUT_IN_CCM
+#define TRIG_LUT_IN_CCM 0
+#endif
+#if TRIG_LUT_IN_CCM && !defined(HOST_BUILD)
+#define TRIG_LUT_CCM_ATTR __attribute__((at(0x10000000)))
+#else
+#define TRIG_LUT_CCM_ATTR
+#endif
+
+//sin(2 pi i / TRIG_LUT_ECD_RANGE) in Q15 for i = 0 ~ TRIG_LUT_QUARTER
+extern const int16_t trig_lut_quarter_sin[TRIG_LUT_QUARTER + 1];
+
+
+/******************** Main Functions Called From Outside ********************/
+
+//Copies the table into CCM RAM when TRIG_LUT_IN_CCM is set, otherwise does nothing
+extern void trig_lut_init(void);
+//Q15 sine of an encoder angle, any ecd is taken modulo one turn
+extern int16_t trig_lut_sin_ecd(uint16_t ecd);
+//Q15 cosine of an encoder angle
+extern int16_t trig_lut_cos_ecd(uint16_t ecd);
+//Interpolated sine and cosine of an angle in radians, |rad| < 1e6; like any fp32
+//angle the resolution drops as |rad| grows
+extern fp32 trig_lut_sin(fp32 rad);
+extern fp32 trig_lut_cos(fp32 rad);
+extern void trig_lut_sin_cos(fp32 rad, fp32 *sin_out, fp32 *cos_out);
+
+#endif
@@ -2,7 +2,7 @@
 #include "arm_math.h"
 #include "math.h"
 #include "main.h"
-#include "stm32f4xx.h"
+#include <string.h>
 
 
 
@@ -26,9 +26,11 @@ fp32 invSqrt(fp32 num)
 {
     fp32 halfnum = 0.5f * num;
     fp32 y = num;
-    long i = *(long *)&y;
+    int32_t i;
+    //memcpy instead of a pointer cast, which breaks strict aliasing; the compiler turns it into a move
+    memcpy(&i, &y, sizeof(i));
     i = 0x5f3759df - (i >> 1);
-    y = *(fp32 *)&i;
+    memcpy(&y, &i, sizeof(y));
     y = y * (1.5f - (halfnum * y * y));
     return y;
 }